@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include <lightgraph/lightgraph.hpp>
 
@@ -64,6 +66,107 @@ double runScenario(const BenchmarkScenario& scenario) {
     return fps;
 }
 
+// Emit cost per command for bursts sent as single emit() calls and as one
+// emitBatch(). Note ids cycle, so bursts replace lists once the table fills.
+void runBurstBenchmark() {
+    constexpr int kBurstFrames = 1500;
+    lightgraph::EngineConfig config;
+    config.object_type = lightgraph::ObjectType::Triangle;
+    config.pixel_count = 512;
+
+    for (const size_t burst_size : {size_t{1}, size_t{10}, size_t{30}}) {
+        std::vector<lightgraph::EmitCommand> burst(burst_size);
+        std::vector<lightgraph::Result<int8_t>> results;
+        double per_command_ns[2] = {0.0, 0.0};
+        for (int batched = 0; batched < 2; ++batched) {
+            lightgraph::Engine engine(config);
+            int64_t emit_ns = 0;
+            for (int frame = 0; frame < kBurstFrames; ++frame) {
+                for (size_t i = 0; i < burst_size; ++i) {
+                    lightgraph::EmitCommand& command = burst[i];
+                    command.model = 0;
+                    command.speed = 1.0f + static_cast<float>((frame + i) % 8);
+                    command.length = static_cast<uint16_t>(4 + (frame + i) % 12);
+                    command.note_id = static_cast<uint16_t>(1 + (frame * burst_size + i) % 16);
+                    command.color = static_cast<uint32_t>(0x102030 + (frame + i) % 0x00FFFF);
+                }
+                const auto start = clock_type::now();
+                if (batched != 0) {
+                    static_cast<void>(engine.emitBatch(burst.data(), burst.size(), results));
+                } else {
+                    for (const lightgraph::EmitCommand& command : burst) {
+                        static_cast<void>(engine.emit(command));
+                    }
+                }
+                emit_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count();
+                engine.tick(16);
+            }
+            per_command_ns[batched] =
+                static_cast<double>(emit_ns) / static_cast<double>(kBurstFrames * static_cast<int64_t>(burst_size));
+        }
+        std::cout << "Benchmark burst " << burst_size << " single emit (ns/command): " << per_command_ns[0] << "\n";
+        std::cout << "Benchmark burst " << burst_size << " emitBatch (ns/command): " << per_command_ns[1] << "\n";
+    }
+}
+
+// Runs `frames` ticks on its own engine and returns the measured frames/sec.
+double runEngineLoop(const lightgraph::EngineConfig& config, int frames) {
+    lightgraph::Engine engine(config);
+    const auto start = clock_type::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        if (frame % 4 == 0) {
+            lightgraph::EmitCommand command;
+            command.model = 0;
+            command.speed = 1.0f + static_cast<float>(frame % 8);
+            command.length = static_cast<uint16_t>(4 + (frame % 12));
+            command.note_id = static_cast<uint16_t>(frame % 64);
+            static_cast<void>(engine.emit(command));
+        }
+        engine.tick(16);
+    }
+    const auto end = clock_type::now();
+    const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    return elapsed_ns > 0 ? static_cast<double>(frames) * 1e9 / static_cast<double>(elapsed_ns) : 0.0;
+}
+
+// One engine per thread. Engines share no mutable state, so per-engine
+// frames/sec should hold steady as threads are added (up to the core count).
+void runEngineScaling() {
+    constexpr int kScalingFrames = 2000;
+    lightgraph::EngineConfig config;
+    config.object_type = lightgraph::ObjectType::Triangle;
+    config.pixel_count = 512;
+
+    std::vector<unsigned> thread_counts = {1, 2, 4};
+    const unsigned hardware = std::thread::hardware_concurrency();
+    if (hardware > 4) {
+        thread_counts.push_back(hardware);
+    }
+
+    double single_fps = 0.0;
+    for (const unsigned threads : thread_counts) {
+        std::vector<double> fps(threads, 0.0);
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back([&config, &fps, i]() { fps[i] = runEngineLoop(config, kScalingFrames); });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        const double per_engine = *std::min_element(fps.begin(), fps.end());
+        if (threads == 1) {
+            single_fps = per_engine;
+        }
+        std::cout << "Benchmark engines " << threads << " threads (frames/sec per engine): " << per_engine
+                  << "\n";
+        std::cout << "Benchmark engines " << threads << " threads scaling: "
+                  << (single_fps > 0.0 ? per_engine * threads / single_fps : 0.0) << "\n";
+    }
+    if (hardware > 0) {
+        std::cout << "Benchmark engines hardware threads: " << hardware << "\n";
+    }
+}
+
 } // namespace
 
 int main() {
@@ -85,6 +188,9 @@ int main() {
         min_fps = 0.0;
     }
 
+    runBurstBenchmark();
+    runEngineScaling();
+
     std::cout << "Benchmark minimum frames/sec: " << min_fps << "\n";
     return 0;
 }
@@ -0,0 +1,601 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "lightgraph/internal/Globals.h"
+#include "lightgraph/internal/objects.hpp"
+#include "lightgraph/internal/rendering.hpp"
+#include "lightgraph/internal/runtime.hpp"
+#include "lightgraph/internal/topology.hpp"
+
+namespace {
+
+using clock_type = std::chrono::high_resolution_clock;
+
+constexpr int kResolveFrames = 4000;
+constexpr int kUpdateFrames = 2000;
+constexpr int kBlendFrames = 400;
+constexpr int kCrowdFrames = 300;
+constexpr int kRouteFrames = 2000;
+constexpr int kRoutePicks = 1024;
+constexpr int kRandomFrames = 2000;
+constexpr int kRandomDraws = 1024;
+constexpr int kEmitterFrames = 2000;
+constexpr int kEmitterPicks = 1024;
+constexpr int kCrowdLists = 5;
+constexpr uint16_t kCrowdListLength = 300;
+constexpr uint16_t kChurnListLength = 120;
+constexpr uint16_t kBlendPixels = 3024;
+
+template <typename Fn>
+double nanosPerFrame(int frames, Fn&& fn) {
+    const auto start = clock_type::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        fn(frame);
+    }
+    const auto end = clock_type::now();
+    const auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    return static_cast<double>(elapsed_ns) / static_cast<double>(frames);
+}
+
+// Square grid of 4-port intersections joined by 3-LED connections. Connections
+// may share pixels; only the routing structure matters here.
+class GridObject : public TopologyObject {
+  public:
+    explicit GridObject(uint16_t side) : TopologyObject(static_cast<uint16_t>(side * side * 4u)) {
+        addModel(new Model(0, 10, GROUP1));
+        std::vector<Intersection*> nodes;
+        nodes.reserve(static_cast<size_t>(side) * side);
+        for (uint32_t i = 0; i < static_cast<uint32_t>(side) * side; i++) {
+            nodes.push_back(addIntersection(new Intersection(4, static_cast<uint16_t>(i * 4u), -1, GROUP1)));
+        }
+        for (uint32_t row = 0; row < side; row++) {
+            for (uint32_t col = 0; col < side; col++) {
+                const uint32_t i = row * side + col;
+                if (col + 1 < side) {
+                    addConnection(new Connection(nodes[i], nodes[i + 1], GROUP1, 3));
+                }
+                if (row + 1 < side) {
+                    addConnection(new Connection(nodes[i], nodes[i + side], GROUP1, 3));
+                }
+            }
+        }
+    }
+
+    uint16_t* getMirroredPixels(uint16_t, Owner*, bool) override {
+        mirrored_[0] = 0;
+        return mirrored_;
+    }
+
+    EmitParams getModelParams(int model) const override { return EmitParams(model % 1, 1.0f); }
+
+  private:
+    uint16_t mirrored_[2] = {0};
+};
+
+void fillAccumulators(State& state) {
+    uint32_t seed = 0x13579BDFu;
+    for (size_t i = 0; i < state.pixelDiv.size(); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        // Mostly dark pixels with one to three overlapping lights, as in a busy frame.
+        const uint8_t div = static_cast<uint8_t>((seed >> 24) % 4);
+        state.pixelDiv[i] = div;
+        state.pixelValuesR[i] = static_cast<uint16_t>(div * ((seed >> 4) & 0xFF));
+        state.pixelValuesG[i] = static_cast<uint16_t>(div * ((seed >> 10) & 0xFF));
+        state.pixelValuesB[i] = static_cast<uint16_t>(div * ((seed >> 16) & 0xFF));
+    }
+}
+
+void runResolveBenchmark() {
+    Heptagon3024 object;
+    State state(object);
+    fillAccumulators(state);
+
+    const uint16_t pixel_count = object.pixelCount;
+    std::vector<uint8_t> frame(static_cast<size_t>(pixel_count) * 3u, 0);
+    uint32_t checksum = 0;
+
+    const double get_pixel_ns = nanosPerFrame(kResolveFrames, [&](int frame_idx) {
+        const uint8_t max_brightness = static_cast<uint8_t>(255 - (frame_idx & 1));
+        for (uint16_t i = 0; i < pixel_count; i++) {
+            const ColorRGB color = state.getPixel(i, max_brightness);
+            frame[static_cast<size_t>(i) * 3u] = color.R;
+            frame[static_cast<size_t>(i) * 3u + 1u] = color.G;
+            frame[static_cast<size_t>(i) * 3u + 2u] = color.B;
+        }
+        checksum += frame[static_cast<size_t>(frame_idx % pixel_count) * 3u];
+    });
+
+    std::cout << "Benchmark resolve object: heptagon3024 (" << pixel_count << " pixels)\n";
+    std::cout << "Benchmark resolve getPixel loop (ns/frame): " << get_pixel_ns << "\n";
+
+    pixel_resolve::Planes planes;
+    planes.r = state.pixelValuesR.data();
+    planes.g = state.pixelValuesG.data();
+    planes.b = state.pixelValuesB.data();
+    planes.div = state.pixelDiv.data();
+
+    const std::array<pixel_resolve::Kernel, 4> kernels = {
+        pixel_resolve::Kernel::Scalar,
+        pixel_resolve::Kernel::Sse2,
+        pixel_resolve::Kernel::Avx2,
+        pixel_resolve::Kernel::Neon,
+    };
+    for (const pixel_resolve::Kernel kernel : kernels) {
+        if (!pixel_resolve::isKernelAvailable(kernel)) {
+            continue;
+        }
+        const double kernel_ns = nanosPerFrame(kResolveFrames, [&](int frame_idx) {
+            const uint8_t max_brightness = static_cast<uint8_t>(255 - (frame_idx & 1));
+            pixel_resolve::resolveWith(kernel, planes, pixel_count, max_brightness, frame.data());
+            checksum += frame[static_cast<size_t>(frame_idx % pixel_count) * 3u];
+        });
+        std::cout << "Benchmark resolve " << pixel_resolve::kernelName(kernel)
+                  << " kernel (ns/frame): " << kernel_ns << "\n";
+        std::cout << "Benchmark resolve " << pixel_resolve::kernelName(kernel)
+                  << " speedup vs getPixel: " << (kernel_ns > 0.0 ? get_pixel_ns / kernel_ns : 0.0)
+                  << "\n";
+    }
+
+    std::cout << "Benchmark resolve active kernel: "
+              << pixel_resolve::kernelName(pixel_resolve::activeKernel()) << "\n";
+    std::cout << "Benchmark resolve checksum: " << checksum << "\n";
+}
+
+void runUpdateBenchmark(bool background_visible) {
+    Heptagon3024 object;
+    State state(object);
+    state.lightLists[0]->visible = background_visible;
+    gMillis = 0;
+    lightgraphResetFrameTiming();
+
+    EmitParams params(0, 2.0f, 0x30A0FF);
+    params.setLength(12);
+    params.noteId = 1;
+    state.emit(params);
+
+    size_t touched = 0;
+    const double update_ns = nanosPerFrame(kUpdateFrames, [&](int /*frame_idx*/) {
+        gMillis += 16;
+        state.update();
+        touched += state.touchedPixels.size();
+    });
+
+    const char* const label = background_visible ? "background" : "sparse";
+    std::cout << "Benchmark update " << label << " touched pixels/frame: "
+              << static_cast<double>(touched) / kUpdateFrames << "\n";
+    std::cout << "Benchmark update " << label << " (ns/frame): " << update_ns << "\n";
+}
+
+// Background fill over every pixel: the per-pixel wrapColors + dim the
+// background used to run, against the baked color table behind getColor.
+void runBgFillBenchmark() {
+    Heptagon3024 object;
+    State state(object);
+    BgLight* const bg = static_cast<BgLight*>(state.lightLists[0]);
+    bg->setup(object.pixelCount, 200);
+    Palette palette({0xFF2000, 0x20FF40, 0x2040FF, 0xFFFFFF}, {0.0f, 0.3f, 0.6f, 1.0f});
+    palette.setWrapMode(WRAP_REPEAT_MIRROR);
+    palette.setSegmentation(3.0f);
+    bg->setPalette(palette);
+
+    const uint16_t pixel_count = object.pixelCount;
+    uint32_t checksum = 0;
+    const double wrap_ns = nanosPerFrame(kUpdateFrames, [&](int frame_idx) {
+        bg->position = static_cast<float>(frame_idx % pixel_count);
+        for (uint16_t p = 0; p < pixel_count; p++) {
+            const uint32_t index = static_cast<uint32_t>(bg->position + p) % bg->length;
+            const ColorRGB color = Palette::wrapColors(index, bg->length, bg->colors, palette.getWrapMode(),
+                                                       palette.getSegmentation())
+                                       .dim(bg->maxBri);
+            checksum += color.R;
+        }
+    });
+    const double table_ns = nanosPerFrame(kUpdateFrames, [&](int frame_idx) {
+        bg->position = static_cast<float>(frame_idx % pixel_count);
+        for (uint16_t p = 0; p < pixel_count; p++) {
+            checksum += bg->getColor(static_cast<int16_t>(p)).R;
+        }
+    });
+
+    std::cout << "Benchmark bg fill object: heptagon3024 (" << pixel_count << " pixels)\n";
+    std::cout << "Benchmark bg fill wrapColors (ns/frame): " << wrap_ns << "\n";
+    std::cout << "Benchmark bg fill color table (ns/frame): " << table_ns << "\n";
+    std::cout << "Benchmark bg fill speedup: " << (table_ns > 0.0 ? wrap_ns / table_ns : 0.0) << "\n";
+    std::cout << "Benchmark bg fill checksum: " << checksum << "\n";
+}
+
+// Note-on cost of the palette step: a list re-interpolating its palette on every
+// setPalette versus one bound to the State's PaletteCache.
+void runPaletteCacheBenchmark() {
+    Line object(LINE_PIXEL_COUNT);
+    State state(object);
+    LightList list;
+    list.setup(48, 255);
+    const Palette palette = getPalette(0);
+
+    const double direct_ns = nanosPerFrame(kUpdateFrames, [&](int) {
+        list.setPalette(palette);
+    });
+    list.bindPaletteCache(&state.paletteCache);
+    const double cached_ns = nanosPerFrame(kUpdateFrames, [&](int) {
+        list.setPalette(palette);
+    });
+
+    std::cout << "Benchmark palette setPalette interpolate (ns/call): " << direct_ns << "\n";
+    std::cout << "Benchmark palette setPalette cached (ns/call): " << cached_ns << "\n";
+    std::cout << "Benchmark palette cache speedup: " << (cached_ns > 0.0 ? direct_ns / cached_ns : 0.0) << "\n";
+    std::cout << "Benchmark palette cache hits/misses: " << state.paletteCache.hits() << "/"
+              << state.paletteCache.misses() << "\n";
+}
+
+// Re-interpolating a long gradient over a heptagon3024-sized background, and the
+// HSV -> RGB step alone: batch kernel versus the scalar ColorRGB::setHsb.
+void runColorSpaceBenchmark() {
+    constexpr uint16_t kEntries = HEPTAGON3024_PIXEL_COUNT;
+    constexpr int kCalls = 50;
+    Palette gradient = getPalette(0);
+    std::vector<ColorRGB> colors;
+
+    gradient.setInterpolationMode(1);
+    const double hsb_ns = nanosPerFrame(kCalls, [&](int) {
+        gradient.interpolateInto(colors, kEntries);
+    });
+    gradient.setInterpolationMode(2);
+    const double lch_ns = nanosPerFrame(kCalls, [&](int) {
+        gradient.interpolateInto(colors, kEntries);
+    });
+
+    std::vector<colorspace::HSV> samples(kEntries);
+    for (uint16_t i = 0; i < kEntries; i++) {
+        samples[i] = {static_cast<float>(i % 360), 0.8f, 0.9f};
+    }
+    colors.resize(kEntries);
+    uint32_t checksum = 0;
+    const double scalar_ns = nanosPerFrame(kCalls, [&](int) {
+        for (uint16_t i = 0; i < kEntries; i++) {
+            colors[i].setHsb(samples[i].h / 360.0f * 255.0f, samples[i].s * 255.0f, samples[i].v * 255.0f);
+        }
+        checksum += colors[kEntries / 2].G;
+    });
+    const double batch_ns = nanosPerFrame(kCalls, [&](int) {
+        colorspace::hsvToRgb(samples.data(), colors.data(), kEntries);
+        checksum += colors[kEntries / 2].G;
+    });
+
+    std::cout << "Benchmark palette interpolate HSB " << kEntries << " entries (ns/call): " << hsb_ns << "\n";
+    std::cout << "Benchmark palette interpolate CIELCh " << kEntries << " entries (ns/call): " << lch_ns << "\n";
+    std::cout << "Benchmark hsv->rgb scalar setHsb (ns/color): " << scalar_ns / kEntries << "\n";
+    std::cout << "Benchmark hsv->rgb batch kernel (ns/color): " << batch_ns / kEntries << "\n";
+    std::cout << "Benchmark hsv->rgb checksum: " << checksum << "\n";
+}
+
+// MAX_TOTAL_LIGHTS-sized scene: light storage layout dominates both update and emit cost.
+// `specialized` selects the per-list update kernels or the generic per-light path.
+void runCrowdBenchmark(bool specialized) {
+    Heptagon3024 object;
+    State state(object);
+    state.lightLists[0]->visible = false;
+    state.specializedLightUpdate = specialized;
+    gMillis = 0;
+    lightgraphResetFrameTiming();
+
+    const auto emit_start = clock_type::now();
+    for (int i = 0; i < kCrowdLists; i++) {
+        EmitParams params(0, 1.0f + 0.25f * static_cast<float>(i), 0x30A0FF);
+        params.setLength(kCrowdListLength);
+        params.duration = INFINITE_DURATION;
+        params.noteId = static_cast<uint16_t>(i + 1);
+        state.emit(params);
+    }
+    const auto emit_end = clock_type::now();
+
+    uint32_t lights = 0;
+    for (uint8_t i = 0; i < MAX_LIGHT_LISTS; i++) {
+        if (state.lightLists[i] != nullptr) {
+            lights += state.lightLists[i]->numLights;
+        }
+    }
+
+    const double update_ns = nanosPerFrame(kCrowdFrames, [&](int /*frame_idx*/) {
+        gMillis += 16;
+        state.update();
+    });
+
+    const char* const label = specialized ? "specialized" : "generic";
+    if (specialized) {
+        std::cout << "Benchmark crowd lights: " << lights << "\n";
+        std::cout << "Benchmark crowd emit (ns/light): "
+                  << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             emit_end - emit_start)
+                                             .count()) /
+                         (lights > 0 ? lights : 1)
+                  << "\n";
+    }
+    std::cout << "Benchmark crowd " << label << " update (ns/frame): " << update_ns << "\n";
+    std::cout << "Benchmark crowd " << label << " update (ns/light): "
+              << (lights > 0 ? update_ns / lights : 0.0) << "\n";
+}
+
+// The crowd scene again, with the list update spread over worker threads.
+void runParallelBenchmark() {
+    std::vector<uint8_t> thread_counts = {1, 2, 4};
+    const unsigned hardware = std::thread::hardware_concurrency();
+    std::cout << "Benchmark parallel update hardware threads: " << hardware << "\n";
+    if (hardware > 4) {
+        thread_counts.push_back(static_cast<uint8_t>(hardware < MAX_LIGHT_LISTS ? hardware : MAX_LIGHT_LISTS));
+    }
+
+    double serial_ns = 0.0;
+    for (const uint8_t threads : thread_counts) {
+        Heptagon3024 object;
+        State state(object);
+        state.lightLists[0]->visible = false;
+        if (!state.setUpdateThreads(threads)) {
+            std::cout << "Benchmark parallel update unavailable in this build\n";
+            return;
+        }
+        gMillis = 0;
+        lightgraphResetFrameTiming();
+
+        for (int i = 0; i < kCrowdLists; i++) {
+            EmitParams params(0, 1.0f + 0.25f * static_cast<float>(i), 0x30A0FF);
+            params.setLength(kCrowdListLength);
+            params.duration = INFINITE_DURATION;
+            params.noteId = static_cast<uint16_t>(i + 1);
+            state.emit(params);
+        }
+
+        const double update_ns = nanosPerFrame(kCrowdFrames, [&](int /*frame_idx*/) {
+            gMillis += 16;
+            state.update();
+        });
+        if (threads == 1) {
+            serial_ns = update_ns;
+        }
+        std::cout << "Benchmark parallel update " << static_cast<unsigned>(threads)
+                  << " threads (ns/frame): " << update_ns << "\n";
+        std::cout << "Benchmark parallel update " << static_cast<unsigned>(threads)
+                  << " threads speedup: " << (update_ns > 0.0 ? serial_ns / update_ns : 0.0) << "\n";
+    }
+}
+
+// Note-on churn: every emit replaces a live list with the same note id.
+void runChurnBenchmark() {
+    Heptagon3024 object;
+    State state(object);
+    state.lightLists[0]->visible = false;
+    gMillis = 0;
+    lightgraphResetFrameTiming();
+
+    const auto emitNote = [&](int frame_idx) {
+        EmitParams params(0, 1.0f, 0x30A0FF);
+        params.setLength(kChurnListLength);
+        params.duration = INFINITE_DURATION;
+        params.noteId = static_cast<uint16_t>(frame_idx % kCrowdLists + 1);
+        state.emit(params);
+    };
+    // Warm the list pool and the arena.
+    for (int i = 0; i < 2 * kCrowdLists; i++) {
+        emitNote(i);
+    }
+
+    const uint32_t allocations_before = state.lightArena.heapAllocations();
+    const double reemit_ns = nanosPerFrame(kCrowdFrames, emitNote);
+    std::cout << "Benchmark churn re-emit (ns/emit, " << kChurnListLength << " lights): " << reemit_ns
+              << "\n";
+    std::cout << "Benchmark churn light storage heap allocations: "
+              << state.lightArena.heapAllocations() - allocations_before << "\n";
+}
+
+// The crowd scene on grids of 100 and 10,000 intersections: per-light update
+// cost, dominated by routing decisions on 3-LED connections, should not grow
+// with the number of intersections.
+void runGridBenchmark() {
+    for (const uint16_t side : {10, 100}) {
+        GridObject object(side);
+        State state(object);
+        state.lightLists[0]->visible = false;
+        gMillis = 0;
+        lightgraphResetFrameTiming();
+
+        for (int i = 0; i < kCrowdLists; i++) {
+            EmitParams params(0, 1.0f + 0.25f * static_cast<float>(i), 0x30A0FF);
+            params.setLength(kCrowdListLength);
+            params.duration = INFINITE_DURATION;
+            params.noteId = static_cast<uint16_t>(i + 1);
+            state.emit(params);
+        }
+        uint32_t lights = 0;
+        for (uint8_t i = 0; i < MAX_LIGHT_LISTS; i++) {
+            if (state.lightLists[i] != nullptr) {
+                lights += state.lightLists[i]->numLights;
+            }
+        }
+        // Let the lists spread out over the grid first.
+        for (int frame = 0; frame < kCrowdFrames; frame++) {
+            gMillis += 16;
+            state.update();
+        }
+
+        const double update_ns = nanosPerFrame(kCrowdFrames, [&](int /*frame_idx*/) {
+            gMillis += 16;
+            state.update();
+        });
+        std::cout << "Benchmark grid " << object.countIntersections(GROUP1)
+                  << " intersections update (ns/light): " << (lights > 0 ? update_ns / lights : 0.0)
+                  << "\n";
+    }
+}
+
+// One weighted pick at a 9-port junction (8 outgoing weights plus the incoming port).
+void runRouteBenchmark() {
+    constexpr uint8_t kPorts = 9;
+    const std::array<uint16_t, kPorts> weights = {{0, 10, 3, 25, 1, 7, 40, 12, 2}};
+    std::array<uint16_t, kPorts> row{};
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < kPorts; i++) {
+        total = static_cast<uint16_t>(total + weights[i]);
+        row[i] = total;
+    }
+    std::array<route_select::AliasEntry, kPorts> table{};
+    route_select::buildAlias(row.data(), kPorts, table.data());
+
+    std::vector<uint32_t> draws(kRoutePicks);
+    uint32_t seed = 0x0BADF00Du;
+    for (uint32_t& draw : draws) {
+        seed = seed * 1664525u + 1013904223u;
+        draw = seed >> 8;
+    }
+
+    uint32_t checksum = 0;
+    const double scan_ns = nanosPerFrame(kRouteFrames, [&](int /*frame_idx*/) {
+        for (const uint32_t draw : draws) {
+            checksum += route_select::pickCumulative(row.data(), kPorts, static_cast<uint16_t>(draw % total));
+        }
+    });
+    const double alias_ns = nanosPerFrame(kRouteFrames, [&](int /*frame_idx*/) {
+        for (const uint32_t draw : draws) {
+            checksum += route_select::pickAlias(table.data(), total, draw % (kPorts * total));
+        }
+    });
+    std::cout << "Benchmark route 9-port cumulative scan (ns/pick): " << scan_ns / kRoutePicks << "\n";
+    std::cout << "Benchmark route 9-port alias table (ns/pick): " << alias_ns / kRoutePicks << "\n";
+    std::cout << "Benchmark route checksum: " << checksum << "\n";
+}
+
+// The old std::rand float-range draw against the per-context generator, both
+// drawing a port index the way Intersection::randomPort does.
+void runRandomBenchmark() {
+    std::srand(1);
+    LightgraphRng rng(1);
+    uint32_t checksum = 0;
+    const double rand_ns = nanosPerFrame(kRandomFrames, [&](int /*frame_idx*/) {
+        for (int i = 0; i < kRandomDraws; i++) {
+            checksum += static_cast<uint32_t>(std::rand() / static_cast<float>(RAND_MAX) * 7.f);
+        }
+    });
+    const double rng_ns = nanosPerFrame(kRandomFrames, [&](int /*frame_idx*/) {
+        for (int i = 0; i < kRandomDraws; i++) {
+            checksum += rng.below(7);
+        }
+    });
+    std::cout << "Benchmark random std::rand float range (ns/draw): " << rand_ns / kRandomDraws << "\n";
+    std::cout << "Benchmark random seeded generator (ns/draw): " << rng_ns / kRandomDraws << "\n";
+    std::cout << "Benchmark random checksum: " << checksum << "\n";
+}
+
+// Emitter picks as State::getEmitter makes them, from the cached index and
+// with the index rebuilt before every pick (the cost the old per-emit scan paid).
+void runEmitterBenchmark() {
+    Heptagon3024 object;
+    const uint8_t groups = GROUP1 | GROUP2 | GROUP3;
+    LightgraphRng rng(1);
+    uintptr_t checksum = 0;
+    const double cached_ns = nanosPerFrame(kEmitterFrames, [&](int /*frame_idx*/) {
+        for (int i = 0; i < kEmitterPicks; i++) {
+            const uint16_t count = object.countEmittableIntersections(groups);
+            checksum += reinterpret_cast<uintptr_t>(object.getEmittableIntersection(rng.below(count), groups));
+        }
+    });
+    const double rebuilt_ns = nanosPerFrame(kEmitterFrames / 16, [&](int /*frame_idx*/) {
+        for (int i = 0; i < kEmitterPicks; i++) {
+            object.invalidateEmitters();
+            const uint16_t count = object.countEmittableIntersections(groups);
+            checksum += reinterpret_cast<uintptr_t>(object.getEmittableIntersection(rng.below(count), groups));
+        }
+    });
+    std::cout << "Benchmark emitter pick " << object.countEmittableIntersections(groups)
+              << " intersections, cached index (ns/pick): " << cached_ns / kEmitterPicks << "\n";
+    std::cout << "Benchmark emitter pick, index rebuilt (ns/pick): " << rebuilt_ns / kEmitterPicks << "\n";
+    std::cout << "Benchmark emitter checksum: " << (checksum & 0xFFFF) << "\n";
+}
+
+struct BlendModeName {
+    BlendMode mode;
+    const char* name;
+};
+
+// Mirrors the composite branch of State::setFramePixel for one channel plane.
+void runBlendBenchmark() {
+    const std::array<BlendModeName, 13> modes = {{
+        {BLEND_MULTIPLY, "multiply"},
+        {BLEND_SCREEN, "screen"},
+        {BLEND_OVERLAY, "overlay"},
+        {BLEND_SUBTRACT, "subtract"},
+        {BLEND_DIFFERENCE, "difference"},
+        {BLEND_EXCLUSION, "exclusion"},
+        {BLEND_DODGE, "dodge"},
+        {BLEND_BURN, "burn"},
+        {BLEND_HARD_LIGHT, "hard-light"},
+        {BLEND_SOFT_LIGHT, "soft-light"},
+        {BLEND_LINEAR_LIGHT, "linear-light"},
+        {BLEND_VIVID_LIGHT, "vivid-light"},
+        {BLEND_PIN_LIGHT, "pin-light"},
+    }};
+
+    std::vector<uint16_t> accumulators(kBlendPixels);
+    std::vector<uint8_t> divs(kBlendPixels);
+    std::vector<uint8_t> tops(kBlendPixels);
+    uint32_t seed = 0x2468ACE1u;
+    for (uint16_t i = 0; i < kBlendPixels; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        divs[i] = static_cast<uint8_t>(1 + (seed >> 30));
+        accumulators[i] = static_cast<uint16_t>(divs[i] * ((seed >> 8) & 0xFF));
+        tops[i] = static_cast<uint8_t>(seed >> 20);
+    }
+
+    std::vector<uint16_t> output(kBlendPixels);
+    uint32_t checksum = 0;
+    for (const BlendModeName& entry : modes) {
+        const double float_ns = nanosPerFrame(kBlendFrames, [&](int frame_idx) {
+            for (uint16_t i = 0; i < kBlendPixels; i++) {
+                const uint8_t div = divs[i];
+                const float base = (accumulators[i] / static_cast<float>(div)) / 255.0f;
+                output[i] = static_cast<uint16_t>(
+                    blend::blendFloat(entry.mode, base, tops[i] / 255.0f) * 255.0f * div);
+            }
+            checksum += output[static_cast<size_t>(frame_idx) % kBlendPixels];
+        });
+        const double fixed_ns = nanosPerFrame(kBlendFrames, [&](int frame_idx) {
+            for (uint16_t i = 0; i < kBlendPixels; i++) {
+                const uint8_t div = divs[i];
+                output[i] = blend::toAccumulator(
+                    blend::blendFixed(entry.mode, blend::toFixedAverage(accumulators[i], div),
+                                      blend::toFixed(tops[i])),
+                    div);
+            }
+            checksum += output[static_cast<size_t>(frame_idx) % kBlendPixels];
+        });
+        std::cout << "Benchmark blend " << entry.name << " float (ns/pixel): "
+                  << float_ns / kBlendPixels << "\n";
+        std::cout << "Benchmark blend " << entry.name << " fixed (ns/pixel): "
+                  << fixed_ns / kBlendPixels << "\n";
+    }
+    std::cout << "Benchmark blend checksum: " << checksum << "\n";
+}
+
+} // namespace
+
+int main() {
+    runResolveBenchmark();
+    runUpdateBenchmark(false);
+    runUpdateBenchmark(true);
+    runBgFillBenchmark();
+    runPaletteCacheBenchmark();
+    runColorSpaceBenchmark();
+    runCrowdBenchmark(false);
+    runCrowdBenchmark(true);
+    runParallelBenchmark();
+    runChurnBenchmark();
+    runGridBenchmark();
+    runRouteBenchmark();
+    runRandomBenchmark();
+    runEmitterBenchmark();
+    runBlendBenchmark();
+    return 0;
+}
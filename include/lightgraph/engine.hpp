@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "status.hpp"
 #include "types.hpp"
@@ -18,7 +20,9 @@ namespace lightgraph {
  *
  * `Engine` wraps the legacy topology/runtime implementation behind value-based
  * commands and typed status/error returns. Calls on the same instance are
- * serialized, but process-global runtime state is still shared across instances.
+ * serialized. Each instance keeps its clock, random generator and frame timing
+ * in its own runtime context, so separate instances can run concurrently on
+ * separate threads without locking each other.
  */
 class Engine {
   public:
@@ -38,6 +42,16 @@ class Engine {
      * @return list index on success, otherwise an error code/message.
      */
     Result<int8_t> emit(const EmitCommand& command);
+    /**
+     * @brief Emit `count` commands under a single lock.
+     *
+     * `results` is replaced with one entry per command, equal to what `emit()` would
+     * return for the commands called in order; a failed command does not stop the batch.
+     * Free list slots are scanned once per batch rather than once per command.
+     * @return number of commands that emitted on success, otherwise an error code/message.
+     */
+    Result<size_t> emitBatch(const EmitCommand* commands, size_t count,
+                             std::vector<Result<int8_t>>& results);
 
     /**
      * @brief Advance runtime to an absolute timestamp (milliseconds).
@@ -72,6 +86,40 @@ class Engine {
      */
     void setAutoEmitEnabled(bool enabled);
 
+    /**
+     * @brief Return the number of threads used to update light lists.
+     */
+    uint8_t updateThreads() const;
+    /**
+     * @brief Update light lists on `threads` threads (including the caller).
+     *
+     * Frames are identical to a serial update. Returns `InvalidArgument` for
+     * `0`, or for more than one thread when the library was built without
+     * `LIGHTGRAPH_CORE_ENABLE_PARALLEL_UPDATE`.
+     */
+    Status setUpdateThreads(uint8_t threads);
+
+    /**
+     * @brief Restart the engine's random generator from `seed`.
+     *
+     * Random models, speeds, colors and routes are drawn from a generator owned by
+     * the engine, so two engines with the same seed that receive the same calls
+     * render the same frames, whatever their `update_threads`.
+     */
+    void seedRandom(uint64_t seed);
+    /**
+     * @brief Return the calls recorded so far when `EngineConfig::record_replay` is set.
+     */
+    ReplayLog replayLog() const;
+    /**
+     * @brief Re-run a recording on this engine.
+     *
+     * The engine must be freshly constructed with the recording engine's object type,
+     * pixel count and `auto_emit`; frames then match the recording bit for bit.
+     * Returns `InvalidArgument` once the engine has been emitted to or updated.
+     */
+    Status replay(const ReplayLog& log);
+
     /**
      * @brief Return total pixel count for the active object.
      */
@@ -80,6 +128,47 @@ class Engine {
      * @brief Fetch a rendered pixel color by index.
      */
     Result<Color> pixel(uint16_t index, uint8_t max_brightness = 255) const;
+    /**
+     * @brief Resolve the whole rendered frame into `out` under a single lock.
+     *
+     * `count` must be at least `pixelCount()`; pixels beyond the frame are left untouched.
+     * @return number of pixels written on success; `ErrorCode::InvalidArgument` for a null or
+     *         short buffer.
+     */
+    Result<uint16_t> readFrame(Color* out, size_t count, uint8_t max_brightness = 255) const;
+    /**
+     * @brief Resolve the whole rendered frame into packed `RGB` bytes (3 bytes per pixel).
+     *
+     * `size` is the buffer length in bytes and must be at least `3 * pixelCount()`.
+     * @return number of pixels written on success; `ErrorCode::InvalidArgument` for a null or
+     *         short buffer.
+     */
+    Result<uint16_t> readFrame(uint8_t* rgb, size_t size, uint8_t max_brightness = 255) const;
+    /**
+     * @brief Write the indices of pixels that may differ from the previous rendered frame.
+     *
+     * Indices are ascending and cover every pixel lit in the last or the previous rendered
+     * frame; pixels not reported are black in both. Hosts streaming deltas can resend only
+     * these pixels. `count` is the capacity of `out` in indices; `pixelCount()` is always enough.
+     * @return number of indices written on success; `ErrorCode::InvalidArgument` for a null or
+     *         short buffer, as `readFrame()`.
+     */
+    Result<uint16_t> changedPixels(uint16_t* out, size_t count) const;
+    /**
+     * @brief Replace `delta` with the pixels whose output changed since the previous call.
+     *
+     * The engine retains the last emitted frame and compares the current output against it;
+     * the first call, and the first after `resetFrameDelta()`, reports every pixel. A pixel
+     * counts as changed when any channel moved by more than `threshold`; suppressed pixels
+     * keep their previously emitted value, so slow drifts still surface once they exceed it.
+     * @return number of changed pixels on success, otherwise an error code/message.
+     */
+    Result<uint16_t> readFrameDelta(FrameDelta& delta, uint8_t threshold = 0,
+                                    uint8_t max_brightness = 255);
+    /**
+     * @brief Forget the retained frame so the next `readFrameDelta()` reports every pixel.
+     */
+    void resetFrameDelta();
 
   private:
     struct Impl;
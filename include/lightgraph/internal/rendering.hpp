@@ -1,4 +1,7 @@
 #pragma once
 
+#include "src/rendering/Blend.h"
+#include "src/rendering/ColorTheory.h"
 #include "src/rendering/Palette.h"
+#include "src/rendering/PaletteCache.h"
 #include "src/rendering/Palettes.h"
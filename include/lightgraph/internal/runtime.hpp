@@ -2,8 +2,11 @@
 
 #include "src/runtime/Behaviour.h"
 #include "src/runtime/EmitParams.h"
+#include "src/runtime/FrameDelta.h"
 #include "src/runtime/RuntimeLight.h"
 #include "src/runtime/Light.h"
+#include "src/runtime/LightArena.h"
 #include "src/runtime/LightList.h"
 #include "src/runtime/BgLight.h"
+#include "src/runtime/PixelResolve.h"
 #include "src/runtime/State.h"
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <vector>
 
 namespace lightgraph {
 
@@ -19,6 +20,26 @@ struct Color {
     uint8_t b = 0;
 };
 
+/**
+ * @brief Contiguous run of changed pixels in a `FrameDelta`.
+ */
+struct PixelRun {
+    /// First pixel index of the run.
+    uint16_t start = 0;
+    /// Number of consecutive pixels in the run.
+    uint16_t length = 0;
+};
+
+/**
+ * @brief Pixels that changed since the previously emitted frame.
+ */
+struct FrameDelta {
+    /// Changed runs in ascending pixel order.
+    std::vector<PixelRun> runs;
+    /// New color of every run pixel, concatenated in run order.
+    std::vector<Color> colors;
+};
+
 /**
  * @brief Built-in object topologies supported by the high-level engine API.
  */
@@ -41,6 +62,13 @@ struct EngineConfig {
     uint16_t pixel_count = 0;
     /// Enable or disable internal automatic emission on each update/tick.
     bool auto_emit = false;
+    /// Threads used to update light lists, counting the calling thread.
+    /// `1` updates serially; see `Engine::setUpdateThreads`.
+    uint8_t update_threads = 1;
+    /// Seed of the engine's random generator; see `Engine::seedRandom`.
+    uint64_t random_seed = 0;
+    /// Record every emit, update and seed for `Engine::replay`.
+    bool record_replay = false;
 };
 
 /**
@@ -77,4 +105,39 @@ struct EmitCommand {
     bool linked = true;
 };
 
+/**
+ * @brief Kind of call captured in a `ReplayLog`.
+ */
+enum class ReplayEventType {
+    Emit,
+    Update,
+    StopAll,
+    SetAutoEmit,
+    Seed,
+};
+
+/**
+ * @brief One recorded engine call.
+ */
+struct ReplayEvent {
+    ReplayEventType type = ReplayEventType::Update;
+    /// Absolute engine time for `Update` (ticks are recorded as updates).
+    uint64_t millis = 0;
+    /// New seed for `Seed`.
+    uint64_t seed = 0;
+    /// New state for `SetAutoEmit`.
+    bool enabled = false;
+    /// Command for `Emit`.
+    EmitCommand command;
+};
+
+/**
+ * @brief Seed plus the calls that drove an engine, in call order.
+ */
+struct ReplayLog {
+    /// `EngineConfig::random_seed` of the recording engine.
+    uint64_t seed = 0;
+    std::vector<ReplayEvent> events;
+};
+
 } // namespace lightgraph
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include "FastNoise.h"
+#include "core/Rng.h"
 #include "runtime/EmitParams.h"
 
 #ifndef LIGHTGRAPH_ALLOCATION_FAILURE_HOOK_ENABLED
@@ -20,6 +21,48 @@
 #define LIGHTGRAPH_FRACTIONAL_RENDERING 1
 #endif
 
+#ifndef LIGHTGRAPH_LAYER_COMPOSITING
+#define LIGHTGRAPH_LAYER_COMPOSITING LIGHTGRAPH_FRACTIONAL_RENDERING
+#endif
+
+#if LIGHTGRAPH_FRACTIONAL_RENDERING && !LIGHTGRAPH_LAYER_COMPOSITING
+#error "LIGHTGRAPH_FRACTIONAL_RENDERING requires LIGHTGRAPH_LAYER_COMPOSITING"
+#endif
+
+// Lets State spread list updates over worker threads (State::setUpdateThreads).
+// Host builds only: needs <thread> and layer compositing.
+#ifndef LIGHTGRAPH_PARALLEL_UPDATE
+#define LIGHTGRAPH_PARALLEL_UPDATE 0
+#endif
+
+#if LIGHTGRAPH_PARALLEL_UPDATE && !LIGHTGRAPH_LAYER_COMPOSITING
+#error "LIGHTGRAPH_PARALLEL_UPDATE requires LIGHTGRAPH_LAYER_COMPOSITING"
+#endif
+
+#ifndef LIGHTGRAPH_FIXED_POINT_BLEND
+#define LIGHTGRAPH_FIXED_POINT_BLEND 0
+#endif
+
+// Lights (views and store fields) preallocated per State. Replacing a list builds the new one
+// before the old one is released, so a scene held at MAX_TOTAL_LIGHTS also
+// needs room for the largest replacement, which can be MAX_TOTAL_LIGHTS long.
+#ifndef LIGHTGRAPH_LIGHT_ARENA_CAPACITY
+#define LIGHTGRAPH_LIGHT_ARENA_CAPACITY (2 * MAX_TOTAL_LIGHTS)
+#endif
+
+// Interpolated palette tables each State keeps (PaletteCache). Covers the
+// distinct palette/length combinations a show cycles through; 0 disables it.
+#ifndef LIGHTGRAPH_PALETTE_CACHE_CAPACITY
+#define LIGHTGRAPH_PALETTE_CACHE_CAPACITY 16
+#endif
+
+// Intersections with at least this many port slots pick weighted-random
+// routes from an alias table (one draw, one compare) instead of scanning the
+// cumulative weights. Below it the scan is as cheap.
+#ifndef LIGHTGRAPH_ALIAS_ROUTING_MIN_PORTS
+#define LIGHTGRAPH_ALIAS_ROUTING_MIN_PORTS 5
+#endif
+
 #ifndef LIGHTGRAPH_MAX_SIMULATION_SUBSTEPS
 #define LIGHTGRAPH_MAX_SIMULATION_SUBSTEPS 8
 #endif
@@ -43,10 +86,12 @@ using LightgraphAllocationFailureObserver =
     void (*)(LightgraphAllocationFailureSite site, uint16_t detail0, uint16_t detail1);
 
 using LightgraphExternalSendHook =
-    bool (*)(const uint8_t* mac, uint8_t id, RuntimeLight* const light, bool sendList);
+    bool (*)(const uint8_t* mac, uint16_t id, RuntimeLight* const light, bool sendList);
 
 struct LightgraphRuntimeContext {
   FastNoise perlinNoise;
+  // Seeds the per-list streams and draws for emits; see Random::Scope.
+  LightgraphRng rng;
   unsigned long nowMillis = 0;
   bool hasExplicitNowMillis = false;
   LightgraphAllocationFailureObserver allocationFailureObserver = nullptr;
@@ -55,9 +100,10 @@ struct LightgraphRuntimeContext {
   float frameElapsedMillis = static_cast<float>(EmitParams::frameMs());
   float currentStepMillis = static_cast<float>(EmitParams::frameMs());
   LightgraphExternalSendHook externalSendHook = nullptr;
+  // Next LightList::id handed out by LightList::bindRuntimeContext.
+  uint16_t nextListId = 0;
 };
 
-extern FastNoise gPerlinNoise;
 extern unsigned long gMillis;
 
 LightgraphRuntimeContext& lightgraphDefaultRuntimeContext();
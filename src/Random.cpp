@@ -1,7 +1,7 @@
 #include "Random.h"
 #include <algorithm>
 
-#include "core/Platform.h"
+#include "Globals.h"
 
 float Random::MIN_SPEED = 0.5f;
 float Random::MAX_SPEED = 10.f;
@@ -16,30 +16,62 @@ uint8_t Random::MAX_VALUE = 255;
 uint16_t Random::MIN_NEXT = 2000; // ms, ~125 frames (avg fps is 62.5)
 uint16_t Random::MAX_NEXT = 20000; // ms, ~1250 frames (avg fps is 62.5)
 
+namespace {
+
+// Thread-local wherever threads exist, so engines running on separate threads
+// each see only their own scoped generator.
+#if LIGHTGRAPH_PARALLEL_UPDATE || !defined(ARDUINO)
+thread_local LightgraphRng* gActiveRng = nullptr;
+#else
+LightgraphRng* gActiveRng = nullptr;
+#endif
+
+} // namespace
+
+LightgraphRng& Random::active() {
+  return (gActiveRng != nullptr) ? *gActiveRng : lightgraphDefaultRuntimeContext().rng;
+}
+
+uint32_t Random::below(uint32_t range) {
+  return active().below(range);
+}
+
+float Random::uniform(float max) {
+  return active().uniform(max);
+}
+
+Random::Scope::Scope(LightgraphRng& rng) : previous_(gActiveRng) {
+  gActiveRng = &rng;
+}
+
+Random::Scope::~Scope() {
+  gActiveRng = previous_;
+}
+
 float Random::randomSpeed() {
-  return MIN_SPEED + LG_RANDOM(std::max(MAX_SPEED - MIN_SPEED, 0.f));
+  return MIN_SPEED + uniform(std::max(MAX_SPEED - MIN_SPEED, 0.f));
 }
 
 uint32_t Random::randomDuration() {
-  return MIN_DURATION + LG_RANDOM(std::max(MAX_DURATION - MIN_DURATION, static_cast<uint32_t>(0)));
+  return MIN_DURATION + below(MAX_DURATION > MIN_DURATION ? MAX_DURATION - MIN_DURATION : 0);
 }
 
 uint16_t Random::randomLength() {
-  return static_cast<uint16_t>(MIN_LENGTH + LG_RANDOM(std::max(MAX_LENGTH - MIN_LENGTH, 0)));
+  return static_cast<uint16_t>(MIN_LENGTH + below(std::max(MAX_LENGTH - MIN_LENGTH, 0)));
 }
 
 uint8_t Random::randomHue() {
-  return LG_RANDOM(256);
+  return below(256);
 }
 
 uint8_t Random::randomSaturation() {
-  return MIN_SATURATION + LG_RANDOM(std::max(MAX_SATURATION - MIN_SATURATION, 0));
+  return MIN_SATURATION + below(std::max(MAX_SATURATION - MIN_SATURATION, 0));
 }
 
 uint8_t Random::randomValue() {
-  return MIN_VALUE + LG_RANDOM(std::max(MAX_VALUE - MIN_VALUE, 0));
+  return MIN_VALUE + below(std::max(MAX_VALUE - MIN_VALUE, 0));
 }
 
 uint16_t Random::randomNextEmit() {
-  return MIN_NEXT + LG_RANDOM(std::max(MAX_NEXT - MIN_NEXT, 0));
+  return MIN_NEXT + below(std::max(MAX_NEXT - MIN_NEXT, 0));
 }
@@ -2,9 +2,29 @@
 
 #include <stdint.h>
 
+#include "core/Rng.h"
+
 class Random
 {
   public:
+    // Generator behind the draws below on the calling thread: the one bound
+    // by the innermost Scope, or the default runtime context's.
+    static LightgraphRng& active();
+    static uint32_t below(uint32_t range);
+    static float uniform(float max);
+
+    // Binds a generator to the calling thread for the lifetime of the scope.
+    class Scope {
+      public:
+        explicit Scope(LightgraphRng& rng);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        LightgraphRng* previous_;
+    };
+
     static float randomSpeed();
     static uint32_t randomDuration();
     static uint16_t randomLength();
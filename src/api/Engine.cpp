@@ -1,18 +1,25 @@
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <mutex>
 #include <utility>
+#include <vector>
 
 #include <lightgraph/engine.hpp>
 #include <lightgraph/internal/object_factory.hpp>
 #include "../core/Limits.h"
 #include "../Globals.h"
 #include "../runtime/EmitParams.h"
+#include "../runtime/FrameDelta.h"
+#include "../runtime/LightList.h"
 #include "../runtime/State.h"
 
 namespace lightgraph {
 
 namespace {
 
+static_assert(sizeof(Color) == 3, "Color must pack as three RGB bytes for bulk frame readout");
+
 std::unique_ptr<TopologyObject> makeObject(const EngineConfig& config) {
     return internal::makeBuiltinObject(config.object_type, config.pixel_count);
 }
@@ -23,115 +30,259 @@ struct Engine::Impl {
     explicit Impl(const EngineConfig& config)
         : object(makeObject(config)), state(*object), now_millis(0) {
         state.autoEnabled = config.auto_emit;
+        state.setUpdateThreads(config.update_threads);
         state.clearListSlot(0);
+        // Engines keep their own clock and never fall back to gMillis.
+        object->setNowMillis(0);
+        object->runtimeContext().rng.seed(config.random_seed);
+        record_replay = config.record_replay;
+        replay_log.seed = config.random_seed;
     }
 
-    bool hasFreeListSlot(uint16_t note_id) const {
-        if (note_id > 0 && state.findList(note_id) >= 0) {
-            return true;
+    Result<uint16_t> readFrame(uint8_t* rgb, size_t pixel_capacity, uint8_t max_brightness) const {
+        const uint16_t pixel_count = object->pixelCount;
+        if (rgb == nullptr && pixel_count > 0) {
+            return Result<uint16_t>::error(ErrorCode::InvalidArgument, "frame buffer must not be null");
+        }
+        if (pixel_capacity < pixel_count) {
+            return Result<uint16_t>::error(ErrorCode::InvalidArgument,
+                                           "frame buffer is smaller than pixelCount()");
         }
-        for (uint8_t i = 0; i < MAX_LIGHT_LISTS; ++i) {
-            if (state.lightLists[i] == nullptr) {
-                return true;
+        if (!output_enabled) {
+            std::memset(rgb, 0, static_cast<size_t>(pixel_count) * 3u);
+            return Result<uint16_t>(pixel_count);
+        }
+        return Result<uint16_t>(state.resolvePixels(rgb, pixel_count, max_brightness));
+    }
+
+    // Occupancy of the light-list table from one scan. emitBatch() keeps it
+    // current as it emits instead of rescanning the table for every command.
+    struct SlotView {
+        std::array<uint16_t, MAX_LIGHT_LISTS> note_ids{};
+        std::array<bool, MAX_LIGHT_LISTS> occupied{};
+        uint8_t free_slots = 0;
+
+        explicit SlotView(const State& state) {
+            for (uint8_t i = 0; i < MAX_LIGHT_LISTS; ++i) {
+                const LightList* list = state.lightLists[i];
+                occupied[i] = list != nullptr;
+                note_ids[i] = list != nullptr ? list->noteId : 0;
+                if (list == nullptr) {
+                    ++free_slots;
+                }
             }
         }
-        return false;
+
+        bool hasFreeSlot(uint16_t note_id) const {
+            if (note_id > 0) {
+                for (uint8_t i = 0; i < MAX_LIGHT_LISTS; ++i) {
+                    if (occupied[i] && note_ids[i] == note_id) {
+                        return true;
+                    }
+                }
+            }
+            return free_slots > 0;
+        }
+
+        void claim(int8_t index, uint16_t note_id) {
+            if (!occupied[index]) {
+                occupied[index] = true;
+                --free_slots;
+            }
+            note_ids[index] = note_id;
+        }
+    };
+
+    Result<int8_t> emit(const EmitCommand& command) {
+        SlotView slots(state);
+        EmitParams params;
+        return emit(command, params, slots);
     }
 
-    std::unique_ptr<TopologyObject> object;
-    State state;
-    uint64_t now_millis;
-    bool output_enabled = true;
-    mutable std::mutex mutex;
-};
+    // Emits every command under the caller's lock with one slot scan and one
+    // EmitParams, writing the same results the commands would get one by one.
+    size_t emitBatch(const EmitCommand* commands, size_t count, std::vector<Result<int8_t>>& results) {
+        results.clear();
+        results.reserve(count);
+        SlotView slots(state);
+        EmitParams params;
+        size_t emitted = 0;
+        for (size_t i = 0; i < count; ++i) {
+            results.push_back(emit(commands[i], params, slots));
+            if (results.back().ok()) {
+                ++emitted;
+            }
+        }
+        return emitted;
+    }
 
-Engine::Engine(const EngineConfig& config) : impl_(new Impl(config)) {}
+    // `params` is overwritten with every command-driven field, so it can be
+    // reused across commands.
+    Result<int8_t> emit(const EmitCommand& command, EmitParams& params, SlotView& slots) {
+        ReplayEvent event;
+        event.type = ReplayEventType::Emit;
+        event.command = command;
+        record(event);
+        started = true;
 
-Engine::~Engine() = default;
+        if (command.max_brightness < command.min_brightness) {
+            return Result<int8_t>::error(ErrorCode::InvalidArgument,
+                                         "max_brightness must be >= min_brightness");
+        }
 
-Engine::Engine(Engine&&) noexcept = default;
-Engine& Engine::operator=(Engine&&) noexcept = default;
+        const int8_t model_index = command.model;
+        if (model_index < 0 || object->getModel(model_index) == nullptr) {
+            return Result<int8_t>::error(ErrorCode::InvalidModel,
+                                         "model index is invalid for the current object");
+        }
 
-Result<int8_t> Engine::emit(const EmitCommand& command) {
-    std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (!slots.hasFreeSlot(command.note_id)) {
+            return Result<int8_t>::error(ErrorCode::NoFreeLightList,
+                                         "no free light-list slots are available");
+        }
+
+        if (command.length.has_value() &&
+            state.totalLights + *command.length > MAX_TOTAL_LIGHTS) {
+            return Result<int8_t>::error(ErrorCode::CapacityExceeded,
+                                         "emit request exceeds MAX_TOTAL_LIGHTS");
+        }
+
+        params.model = model_index;
+        params.speed = command.speed;
+        params.setColors(command.color.value_or(RANDOM_COLOR));
+        if (command.length.has_value()) {
+            params.setLength(*command.length);
+        } else {
+            params.clearLength();
+        }
+        params.trail = command.trail;
+        params.noteId = command.note_id;
+        params.minBri = command.min_brightness;
+        params.maxBri = command.max_brightness;
+        params.behaviourFlags = command.behaviour_flags;
+        params.emitGroups = command.emit_groups;
+        params.emitOffset = command.emit_offset;
+        params.duration = command.duration_ms;
+        params.from = command.from;
+        params.linked = command.linked;
+
+        Model* const model = object->getModel(model_index);
+        if (model != nullptr) {
+            const uint8_t emit_groups = params.getEmitGroups(model->emitGroups);
+            if ((params.behaviourFlags & B_EMIT_FROM_CONN) != 0) {
+                if (object->countConnections(params.emitGroups) == 0) {
+                    return Result<int8_t>::error(ErrorCode::NoEmitterAvailable,
+                                                 "no matching connections are available for emit");
+                }
+            } else if (object->countEmittableIntersections(emit_groups) == 0) {
+                return Result<int8_t>::error(ErrorCode::NoEmitterAvailable,
+                                             "no matching intersections are available for emit");
+            }
+        }
 
-    if (command.max_brightness < command.min_brightness) {
-        return Result<int8_t>::error(ErrorCode::InvalidArgument,
-                                     "max_brightness must be >= min_brightness");
+        const int8_t list_index = state.emit(params);
+        if (list_index < 0) {
+            return Result<int8_t>::error(ErrorCode::InternalError, "emit failed unexpectedly");
+        }
+        slots.claim(list_index, command.note_id);
+        return Result<int8_t>(list_index);
     }
 
-    const int8_t model_index = command.model;
-    if (model_index < 0 || impl_->object->getModel(model_index) == nullptr) {
-        return Result<int8_t>::error(ErrorCode::InvalidModel,
-                                     "model index is invalid for the current object");
+    void update(uint64_t millis) {
+        ReplayEvent event;
+        event.type = ReplayEventType::Update;
+        event.millis = millis;
+        record(event);
+        started = true;
+
+        now_millis = millis;
+        object->setNowMillis(static_cast<unsigned long>(millis));
+        state.autoEmit(object->nowMillis());
+        state.update();
     }
 
-    if (!impl_->hasFreeListSlot(command.note_id)) {
-        return Result<int8_t>::error(ErrorCode::NoFreeLightList,
-                                     "no free light-list slots are available");
+    void stopAll() {
+        ReplayEvent event;
+        event.type = ReplayEventType::StopAll;
+        record(event);
+        started = true;
+        state.stopAll();
     }
 
-    if (command.length.has_value() &&
-        impl_->state.totalLights + *command.length > MAX_TOTAL_LIGHTS) {
-        return Result<int8_t>::error(ErrorCode::CapacityExceeded,
-                                     "emit request exceeds MAX_TOTAL_LIGHTS");
+    void setAutoEmitEnabled(bool enabled) {
+        ReplayEvent event;
+        event.type = ReplayEventType::SetAutoEmit;
+        event.enabled = enabled;
+        record(event);
+        started = true;
+        state.autoEnabled = enabled;
     }
 
-    EmitParams params(model_index, command.speed, command.color.value_or(RANDOM_COLOR));
-    if (command.length.has_value()) {
-        params.setLength(*command.length);
+    void seedRandom(uint64_t seed) {
+        ReplayEvent event;
+        event.type = ReplayEventType::Seed;
+        event.seed = seed;
+        record(event);
+        object->runtimeContext().rng.seed(seed);
     }
-    params.trail = command.trail;
-    params.noteId = command.note_id;
-    params.minBri = command.min_brightness;
-    params.maxBri = command.max_brightness;
-    params.behaviourFlags = command.behaviour_flags;
-    params.emitGroups = command.emit_groups;
-    params.emitOffset = command.emit_offset;
-    params.duration = command.duration_ms;
-    params.from = command.from;
-    params.linked = command.linked;
 
-    Model* const model = impl_->object->getModel(model_index);
-    if (model != nullptr) {
-        const uint8_t emit_groups = params.getEmitGroups(model->emitGroups);
-        if ((params.behaviourFlags & B_EMIT_FROM_CONN) != 0) {
-            if (impl_->object->countConnections(params.emitGroups) == 0) {
-                return Result<int8_t>::error(ErrorCode::NoEmitterAvailable,
-                                             "no matching connections are available for emit");
-            }
-        } else if (impl_->object->countEmittableIntersections(emit_groups) == 0) {
-            return Result<int8_t>::error(ErrorCode::NoEmitterAvailable,
-                                         "no matching intersections are available for emit");
+    void record(const ReplayEvent& event) {
+        if (record_replay) {
+            replay_log.events.push_back(event);
         }
     }
 
-    const int8_t list_index = impl_->state.emit(params);
-    if (list_index < 0) {
-        return Result<int8_t>::error(ErrorCode::InternalError, "emit failed unexpectedly");
+    std::unique_ptr<TopologyObject> object;
+    State state;
+    uint64_t now_millis;
+    bool output_enabled = true;
+    bool record_replay = false;
+    // Set by the calls replay() re-runs, so it can refuse engines that already ran.
+    bool started = false;
+    ReplayLog replay_log;
+    std::vector<uint16_t> changed_pixels;
+    // Created on first readFrameDelta() so hosts that never stream deltas pay nothing.
+    std::unique_ptr<FrameDeltaTracker> frame_delta;
+    std::vector<DeltaRun> delta_runs;
+    std::vector<uint8_t> delta_rgb;
+    mutable std::mutex mutex;
+};
+
+Engine::Engine(const EngineConfig& config) : impl_(new Impl(config)) {}
+
+Engine::~Engine() = default;
+
+Engine::Engine(Engine&&) noexcept = default;
+Engine& Engine::operator=(Engine&&) noexcept = default;
+
+Result<int8_t> Engine::emit(const EmitCommand& command) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->emit(command);
+}
+
+Result<size_t> Engine::emitBatch(const EmitCommand* commands, size_t count,
+                                 std::vector<Result<int8_t>>& results) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (commands == nullptr && count > 0) {
+        results.clear();
+        return Result<size_t>::error(ErrorCode::InvalidArgument, "command buffer must not be null");
     }
-    return Result<int8_t>(list_index);
+    return Result<size_t>(impl_->emitBatch(commands, count, results));
 }
 
 void Engine::update(uint64_t millis) {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    impl_->now_millis = millis;
-    impl_->object->setNowMillis(static_cast<unsigned long>(millis));
-    impl_->state.autoEmit(impl_->object->nowMillis());
-    impl_->state.update();
+    impl_->update(millis);
 }
 
 void Engine::tick(uint64_t delta_millis) {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    impl_->now_millis += delta_millis;
-    impl_->object->setNowMillis(static_cast<unsigned long>(impl_->now_millis));
-    impl_->state.autoEmit(impl_->object->nowMillis());
-    impl_->state.update();
+    impl_->update(impl_->now_millis + delta_millis);
 }
 
 void Engine::stopAll() {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    impl_->state.stopAll();
+    impl_->stopAll();
 }
 
 bool Engine::isOn() const {
@@ -151,7 +302,62 @@ bool Engine::autoEmitEnabled() const {
 
 void Engine::setAutoEmitEnabled(bool enabled) {
     std::lock_guard<std::mutex> lock(impl_->mutex);
-    impl_->state.autoEnabled = enabled;
+    impl_->setAutoEmitEnabled(enabled);
+}
+
+uint8_t Engine::updateThreads() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->state.getUpdateThreads();
+}
+
+Status Engine::setUpdateThreads(uint8_t threads) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->state.setUpdateThreads(threads)) {
+        return Status::error(ErrorCode::InvalidArgument,
+                             threads == 0 ? "update threads must be at least 1"
+                                          : "parallel update is not available in this build");
+    }
+    return Status::success();
+}
+
+void Engine::seedRandom(uint64_t seed) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->seedRandom(seed);
+}
+
+ReplayLog Engine::replayLog() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->replay_log;
+}
+
+Status Engine::replay(const ReplayLog& log) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->started) {
+        return Status::error(ErrorCode::InvalidArgument,
+                             "replay requires an engine that has not been emitted to or updated");
+    }
+    impl_->object->runtimeContext().rng.seed(log.seed);
+    impl_->replay_log.seed = log.seed;
+    for (const ReplayEvent& event : log.events) {
+        switch (event.type) {
+            case ReplayEventType::Emit:
+                impl_->emit(event.command);
+                break;
+            case ReplayEventType::Update:
+                impl_->update(event.millis);
+                break;
+            case ReplayEventType::StopAll:
+                impl_->stopAll();
+                break;
+            case ReplayEventType::SetAutoEmit:
+                impl_->setAutoEmitEnabled(event.enabled);
+                break;
+            case ReplayEventType::Seed:
+                impl_->seedRandom(event.seed);
+                break;
+        }
+    }
+    return Status::success();
 }
 
 uint16_t Engine::pixelCount() const {
@@ -172,4 +378,60 @@ Result<Color> Engine::pixel(uint16_t index, uint8_t max_brightness) const {
     return Result<Color>(Color{value.R, value.G, value.B});
 }
 
+Result<uint16_t> Engine::readFrame(Color* out, size_t count, uint8_t max_brightness) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->readFrame(reinterpret_cast<uint8_t*>(out), count, max_brightness);
+}
+
+Result<uint16_t> Engine::readFrame(uint8_t* rgb, size_t size, uint8_t max_brightness) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->readFrame(rgb, size / 3u, max_brightness);
+}
+
+Result<uint16_t> Engine::changedPixels(uint16_t* out, size_t count) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->state.collectChangedPixels(impl_->changed_pixels);
+    const std::vector<uint16_t>& changed = impl_->changed_pixels;
+    if (out == nullptr && !changed.empty()) {
+        return Result<uint16_t>::error(ErrorCode::InvalidArgument, "index buffer must not be null");
+    }
+    if (count < changed.size()) {
+        return Result<uint16_t>::error(ErrorCode::InvalidArgument,
+                                       "index buffer is smaller than the changed-pixel set");
+    }
+    std::copy(changed.begin(), changed.end(), out);
+    return Result<uint16_t>(static_cast<uint16_t>(changed.size()));
+}
+
+Result<uint16_t> Engine::readFrameDelta(FrameDelta& delta, uint8_t threshold, uint8_t max_brightness) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->frame_delta) {
+        impl_->frame_delta = std::make_unique<FrameDeltaTracker>(impl_->object->pixelCount);
+    }
+    impl_->delta_runs.clear();
+    impl_->delta_rgb.clear();
+    // Disabled output resolves as black so receivers see the blackout as a delta.
+    const uint8_t brightness = impl_->output_enabled ? max_brightness : 0;
+    const uint16_t changed = impl_->frame_delta->collect(
+        impl_->state, threshold, brightness, impl_->delta_runs, impl_->delta_rgb);
+
+    delta.runs.resize(impl_->delta_runs.size());
+    for (size_t i = 0; i < impl_->delta_runs.size(); ++i) {
+        delta.runs[i].start = impl_->delta_runs[i].start;
+        delta.runs[i].length = impl_->delta_runs[i].length;
+    }
+    delta.colors.resize(changed);
+    if (changed > 0) {
+        std::memcpy(delta.colors.data(), impl_->delta_rgb.data(), impl_->delta_rgb.size());
+    }
+    return Result<uint16_t>(changed);
+}
+
+void Engine::resetFrameDelta() {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->frame_delta) {
+        impl_->frame_delta->reset();
+    }
+}
+
 } // namespace lightgraph
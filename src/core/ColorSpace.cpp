@@ -0,0 +1,144 @@
+#include "ColorSpace.h"
+
+#include <array>
+
+#include "Types.h"
+
+namespace colorspace {
+
+namespace {
+
+// D65 reference white and the CIE L*a*b* constants.
+constexpr float kWhiteX = 0.95047f;
+constexpr float kWhiteZ = 1.08883f;
+constexpr float kEpsilon = 216.0f / 24389.0f;
+constexpr float kKappa = 24389.0f / 27.0f;
+constexpr float kDegrees = 57.29577951f;
+constexpr float kRadians = 0.01745329252f;
+
+// sRGB-encoded byte -> linear light, looked up instead of a pow per channel.
+const std::array<float, 256>& linearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (size_t i = 0; i < values.size(); i++) {
+            const float c = static_cast<float>(i) / 255.0f;
+            values[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+// Linear-light value at which each sRGB byte starts (midpoint to the byte
+// below); entry 0 is below any input.
+const std::array<float, 256>& encodeThresholds() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        values[0] = -1.0f;
+        for (size_t i = 1; i < values.size(); i++) {
+            const float c = (static_cast<float>(i) - 0.5f) / 255.0f;
+            values[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table;
+}
+
+inline float labF(float t) {
+    const float cube = std::cbrt(t);
+    const float linear = (kKappa * t + 16.0f) / 116.0f;
+    return (t > kEpsilon) ? cube : linear;
+}
+
+inline float labInverseF(float f) {
+    const float cube = f * f * f;
+    const float linear = (116.0f * f - 16.0f) / kKappa;
+    return (cube > kEpsilon) ? cube : linear;
+}
+
+// Nearest sRGB byte of a linear-light value: a fixed eight-step binary
+// search of the thresholds instead of a pow per channel.
+inline uint8_t encodeSrgb(const std::array<float, 256>& thresholds, float linear) {
+    size_t index = 0;
+    for (size_t step = 128; step > 0; step >>= 1) {
+        index = (thresholds[index + step] <= linear) ? index + step : index;
+    }
+    return static_cast<uint8_t>(index);
+}
+
+}  // namespace
+
+void rgbToHsv(const ColorRGB* in, HSV* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        // Sort the channels with selects, tracking the hue offset of the
+        // sector, so hue is one divide with no branch on the max channel.
+        const float r = in[i].R * (1.0f / 255.0f);
+        const float g = in[i].G * (1.0f / 255.0f);
+        const float b = in[i].B * (1.0f / 255.0f);
+        const bool gLessB = g < b;
+        const float g1 = gLessB ? b : g;
+        const float b1 = gLessB ? g : b;
+        const float offset1 = gLessB ? -1.0f : 0.0f;
+        const bool rLessG = r < g1;
+        const float r2 = rLessG ? g1 : r;
+        const float g2 = rLessG ? r : g1;
+        const float offset = rLessG ? (-2.0f / 6.0f - offset1) : offset1;
+        const float chroma = r2 - std::min(g2, b1);
+        const float hue = std::fabs(offset + (g2 - b1) / (6.0f * chroma + 1e-20f));
+        float degrees = hue * 360.0f;
+        degrees = (degrees >= 360.0f) ? degrees - 360.0f : degrees;
+        out[i].h = degrees;
+        out[i].s = chroma / (r2 + 1e-20f);
+        out[i].v = r2;
+    }
+}
+
+void hsvToRgb(const HSV* in, ColorRGB* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const HSV& c = in[i];
+        out[i] = ColorRGB(unitToByte(hsvChannel(5.0f, c.h, c.s, c.v)),
+                          unitToByte(hsvChannel(3.0f, c.h, c.s, c.v)),
+                          unitToByte(hsvChannel(1.0f, c.h, c.s, c.v)));
+    }
+}
+
+void rgbToLch(const ColorRGB* in, LCh* out, size_t count) {
+    const std::array<float, 256>& linear = linearTable();
+    for (size_t i = 0; i < count; i++) {
+        const float r = linear[in[i].R];
+        const float g = linear[in[i].G];
+        const float b = linear[in[i].B];
+        const float x = (0.4124564f * r + 0.3575761f * g + 0.1804375f * b) * (1.0f / kWhiteX);
+        const float y = 0.2126729f * r + 0.7151522f * g + 0.0721750f * b;
+        const float z = (0.0193339f * r + 0.1191920f * g + 0.9503041f * b) * (1.0f / kWhiteZ);
+        const float fx = labF(x);
+        const float fy = labF(y);
+        const float fz = labF(z);
+        const float labA = 500.0f * (fx - fy);
+        const float labB = 200.0f * (fy - fz);
+        float hue = std::atan2(labB, labA) * kDegrees;
+        hue = (hue < 0.0f) ? hue + 360.0f : hue;
+        out[i].l = 116.0f * fy - 16.0f;
+        out[i].c = std::sqrt(labA * labA + labB * labB);
+        out[i].h = hue;
+    }
+}
+
+void lchToRgb(const LCh* in, ColorRGB* out, size_t count) {
+    const std::array<float, 256>& thresholds = encodeThresholds();
+    for (size_t i = 0; i < count; i++) {
+        const LCh& c = in[i];
+        const float fy = (c.l + 16.0f) / 116.0f;
+        const float fx = fy + c.c * std::cos(c.h * kRadians) / 500.0f;
+        const float fz = fy - c.c * std::sin(c.h * kRadians) / 200.0f;
+        const float x = labInverseF(fx) * kWhiteX;
+        const float y = labInverseF(fy);
+        const float z = labInverseF(fz) * kWhiteZ;
+        const float r = 3.2404542f * x - 1.5371385f * y - 0.4985314f * z;
+        const float g = -0.9692660f * x + 1.8760108f * y + 0.0415560f * z;
+        const float b = 0.0556434f * x - 0.2040259f * y + 1.0572252f * z;
+        out[i] = ColorRGB(encodeSrgb(thresholds, r), encodeSrgb(thresholds, g), encodeSrgb(thresholds, b));
+    }
+}
+
+}  // namespace colorspace
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+struct ColorRGB;
+
+/**
+ * Batch color-space conversions between ColorRGB and HSV or CIE LCh.
+ *
+ * Hue is in degrees [0, 360) in both spaces; saturation and value are in
+ * [0, 1]; LCh uses L* in [0, 100] and the sRGB D65 white point. The kernels
+ * work on arrays with no data-dependent branches, so the compiler can
+ * vectorize them on hosts and they stay cheap on MCUs without SIMD. RGB
+ * results are rounded to the nearest 8-bit step and clamped to the gamut.
+ */
+namespace colorspace {
+
+struct HSV {
+    float h;
+    float s;
+    float v;
+};
+
+struct LCh {
+    float l;
+    float c;
+    float h;
+};
+
+// The helpers below avoid comparisons: with the default trapping-math rules
+// compilers keep float compares as branches, which blocks vectorization.
+
+// floor() through an integer conversion, which compilers keep inline where
+// std::floor becomes a libm call. Valid for |x| < 2^31.
+inline float fastFloor(float x) {
+    const float truncated = static_cast<float>(static_cast<int32_t>(x));
+    return truncated - ((truncated > x) ? 1.0f : 0.0f);
+}
+
+// max(x, 0) and clamp(x, 0, 1) from fabs, which is a sign-bit mask.
+inline float positivePart(float x) {
+    return 0.5f * (x + std::fabs(x));
+}
+
+inline float clampUnit(float x) {
+    return 1.0f - positivePart(1.0f - positivePart(x));
+}
+
+// One channel of HSV -> RGB in [0, 1] for n = 5 (R), 3 (G) or 1 (B):
+// v - v*s*clamp(min(k, 4 - k), 0, 1) with k = (n + h/60) mod 6. The offset
+// keeps k positive for hues down to -36000 degrees, so truncation is the mod.
+inline float hsvChannel(float n, float h, float s, float v) {
+    float k = n + h * (1.0f / 60.0f) + 600.0f;
+    k -= 6.0f * static_cast<float>(static_cast<int32_t>(k * (1.0f / 6.0f)));
+    return v - v * s * clampUnit(2.0f - std::fabs(k - 2.0f));
+}
+
+inline uint8_t unitToByte(float unit) {
+    return static_cast<uint8_t>(static_cast<int32_t>(clampUnit(unit) * 255.0f + 0.5f));
+}
+
+// Signed difference to the nearest equivalent of `to`, in [-180, 180).
+inline float hueDelta(float from, float to) {
+    const float delta = to - from;
+    return delta - 360.0f * fastFloor(delta * (1.0f / 360.0f) + 0.5f);
+}
+
+void rgbToHsv(const ColorRGB* in, HSV* out, size_t count);
+void hsvToRgb(const HSV* in, ColorRGB* out, size_t count);
+void rgbToLch(const ColorRGB* in, LCh* out, size_t count);
+void lchToRgb(const LCh* in, ColorRGB* out, size_t count);
+
+}  // namespace colorspace
@@ -13,7 +13,6 @@ constexpr uint8_t kMaxNotesSet = 7;
 constexpr uint8_t kConnectionMaxMult = 10;
 constexpr uint16_t kConnectionMaxLights = 340;
 constexpr uint16_t kConnectionMaxLeds = 48;
-constexpr uint8_t kOutPortsMemory = 3;
 
 constexpr int8_t kRandomModel = -1;
 constexpr int8_t kRandomSpeed = -1;
@@ -59,10 +58,6 @@ constexpr uint8_t kFullBrightness = 255;
 #define CONNECTION_MAX_LEDS lightgraph::core::kConnectionMaxLeds
 #endif
 
-#ifndef OUT_PORTS_MEMORY
-#define OUT_PORTS_MEMORY lightgraph::core::kOutPortsMemory
-#endif
-
 #ifndef RANDOM_MODEL
 #define RANDOM_MODEL lightgraph::core::kRandomModel
 #endif
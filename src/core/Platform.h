@@ -117,7 +117,6 @@ inline void lgLogPrintf(const char* format, ...) {
 #define LG_LOGF(...) lgLogPrintf(__VA_ARGS__)
 #define LG_LOGLN(...) lgLogPrintln(__VA_ARGS__)
 
-#define LG_RANDOM(...) random(__VA_ARGS__)
 #define LG_STRING String
 
 #ifndef MIN
@@ -135,7 +134,6 @@ inline void lgLogPrintf(const char* format, ...) {
 #define LG_LOG(...) ofLog(OF_LOG_WARNING, __VA_ARGS__)
 #define LG_LOGF(...) ofLog(OF_LOG_WARNING, __VA_ARGS__)
 #define LG_LOGLN ofLogWarning
-#define LG_RANDOM ofRandom
 #define LG_STRING std::string
 
 #endif
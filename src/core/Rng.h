@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+// Seeded pseudo-random generator (xoshiro128**).
+//
+// Every runtime context owns one, and every active LightList owns a stream
+// seeded from it, so a show is reproducible from its seed and never touches
+// hidden global state. Only 32-bit operations are used in the generator
+// itself, which keeps it cheap on the microcontroller targets.
+class LightgraphRng {
+  public:
+    LightgraphRng() { seed(0); }
+    explicit LightgraphRng(uint64_t value) { seed(value); }
+
+    // Any value, including 0, yields a valid non-zero state.
+    void seed(uint64_t value) {
+        // splitmix64 spreads the seed over the whole state.
+        for (uint8_t i = 0; i < 2; i++) {
+            value += 0x9E3779B97F4A7C15ull;
+            uint64_t z = value;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            s_[i * 2] = static_cast<uint32_t>(z);
+            s_[i * 2 + 1] = static_cast<uint32_t>(z >> 32);
+        }
+    }
+
+    uint32_t next() {
+        const uint32_t result = rotl(s_[1] * 5u, 7) * 9u;
+        const uint32_t t = s_[1] << 9;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 11);
+        return result;
+    }
+
+    uint64_t next64() {
+        const uint64_t high = next();
+        return (high << 32) | next();
+    }
+
+    // Uniform integer in [0, range); 0 when range is 0. Uses the
+    // multiply-shift reduction, whose bias is below range / 2^32.
+    uint32_t below(uint32_t range) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * range) >> 32);
+    }
+
+    // Uniform float in [0, max).
+    float uniform(float max) {
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f) * max;
+    }
+
+    bool operator==(const LightgraphRng& other) const {
+        return s_[0] == other.s_[0] && s_[1] == other.s_[1] &&
+               s_[2] == other.s_[2] && s_[3] == other.s_[3];
+    }
+    bool operator!=(const LightgraphRng& other) const {
+        return !(*this == other);
+    }
+
+  private:
+    static uint32_t rotl(uint32_t x, int k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    uint32_t s_[4];
+};
@@ -5,18 +5,16 @@
 #include <cstdint>
 
 #include "../Random.h"
+#include "ColorSpace.h"
 
 struct ColorRGB {
+    // ofxColorTheory works on ColorTheoryRGB (src/rendering/ColorTheory.h),
+    // so a color is just its three channels.
     uint8_t R;
     uint8_t G;
     uint8_t B;
 
-    // For compatibility with ColorUtil template interface.
-    uint8_t r;
-    uint8_t g;
-    uint8_t b;
-
-    ColorRGB(uint8_t r, uint8_t g, uint8_t b) : R(r), G(g), B(b), r(r), g(g), b(b) {}
+    ColorRGB(uint8_t r, uint8_t g, uint8_t b) : R(r), G(g), B(b) {}
 
     explicit ColorRGB(uint32_t rgb) {
         set(rgb);
@@ -42,9 +40,6 @@ struct ColorRGB {
         R = (rgb >> 16) & 0xFF;
         G = (rgb >> 8) & 0xFF;
         B = rgb & 0xFF;
-        r = R;
-        g = G;
-        b = B;
     }
 
     void setRandom() {
@@ -56,46 +51,9 @@ struct ColorRGB {
         const float sf = s / 255.0f;
         const float vf = v / 255.0f;
 
-        const float c = vf * sf;
-        const float x = c * (1 - std::fabs(std::fmod(hf / 60.0f, 2) - 1));
-        const float m = vf - c;
-
-        float rf;
-        float gf;
-        float bf;
-
-        if (hf < 60) {
-            rf = c;
-            gf = x;
-            bf = 0;
-        } else if (hf < 120) {
-            rf = x;
-            gf = c;
-            bf = 0;
-        } else if (hf < 180) {
-            rf = 0;
-            gf = c;
-            bf = x;
-        } else if (hf < 240) {
-            rf = 0;
-            gf = x;
-            bf = c;
-        } else if (hf < 300) {
-            rf = x;
-            gf = 0;
-            bf = c;
-        } else {
-            rf = c;
-            gf = 0;
-            bf = x;
-        }
-
-        R = static_cast<uint8_t>((rf + m) * 255);
-        G = static_cast<uint8_t>((gf + m) * 255);
-        B = static_cast<uint8_t>((bf + m) * 255);
-        r = R;
-        g = G;
-        b = B;
+        R = colorspace::unitToByte(colorspace::hsvChannel(5.0f, hf, sf, vf));
+        G = colorspace::unitToByte(colorspace::hsvChannel(3.0f, hf, sf, vf));
+        B = colorspace::unitToByte(colorspace::hsvChannel(1.0f, hf, sf, vf));
     }
 
     inline static uint8_t elementDim(uint8_t value, uint8_t ratio) {
@@ -163,9 +121,6 @@ struct ColorRGB {
         float h = hue / 255.0f * 360.0f;
         if (s == 0) {
             R = G = B = static_cast<uint8_t>(v * 255);
-            r = R;
-            g = G;
-            b = B;
             return;
         }
 
@@ -208,10 +163,6 @@ struct ColorRGB {
                 B = static_cast<uint8_t>(q * 255);
                 break;
         }
-
-        r = R;
-        g = G;
-        b = B;
     }
 
     void setSaturation(float saturation) {
@@ -233,9 +184,6 @@ struct ColorRGB {
 
         if (s == 0) {
             R = G = B = static_cast<uint8_t>(v * 255);
-            r = R;
-            g = G;
-            b = B;
             return;
         }
 
@@ -278,10 +226,6 @@ struct ColorRGB {
                 B = static_cast<uint8_t>(q * 255);
                 break;
         }
-
-        r = R;
-        g = G;
-        b = B;
     }
 
     static ColorRGB fromHsb(float hue, float saturation, float brightness) {
@@ -303,6 +247,8 @@ struct ColorRGB {
     }
 };
 
+static_assert(sizeof(ColorRGB) == 3, "ColorRGB is stored per light and per palette entry");
+
 enum Groups {
     GROUP1 = 1,
     GROUP2 = 2,
@@ -1,8 +1,5 @@
 #include "TopologyPixels.h"
 
-#include <array>
-#include <limits>
-
 #include "../core/Platform.h"
 #include "../topology/TopologyObject.h"
 
@@ -49,8 +46,6 @@ void TopologyPixels::refresh() {
   allocateBuffers();
 
   const uint16_t pixelCount = object.pixelCount;
-  constexpr size_t kPortIdCount = static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1u;
-  std::array<Port*, kPortIdCount> ports{};
 
   for (uint8_t i = 0; i < MAX_GROUPS; i++) {
     for (uint32_t j = 0; j < object.inter[i].size(); j++) {
@@ -65,16 +60,6 @@ void TopologyPixels::refresh() {
           static_cast<uint16_t>(intersection->bottomPixel) < pixelCount) {
         interPixels[intersection->bottomPixel] = true;
       }
-      for (uint8_t k = 0; k < intersection->numPorts; k++) {
-        Port* port = intersection->ports[k];
-        if (port == nullptr) {
-          continue;
-        }
-        const size_t portId = port->id;
-        if (portId < ports.size()) {
-          ports[portId] = port;
-        }
-      }
     }
 
     for (uint32_t j = 0; j < object.conn[i].size(); j++) {
@@ -97,11 +82,7 @@ void TopologyPixels::refresh() {
       continue;
     }
     for (const auto& entry : model->weights) {
-      const size_t portId = entry.first;
-      if (portId >= ports.size()) {
-        continue;
-      }
-      Port* port = ports[portId];
+      Port* port = object.findPortById(entry.first);
       if (port == nullptr || port->intersection == nullptr) {
         continue;
       }
@@ -1,7 +1,7 @@
 #include "Cross.h"
 
 void Cross::setup() {
-    Model::maxWeights = 6;  // One for each connection
+    maxWeights = 6;  // One for each connection
 
     // Add models
     Model* defaultModel = addModel(new Model(C_DEFAULT, 10, GROUP1));
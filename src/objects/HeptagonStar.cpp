@@ -1,7 +1,7 @@
 #include "HeptagonStar.h"
 
 void HeptagonStar::setupLayout(const LayoutDescriptor& descriptor) {
-    Model::maxWeights = kSegmentCount * 4 * 2;
+    maxWeights = kSegmentCount * 4 * 2;
 
     addModel(new Model(M_DEFAULT, 10, GROUP1));
     addModel(new Model(M_STAR, 0, GROUP1));
@@ -76,7 +76,7 @@ uint16_t* HeptagonStar::getMirroredPixels(uint16_t pixel, Owner* mirrorFlipEmitt
     mirrorPixels[0] = 0;
     if (mirrorFlipEmitter != NULL) {
         if (mirrorFlipEmitter->getType() == Owner::TYPE_INTERSECTION) {
-            uint8_t emitterIndex = static_cast<Intersection*>(mirrorFlipEmitter)->id / 2;
+            uint16_t emitterIndex = static_cast<Intersection*>(mirrorFlipEmitter)->id / 2;
             if (emitterIndex < 7) {
                 uint8_t mirrorIndex = ((emitterIndex + (emitterIndex - pathIndex) + 11) % 7);
                 mirrorPixels[i++] = getPixelOnStarSegment(mirrorIndex, 1.0 - progress);
@@ -1,7 +1,7 @@
 #include "Line.h"
 
 void Line::setup() {
-    Model::maxWeights = 2;  // One for bridge, one for physical connection
+    maxWeights = 2;  // One for bridge, one for physical connection
 
     // Add a default model
     addModel(new Model(L_DEFAULT, 10, GROUP1));
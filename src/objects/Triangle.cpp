@@ -1,7 +1,7 @@
 #include "Triangle.h"
 
 void Triangle::setup() {
-    Model::maxWeights = 18;  // One for each physical connection and each bridge
+    maxWeights = 18;  // One for each physical connection and each bridge
 
     // Add models
     Model* defaultModel = addModel(new Model(T_DEFAULT, 10, GROUP1));
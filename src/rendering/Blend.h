@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../core/Types.h"
+
+// Per-channel implementations of the composite blend modes used by
+// State::setFramePixel (everything except NORMAL, ADD and REPLACE, which
+// only touch the accumulators).
+//
+// blendFloat() is the reference path on normalized 0..1 channels.
+// blendFixed() is the integer pipeline selected by LIGHTGRAPH_FIXED_POINT_BLEND:
+// channels are 8.8 fixed point on the 0..255 scale (kFixedOne == 255 << 8),
+// so an 8-bit color converts exactly and no float, divide-by-float or sqrt
+// is needed per light.
+namespace blend {
+
+constexpr int32_t kFixedOne = 255 << 8;
+constexpr int32_t kFixedHalf = kFixedOne / 2;
+
+inline bool isCompositeMode(BlendMode mode) {
+    return mode >= BLEND_MULTIPLY && mode <= BLEND_PIN_LIGHT && mode != BLEND_REPLACE;
+}
+
+inline float blendFloat(BlendMode mode, float base, float top) {
+    switch (mode) {
+    case BLEND_MULTIPLY:
+        return base * top;
+    case BLEND_SCREEN:
+        return 1.0f - (1.0f - base) * (1.0f - top);
+    case BLEND_OVERLAY:
+        return (base < 0.5f) ? (2.0f * base * top) : (1.0f - 2.0f * (1.0f - base) * (1.0f - top));
+    case BLEND_SUBTRACT:
+        return std::max(0.0f, base - top);
+    case BLEND_DIFFERENCE:
+        return std::abs(base - top);
+    case BLEND_EXCLUSION:
+        return base + top - 2.0f * base * top;
+    case BLEND_DODGE:
+        return (top == 1.0f) ? 1.0f : std::min(1.0f, base / (1.0f - top));
+    case BLEND_BURN:
+        return (top == 0.0f) ? 0.0f : std::max(0.0f, 1.0f - (1.0f - base) / top);
+    case BLEND_HARD_LIGHT:
+        return (top < 0.5f) ? (2.0f * top * base) : (1.0f - 2.0f * (1.0f - top) * (1.0f - base));
+    case BLEND_SOFT_LIGHT:
+        if (top < 0.5f) {
+            return base - (1.0f - 2.0f * top) * base * (1.0f - base);
+        }
+        // Evaluated in double, matching the historical unqualified sqrt() call.
+        return static_cast<float>(base + (2.0f * top - 1.0f) *
+                                             (std::sqrt(static_cast<double>(base)) - base));
+    case BLEND_LINEAR_LIGHT:
+        return (top < 0.5f) ? std::max(0.0f, base + 2.0f * top - 1.0f)
+                            : std::min(1.0f, base + 2.0f * (top - 0.5f));
+    case BLEND_VIVID_LIGHT:
+        return (top < 0.5f)
+                   ? (top == 0.0f ? 0.0f : std::max(0.0f, 1.0f - (1.0f - base) / (2.0f * top)))
+                   : (top == 1.0f ? 1.0f : std::min(1.0f, base / (2.0f * (1.0f - top))));
+    case BLEND_PIN_LIGHT:
+        return (top < 0.5f) ? std::min(base, 2.0f * top) : std::max(base, 2.0f * (top - 0.5f));
+    default:
+        return base;
+    }
+}
+
+inline int32_t fixedMul(int32_t a, int32_t b) {
+    return static_cast<int32_t>(
+        (static_cast<uint32_t>(a) * static_cast<uint32_t>(b) + kFixedHalf) / kFixedOne);
+}
+
+// a / b in 8.8, clamped to kFixedOne; callers guarantee b > 0.
+inline int32_t fixedDivClamped(int32_t a, int32_t b) {
+    const uint32_t quotient = static_cast<uint32_t>(a) * kFixedOne / static_cast<uint32_t>(b);
+    return quotient > static_cast<uint32_t>(kFixedOne) ? kFixedOne : static_cast<int32_t>(quotient);
+}
+
+// sqrt(i / 255) in 8.8 for i = 0..256, interpolated by fixedSqrt().
+inline constexpr uint16_t kFixedSqrtTable[257] = {
+    0, 4088, 5781, 7081, 8176, 9141, 10013, 10816, 11563, 12264,
+    12927, 13558, 14161, 14739, 15296, 15833, 16352, 16855, 17344, 17819,
+    18282, 18734, 19174, 19605, 20027, 20440, 20845, 21242, 21632, 22015,
+    22391, 22761, 23125, 23484, 23837, 24185, 24528, 24866, 25200, 25530,
+    25855, 26176, 26493, 26807, 27117, 27423, 27726, 28026, 28322, 28616,
+    28906, 29194, 29479, 29761, 30040, 30317, 30592, 30864, 31133, 31400,
+    31665, 31928, 32189, 32447, 32704, 32958, 33211, 33462, 33710, 33957,
+    34203, 34446, 34688, 34928, 35166, 35403, 35638, 35872, 36104, 36335,
+    36564, 36792, 37018, 37243, 37467, 37689, 37910, 38130, 38349, 38566,
+    38782, 38997, 39211, 39423, 39635, 39845, 40054, 40262, 40469, 40675,
+    40880, 41084, 41287, 41489, 41690, 41889, 42088, 42287, 42484, 42680,
+    42875, 43070, 43263, 43456, 43648, 43839, 44029, 44218, 44407, 44595,
+    44782, 44968, 45153, 45338, 45522, 45705, 45888, 46069, 46250, 46431,
+    46610, 46789, 46967, 47145, 47322, 47498, 47674, 47849, 48023, 48197,
+    48370, 48542, 48714, 48885, 49056, 49226, 49395, 49564, 49733, 49900,
+    50067, 50234, 50400, 50566, 50731, 50895, 51059, 51222, 51385, 51548,
+    51709, 51871, 52032, 52192, 52352, 52511, 52670, 52829, 52986, 53144,
+    53301, 53457, 53614, 53769, 53924, 54079, 54233, 54387, 54541, 54694,
+    54846, 54998, 55150, 55301, 55452, 55603, 55753, 55902, 56052, 56201,
+    56349, 56497, 56645, 56792, 56939, 57086, 57232, 57378, 57523, 57668,
+    57813, 57957, 58101, 58245, 58388, 58531, 58674, 58816, 58958, 59099,
+    59241, 59382, 59522, 59662, 59802, 59942, 60081, 60220, 60358, 60497,
+    60635, 60772, 60910, 61047, 61183, 61320, 61456, 61592, 61727, 61863,
+    61997, 62132, 62266, 62400, 62534, 62668, 62801, 62934, 63066, 63199,
+    63331, 63463, 63594, 63725, 63856, 63987, 64118, 64248, 64378, 64507,
+    64637, 64766, 64895, 65023, 65152, 65280, 65408,
+};
+
+inline int32_t fixedSqrtExact(int32_t value) {
+    // sqrt(v / one) * one == sqrt(v * one); bitwise integer square root.
+    uint32_t op = static_cast<uint32_t>(value) * kFixedOne;
+    uint32_t result = 0;
+    uint32_t bit = 1u << 30;
+    while (bit > op) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (op >= result + bit) {
+            op -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<int32_t>(result);
+}
+
+inline int32_t fixedSqrt(int32_t value) {
+    const int32_t index = value >> 8;
+    if (index == 0) {
+        // sqrt is too steep below one 8-bit step for linear interpolation.
+        return fixedSqrtExact(value);
+    }
+    const int32_t low = kFixedSqrtTable[index];
+    const int32_t high = kFixedSqrtTable[index + 1];
+    return low + (((high - low) * (value & 0xFF) + 128) >> 8);
+}
+
+inline int32_t clampFixed(int32_t value) {
+    return value < 0 ? 0 : (value > kFixedOne ? kFixedOne : value);
+}
+
+// Averaged accumulator (sum / div) as 8.8, saturated at full scale.
+inline int32_t toFixedAverage(uint16_t accumulated, uint8_t div) {
+    const uint32_t average = (static_cast<uint32_t>(accumulated) << 8) / div;
+    return average > static_cast<uint32_t>(kFixedOne) ? kFixedOne : static_cast<int32_t>(average);
+}
+
+inline int32_t toFixed(uint8_t channel) {
+    return static_cast<int32_t>(channel) << 8;
+}
+
+// Back to an accumulator holding `div` contributions, truncating like the float path.
+inline uint16_t toAccumulator(int32_t value, uint8_t div) {
+    return static_cast<uint16_t>((static_cast<uint32_t>(value) * div) >> 8);
+}
+
+inline int32_t blendFixed(BlendMode mode, int32_t base, int32_t top) {
+    switch (mode) {
+    case BLEND_MULTIPLY:
+        return fixedMul(base, top);
+    case BLEND_SCREEN:
+        return kFixedOne - fixedMul(kFixedOne - base, kFixedOne - top);
+    case BLEND_OVERLAY:
+        return (base < kFixedHalf) ? clampFixed(2 * fixedMul(base, top))
+                                   : clampFixed(kFixedOne - 2 * fixedMul(kFixedOne - base, kFixedOne - top));
+    case BLEND_SUBTRACT:
+        return std::max<int32_t>(0, base - top);
+    case BLEND_DIFFERENCE:
+        return base > top ? base - top : top - base;
+    case BLEND_EXCLUSION:
+        return clampFixed(base + top - 2 * fixedMul(base, top));
+    case BLEND_DODGE:
+        return (top == kFixedOne) ? kFixedOne : fixedDivClamped(base, kFixedOne - top);
+    case BLEND_BURN:
+        return (top == 0) ? 0 : kFixedOne - fixedDivClamped(kFixedOne - base, top);
+    case BLEND_HARD_LIGHT:
+        return (top < kFixedHalf) ? clampFixed(2 * fixedMul(top, base))
+                                  : clampFixed(kFixedOne - 2 * fixedMul(kFixedOne - top, kFixedOne - base));
+    case BLEND_SOFT_LIGHT:
+        return (top < kFixedHalf)
+                   ? clampFixed(base - fixedMul(fixedMul(kFixedOne - 2 * top, base), kFixedOne - base))
+                   : clampFixed(base + fixedMul(2 * top - kFixedOne, fixedSqrt(base) - base));
+    case BLEND_LINEAR_LIGHT:
+        return clampFixed(base + 2 * top - kFixedOne);
+    case BLEND_VIVID_LIGHT:
+        return (top < kFixedHalf)
+                   ? (top == 0 ? 0 : kFixedOne - fixedDivClamped(kFixedOne - base, 2 * top))
+                   : (top == kFixedOne ? kFixedOne : fixedDivClamped(base, 2 * (kFixedOne - top)));
+    case BLEND_PIN_LIGHT:
+        return (top < kFixedHalf) ? std::min(base, 2 * top) : std::max(base, 2 * (top - kFixedHalf));
+    default:
+        return base;
+    }
+}
+
+} // namespace blend
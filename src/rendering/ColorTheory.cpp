@@ -8,21 +8,21 @@
 #include "../../vendor/ofxColorTheory/src/Rules/Triad.h"
 #include "../../vendor/ofxColorTheory/src/ColorWheelSchemes.h"
 
-#include "../core/Types.h"
+#include "ColorTheory.h"
 
 namespace ofxColorTheory {
 
-template class Analogous_<ColorRGB>;
-template class Complementary_<ColorRGB>;
-template class Compound_<ColorRGB>;
-template class FlippedCompound_<ColorRGB>;
-template class Monochrome_<ColorRGB>;
-template class SplitComplementary_<ColorRGB>;
-template class Tetrad_<ColorRGB>;
-template class Triad_<ColorRGB>;
+template class Analogous_<ColorTheoryRGB>;
+template class Complementary_<ColorTheoryRGB>;
+template class Compound_<ColorTheoryRGB>;
+template class FlippedCompound_<ColorTheoryRGB>;
+template class Monochrome_<ColorTheoryRGB>;
+template class SplitComplementary_<ColorTheoryRGB>;
+template class Tetrad_<ColorTheoryRGB>;
+template class Triad_<ColorTheoryRGB>;
 
 template<>
-const std::vector<std::shared_ptr<ColorWheelScheme_<ColorRGB>>> ColorWheelSchemes_<ColorRGB>::SCHEMES =
-    ColorWheelSchemes_<ColorRGB>::createColorSchemes();
+const std::vector<std::shared_ptr<ColorWheelScheme_<ColorTheoryRGB>>> ColorWheelSchemes_<ColorTheoryRGB>::SCHEMES =
+    ColorWheelSchemes_<ColorTheoryRGB>::createColorSchemes();
 
 }  // namespace ofxColorTheory
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../core/Types.h"
+
+/**
+ * ColorTheoryRGB - the color type the ofxColorTheory templates are built on
+ *
+ * The ColorUtil templates read and write lowercase r/g/b members and call the
+ * HSB helpers below. ColorRGB only stores R/G/B so it stays 3 bytes per light
+ * and palette entry; Palette converts to and from this type around its calls
+ * into ColorScheme_ and ColorWheelSchemes_. The HSB math is ColorRGB's.
+ */
+struct ColorTheoryRGB {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+
+    ColorTheoryRGB() = default;
+    ColorTheoryRGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
+    ColorTheoryRGB(const ColorRGB& color) : r(color.R), g(color.G), b(color.B) {}
+
+    ColorRGB toRGB() const {
+        return ColorRGB(r, g, b);
+    }
+
+    float getHueAngle() const {
+        return toRGB().getHueAngle();
+    }
+    float getHue() const {
+        return toRGB().getHue();
+    }
+    float getSaturation() const {
+        return toRGB().getSaturation();
+    }
+    float getBrightness() const {
+        return toRGB().getBrightness();
+    }
+
+    void setHue(float hue) {
+        update([hue](ColorRGB& color) { color.setHue(hue); });
+    }
+    void setSaturation(float saturation) {
+        update([saturation](ColorRGB& color) { color.setSaturation(saturation); });
+    }
+    void setBrightness(float brightness) {
+        update([brightness](ColorRGB& color) { color.setBrightness(brightness); });
+    }
+    void setHsb(float hue, float saturation, float brightness) {
+        update([=](ColorRGB& color) { color.setHsb(hue, saturation, brightness); });
+    }
+
+    static ColorTheoryRGB fromHsb(float hue, float saturation, float brightness) {
+        return ColorRGB::fromHsb(hue, saturation, brightness);
+    }
+
+    ColorTheoryRGB lerp(const ColorTheoryRGB& target, float amt) const {
+        return toRGB().lerp(target.toRGB(), amt);
+    }
+
+    static float limit() {
+        return ColorRGB::limit();
+    }
+
+  private:
+    template <typename Edit>
+    void update(Edit edit) {
+        ColorRGB color = toRGB();
+        edit(color);
+        *this = color;
+    }
+};
+
+namespace colortheory {
+
+inline void toColorTheory(const std::vector<ColorRGB>& in, std::vector<ColorTheoryRGB>& out) {
+    out.assign(in.begin(), in.end());
+}
+
+inline void fromColorTheory(const std::vector<ColorTheoryRGB>& in, std::vector<ColorRGB>& out) {
+    out.clear();
+    out.reserve(in.size());
+    for (const ColorTheoryRGB& color : in) {
+        out.push_back(color.toRGB());
+    }
+}
+
+}  // namespace colortheory
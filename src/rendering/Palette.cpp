@@ -1,63 +1,142 @@
 #include "Palette.h"
+#include "ColorTheory.h"
+#include "../core/ColorSpace.h"
+#include "../../vendor/ofxColorTheory/src/ColorScheme.h"
 #include "../../vendor/ofxColorTheory/src/ColorWheelSchemes.h"
 
 namespace ofxColorTheory {
-extern template const std::vector<std::shared_ptr<ColorWheelScheme_<ColorRGB>>> ColorWheelSchemes_<ColorRGB>::SCHEMES;
+extern template const std::vector<std::shared_ptr<ColorWheelScheme_<ColorTheoryRGB>>> ColorWheelSchemes_<ColorTheoryRGB>::SCHEMES;
 }  // namespace ofxColorTheory
 
 ColorRGB Palette::noColor = ColorRGB(0, 0, 0);
 
-Palette::Palette() : colorRule(-1), rgbCacheDirty(true) {
+namespace {
+
+// Blend two stops along the shorter hue arc. An achromatic stop has no hue
+// of its own and takes its neighbour's, so fades to gray keep their hue.
+inline colorspace::HSV lerpStop(const colorspace::HSV& a, const colorspace::HSV& b, float f) {
+    const float hueA = (a.s > 0.0f) ? a.h : b.h;
+    const float hueB = (b.s > 0.0f) ? b.h : hueA;
+    return {hueA + colorspace::hueDelta(hueA, hueB) * f, a.s + (b.s - a.s) * f, a.v + (b.v - a.v) * f};
+}
+
+inline colorspace::LCh lerpStop(const colorspace::LCh& a, const colorspace::LCh& b, float f) {
+    const float hueA = (a.c > 1e-3f) ? a.h : b.h;
+    const float hueB = (b.c > 1e-3f) ? b.h : hueA;
+    return {a.l + (b.l - a.l) * f, a.c + (b.c - a.c) * f, hueA + colorspace::hueDelta(hueA, hueB) * f};
+}
+
+// Converts the stops once, blends `count` evenly spaced samples in Space and
+// converts them back in one batch.
+template <typename Space>
+void interpolateStops(const std::vector<ColorRGB>& rgb,
+                      const std::vector<float>& positions,
+                      uint16_t count,
+                      std::vector<ColorRGB>& out,
+                      void (*toSpace)(const ColorRGB*, Space*, size_t),
+                      void (*fromSpace)(const Space*, ColorRGB*, size_t)) {
+    const size_t n = rgb.size();
+    std::vector<Space> stops(n);
+    toSpace(rgb.data(), stops.data(), n);
+
+    const bool hasPositions = positions.size() == n;
+    const auto stopPosition = [&](size_t k) {
+        return hasPositions ? positions[k] : static_cast<float>(k) / static_cast<float>(n - 1);
+    };
+
+    std::vector<Space> samples(count);
+    size_t k = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        const float t = (count > 1) ? static_cast<float>(i) / static_cast<float>(count - 1) : 0.0f;
+        while (k + 2 < n && t > stopPosition(k + 1)) {
+            k++;
+        }
+        const float from = stopPosition(k);
+        const float to = stopPosition(k + 1);
+        const float f = (to > from) ? std::max(0.0f, std::min((t - from) / (to - from), 1.0f))
+                                    : (t > from ? 1.0f : 0.0f);
+        samples[i] = lerpStop(stops[k], stops[k + 1], f);
+    }
+
+    out.resize(count);
+    fromSpace(samples.data(), out.data(), count);
+}
+
+}  // namespace
+
+Palette::Palette() {
     // Initialize with empty palette
 }
 
-Palette::Palette(const std::vector<int64_t>& colors) : colors(colors), colorRule(-1), rgbCacheDirty(true) {
-    generateDefaultPositions();
+Palette::Palette(const std::vector<int64_t>& colors) {
+    Data& d = edit();
+    d.colors = colors;
+    generateDefaultPositions(d);
+    colorsChanged(d);
 }
 
-Palette::Palette(const std::vector<int64_t>& colors, const std::vector<float>& positions) 
-    : colors(colors), colorRule(-1), rgbCacheDirty(true) {
+Palette::Palette(const std::vector<int64_t>& colors, const std::vector<float>& positions) {
+    Data& d = edit();
+    d.colors = colors;
     
     // Use provided positions if they match the number of colors
     if (positions.size() == colors.size()) {
-        this->positions = positions;
+        d.positions = positions;
     } else {
-        generateDefaultPositions();
+        generateDefaultPositions(d);
     }
+    colorsChanged(d);
     
     // Sort colors by position
     sortByPosition();
 }
 
+const Palette::Data& Palette::data() const {
+    static const Data empty;
+    return data_ ? *data_ : empty;
+}
+
+Palette::Data& Palette::edit() {
+    if (!data_) {
+        data_ = std::make_shared<Data>();
+    } else if (data_.use_count() > 1) {
+        data_ = std::make_shared<Data>(*data_);
+    }
+    return *data_;
+}
+
 void Palette::addColor(int64_t color, float position) {
-    colors.push_back(color);
+    Data& d = edit();
+    d.colors.push_back(color);
     
     // If position is -1 (default), calculate a position
     if (position < 0.0f) {
         // If it's the first color, position at 0.0
-        if (colors.size() == 1) {
-            positions.push_back(0.0f);
-        } else if (colors.size() > 1) {
+        if (d.colors.size() == 1) {
+            d.positions.push_back(0.0f);
+        } else if (d.colors.size() > 1) {
             // Otherwise, position at the end (1.0)
-            positions.push_back(1.0f);
+            d.positions.push_back(1.0f);
         }
     } else {
         // Use the provided position
-        positions.push_back(std::max(0.0f, std::min(1.0f, position)));
+        d.positions.push_back(std::max(0.0f, std::min(1.0f, position)));
     }
     
-    rgbCacheDirty = true;
+    colorsChanged(d);
 }
 
 void Palette::removeColor(size_t index) {
-    if (index < colors.size()) {
-        colors.erase(colors.begin() + index);
-        positions.erase(positions.begin() + index);
-        rgbCacheDirty = true;
+    if (index < size()) {
+        Data& d = edit();
+        d.colors.erase(d.colors.begin() + index);
+        d.positions.erase(d.positions.begin() + index);
+        colorsChanged(d);
     }
 }
 
 void Palette::removeColor(int64_t color) {
+    const std::vector<int64_t>& colors = getColors();
     for (size_t i = 0; i < colors.size(); i++) {
         if (colors[i] == color) {
             removeColor(i);
@@ -67,28 +146,34 @@ void Palette::removeColor(int64_t color) {
 }
 
 void Palette::setColor(size_t index, int64_t color) {
-    if (index < colors.size()) {
-        colors[index] = color;
-        rgbCacheDirty = true;
+    if (index < size()) {
+        Data& d = edit();
+        d.colors[index] = color;
+        colorsChanged(d);
     }
 }
 
 void Palette::setPosition(size_t index, float position) {
-    if (index < positions.size()) {
-        positions[index] = std::max(0.0f, std::min(1.0f, position));
-        rgbCacheDirty = true;
+    if (index < data().positions.size()) {
+        edit().positions[index] = std::max(0.0f, std::min(1.0f, position));
     }
 }
 
 void Palette::sortByPosition() {
-    if (colors.size() != positions.size() || colors.empty()) {
+    const Data& current = data();
+    if (current.colors.size() != current.positions.size() || current.colors.empty()) {
         return;
     }
+    if (std::is_sorted(current.positions.begin(), current.positions.end())) {
+        return;
+    }
+    
+    Data& d = edit();
     
     // Create pairs of (position, color)
     std::vector<std::pair<float, int64_t>> pairs;
-    for (size_t i = 0; i < colors.size(); i++) {
-        pairs.push_back(std::make_pair(positions[i], colors[i]));
+    for (size_t i = 0; i < d.colors.size(); i++) {
+        pairs.push_back(std::make_pair(d.positions[i], d.colors[i]));
     }
     
     // Sort by position
@@ -98,62 +183,141 @@ void Palette::sortByPosition() {
               });
     
     // Rebuild the sorted vectors
-    colors.clear();
-    positions.clear();
+    d.colors.clear();
+    d.positions.clear();
     
     for (const auto& pair : pairs) {
-        positions.push_back(pair.first);
-        colors.push_back(pair.second);
+        d.positions.push_back(pair.first);
+        d.colors.push_back(pair.second);
     }
     
-    rgbCacheDirty = true;
+    colorsChanged(d);
 }
 
 void Palette::clear() {
-    colors.clear();
-    positions.clear();
+    Data& d = edit();
+    d.colors.clear();
+    d.positions.clear();
+    colorsChanged(d);
     rgbColors.clear();
-    rgbCacheDirty = true;
 }
 
 const std::vector<int64_t>& Palette::getColors() const {
-    return colors;
+    return data().colors;
 }
 
 const std::vector<float>& Palette::getPositions() const {
-    return positions;
+    return data().positions;
 }
 
-const std::vector<ColorRGB>& Palette::getRGBColors() {
+const std::vector<ColorRGB>& Palette::getRGBColors() const {
+    const Data& d = data();
+    if (d.fixed) {
+        return d.rgb;
+    }
     if (rgbCacheDirty) {
         updateRGBColors();
     }
     return rgbColors;
 }
 
+std::vector<ColorRGB> Palette::interpolate(uint16_t maxColors) const {
+    std::vector<ColorRGB> result;
+    interpolateInto(result, maxColors);
+    return result;
+}
+
+void Palette::interpolateInto(std::vector<ColorRGB>& out, uint16_t maxColors) const {
+    const std::vector<ColorRGB>& rgb = getRGBColors();
+    const int8_t mode = getInterpolationMode();
+    if (mode < 0 || rgb.size() < 2) {
+        out.assign(rgb.begin(), rgb.end());
+        return;
+    }
+    // HSB and CIELCh gradients run on the batch color-space kernels; RGB
+    // blending needs no conversion and stays with ofxColorTheory.
+    if (mode == 1) {
+        interpolateStops<colorspace::HSV>(rgb, data_->positions, maxColors, out,
+                                          &colorspace::rgbToHsv, &colorspace::hsvToRgb);
+        return;
+    }
+    if (mode == 2) {
+        interpolateStops<colorspace::LCh>(rgb, data_->positions, maxColors, out,
+                                          &colorspace::rgbToLch, &colorspace::lchToRgb);
+        return;
+    }
+    std::vector<ColorTheoryRGB> colors;
+    colortheory::toColorTheory(rgb, colors);
+    ofxColorTheory::ColorScheme_<ColorTheoryRGB> basicScheme(colors);
+    colortheory::fromColorTheory(basicScheme.interpolate(maxColors, mode, &data_->positions), out);
+}
+
+bool Palette::hasFixedColors() const {
+    return data().fixed;
+}
+
+uint32_t Palette::contentHash() const {
+    // FNV-1a over the raw color, position and mode bytes.
+    uint32_t hash = 2166136261u;
+    const auto mix = [&hash](const void* bytes, size_t count) {
+        const uint8_t* p = static_cast<const uint8_t*>(bytes);
+        for (size_t i = 0; i < count; i++) {
+            hash = (hash ^ p[i]) * 16777619u;
+        }
+    };
+    const Data& d = data();
+    mix(d.colors.data(), d.colors.size() * sizeof(int64_t));
+    mix(d.positions.data(), d.positions.size() * sizeof(float));
+    mix(&d.interpolationMode, sizeof(d.interpolationMode));
+    return hash;
+}
+
+bool Palette::sameContents(const Palette& other) const {
+    if (data_ == other.data_) {
+        return true;
+    }
+    const Data& a = data();
+    const Data& b = other.data();
+    return a.interpolationMode == b.interpolationMode &&
+        a.colors == b.colors && a.positions == b.positions;
+}
+
 void Palette::setColors(const std::vector<int64_t>& newColors) {
-    colors = newColors;
+    Data& d = edit();
+    d.colors = newColors;
     
     // Update positions if the number of colors has changed
-    if (positions.size() != colors.size()) {
-        generateDefaultPositions();
+    if (d.positions.size() != d.colors.size()) {
+        generateDefaultPositions(d);
     }
     
-    rgbCacheDirty = true;
+    colorsChanged(d);
 }
 
 void Palette::setColors(const std::vector<ColorRGB>& newColors) {
-    colors.clear();
+    Data& d = edit();
+    d.colors.clear();
     for (size_t i = 0; i < newColors.size(); i++) {
-        colors.push_back(newColors[i].get());
+        d.colors.push_back(newColors[i].get());
     }
     
     // Update positions if the number of colors has changed
-    if (positions.size() != colors.size()) {
-        generateDefaultPositions();
+    if (d.positions.size() != d.colors.size()) {
+        generateDefaultPositions(d);
     }
     
-    rgbCacheDirty = true;
+    colorsChanged(d);
+}
+
+void Palette::setColors(int64_t color) {
+    Data& d = edit();
+    d.colors.assign(1, color);
+
+    if (d.positions.size() != 1) {
+        generateDefaultPositions(d);
+    }
+
+    colorsChanged(d);
 }
 
 void Palette::setPositions(const std::vector<float>& newPositions) {
@@ -164,61 +328,64 @@ void Palette::setPositions(const std::vector<float>& newPositions) {
     }
     
     // Only update if the number of positions matches the number of colors
-    if (validatedPositions.size() == colors.size()) {
-        positions = validatedPositions;
-        rgbCacheDirty = true;
-    } else if (colors.size() > 0) {
+    if (validatedPositions.size() == size()) {
+        edit().positions = validatedPositions;
+    } else if (size() > 0) {
         // If we have colors but the positions don't match,
         // generate default positions instead
-        generateDefaultPositions();
+        generateDefaultPositions(edit());
     }
 }
 
 size_t Palette::size() const {
-    return colors.size();
+    return data().colors.size();
 }
 
 int64_t Palette::operator[](size_t index) const {
+    const std::vector<int64_t>& colors = getColors();
     if (index < colors.size()) {
         return colors[index];
     }
     return 0; // Default fallback
 }
 
-void Palette::generateDefaultPositions() {
-    positions.clear();
+void Palette::generateDefaultPositions(Data& d) {
+    d.positions.clear();
     
     // Generate evenly spaced positions from 0 to 1
-    if (colors.size() == 1) {
-        positions.push_back(0.0f);
-    } else if (colors.size() > 1) {
-        for (size_t i = 0; i < colors.size(); i++) {
-            positions.push_back(static_cast<float>(i) / (colors.size() - 1));
+    if (d.colors.size() == 1) {
+        d.positions.push_back(0.0f);
+    } else if (d.colors.size() > 1) {
+        for (size_t i = 0; i < d.colors.size(); i++) {
+            d.positions.push_back(static_cast<float>(i) / (d.colors.size() - 1));
         }
     }
 }
 
-void Palette::updateRGBColors() {
+void Palette::updateRGBColors() const {
     rgbColors.clear();
-    generateColors();
+    generateColorsInto(rgbColors);
     rgbCacheDirty = false;
 }
 
 int8_t Palette::getColorRule() const {
-    return colorRule;
+    return data().colorRule;
 }
 
 void Palette::setColorRule(int8_t rule) {
-    colorRule = rule;
-    rgbCacheDirty = true;
+    Data& d = edit();
+    d.colorRule = rule;
+    colorsChanged(d);
 }
 
 int8_t Palette::getInterpolationMode() const {
-    return interpolationMode;
+    return data().interpolationMode;
 }
 
 void Palette::setInterpolationMode(int8_t mode) {
-    interpolationMode = mode;
+    if (mode != getInterpolationMode()) {
+        edit().interpolationMode = mode;
+    }
 }
 
 int8_t Palette::getInterMode() const {
@@ -230,25 +397,28 @@ void Palette::setInterMode(int8_t mode) {
 }
 
 int8_t Palette::getWrapMode() const {
-    return wrapMode;
+    return data().wrapMode;
 }
 
 void Palette::setWrapMode(int8_t mode) {
-    wrapMode = mode;
+    if (mode != getWrapMode()) {
+        edit().wrapMode = mode;
+    }
 }
 
 
 float Palette::getSegmentation() const {
-    return segmentation;
+    return data().segmentation;
 }
 
 void Palette::setSegmentation(float seg) {
     // Defensive clamp: invalid, NaN, or non-positive values disable segmentation.
     if (!std::isfinite(seg) || seg <= 0.0f) {
-        segmentation = 0.0f;
-        return;
+        seg = 0.0f;
+    }
+    if (seg != getSegmentation()) {
+        edit().segmentation = seg;
     }
-    segmentation = seg;
 }
 
 inline ColorRGB toRGB(int64_t hex) {
@@ -260,28 +430,45 @@ inline ColorRGB toRGB(int64_t hex) {
     return rgb;
 }
 
+void Palette::colorsChanged(Data& d) {
+    rgbCacheDirty = true;
+    d.fixed = !(d.colorRule >= 0 && d.colorRule <= 7) &&
+        std::find(d.colors.begin(), d.colors.end(), RANDOM_COLOR) == d.colors.end();
+    d.rgb.clear();
+    if (d.fixed) {
+        for (const auto& color : d.colors) {
+            d.rgb.push_back(toRGB(color));
+        }
+    }
+}
+
 void Palette::generateColors() {
+    updateRGBColors();
+}
+
+void Palette::generateColorsInto(std::vector<ColorRGB>& out) const {
+    const Data& d = data();
     // Check if a color rule is selected
-    if (colorRule >= 0 && colorRule <= 7) {
+    if (d.colorRule >= 0 && d.colorRule <= 7) {
         // Use color wheel scheme with rule
-        auto colorScheme = ofxColorTheory::ColorWheelSchemes_<ColorRGB>::get(
-            static_cast<ofxColorTheory::ColorRule>(colorRule));
+        auto colorScheme = ofxColorTheory::ColorWheelSchemes_<ColorTheoryRGB>::get(
+            static_cast<ofxColorTheory::ColorRule>(d.colorRule));
 
         if (colorScheme) {
             colorScheme->getColors().clear();
             
             // Apply the rule to each color in the palette
-            for (const auto& color : colors) {
+            for (const auto& color : d.colors) {
                 colorScheme->setPrimaryColor(toRGB(color));
                 colorScheme->generate();
             }
             
-            rgbColors = colorScheme->getColors();
+            colortheory::fromColorTheory(colorScheme->getColors(), out);
         }
     }
     else {
-        for (const auto& color : colors) {
-            rgbColors.push_back(toRGB(color));
+        for (const auto& color : d.colors) {
+            out.push_back(toRGB(color));
         }
     }
 }
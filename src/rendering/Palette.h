@@ -2,12 +2,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <vector>
 
 #include "../core/Types.h"
 #include "../core/Limits.h"
-#include "../../vendor/ofxColorTheory/src/ColorScheme.h"
-#include "../../vendor/ofxColorTheory/src/ColorWheelSchemes.h"
 
 #define WRAP_NOWRAP -1
 #define WRAP_CLAMP_TO_EDGE 0
@@ -107,19 +106,23 @@ public:
     // Get colors
     const std::vector<int64_t>& getColors() const;
     const std::vector<float>& getPositions() const;
-    const std::vector<ColorRGB>& getRGBColors();
-    std::vector<ColorRGB> interpolate(uint16_t maxColors) {
-        std::vector<ColorRGB> rgbColors = getRGBColors();
-        if (interpolationMode < 0 || rgbColors.size() < 2) {
-            return rgbColors;
-        }
-        ofxColorTheory::ColorScheme_<ColorRGB> basicScheme(rgbColors);
-        return basicScheme.interpolate(maxColors, interpolationMode, &positions);
-    }
+    const std::vector<ColorRGB>& getRGBColors() const;
+    std::vector<ColorRGB> interpolate(uint16_t maxColors) const;
+    // Same as interpolate(), but writes into out so its capacity is reused.
+    void interpolateInto(std::vector<ColorRGB>& out, uint16_t maxColors) const;
+    // True when the colors resolve to the same RGB values every time (no
+    // RANDOM_COLOR stop and no color rule), so interpolated tables can be reused.
+    bool hasFixedColors() const;
+    // Hash of the colors, positions and interpolation mode.
+    uint32_t contentHash() const;
+    // Same colors, positions and interpolation mode.
+    bool sameContents(const Palette& other) const;
     
     // Set colors
     void setColors(const std::vector<int64_t>& colors);
     void setColors(const std::vector<ColorRGB>&);
+    // Single-color palette, reusing the existing storage.
+    void setColors(int64_t color);
     void setPositions(const std::vector<float>& positions);
     
     // Get/set color rule
@@ -148,20 +151,40 @@ public:
     int64_t operator[](size_t index) const;
     
 private:
-    std::vector<int64_t> colors;
-    std::vector<float> positions;
-    mutable std::vector<ColorRGB> rgbColors; // Cache for RGB colors, updated as needed
-    int8_t colorRule = -1;
-    int8_t interpolationMode = 1; // 0 = RGB, 1 = HSB, 2 = CIELCh, -1 = none. Default: HSB
-    int8_t wrapMode = -1; // 0 = clamp to edge, 1 = wrap, 2 = wrapMirror, -1 = none. Default: none
-    float segmentation = 0.0f; // Segmentation value - 0 means no segmentation
+    // Palette contents, shared between copies and cloned on the first write
+    // (copy-on-write), so passing a palette around only bumps a refcount.
+    struct Data {
+        std::vector<int64_t> colors;
+        std::vector<float> positions;
+        int8_t colorRule = -1;
+        int8_t interpolationMode = 1; // 0 = RGB, 1 = HSB, 2 = CIELCh, -1 = none. Default: HSB
+        int8_t wrapMode = -1; // 0 = clamp to edge, 1 = wrap, 2 = wrapMirror, -1 = none. Default: none
+        float segmentation = 0.0f; // Segmentation value - 0 means no segmentation
+        
+        // See hasFixedColors(); rgb then holds the resolved colors.
+        bool fixed = true;
+        std::vector<ColorRGB> rgb;
+    };
+    
+    std::shared_ptr<Data> data_; // Null for a default-constructed palette
+    
+    // Per-copy RGB cache for palettes that are not fixed: each copy keeps the
+    // random colors it resolved, like an independent palette would.
+    mutable std::vector<ColorRGB> rgbColors;
+    mutable bool rgbCacheDirty = true;
+    
+    const Data& data() const;
+    // Unshares data_ if needed and returns it for writing.
+    Data& edit();
     
     // Generate default positions for colors
-    void generateDefaultPositions();
+    static void generateDefaultPositions(Data& data);
     
-    // Update RGB colors cache
-    void updateRGBColors();
+    // Refresh the fixed flag and resolved RGB colors after colors or the
+    // color rule changed.
+    void colorsChanged(Data& data);
     
-    // Flag to track if the RGB cache is dirty
-    mutable bool rgbCacheDirty;
+    // Update RGB colors cache
+    void updateRGBColors() const;
+    void generateColorsInto(std::vector<ColorRGB>& out) const;
 };
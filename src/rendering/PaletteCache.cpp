@@ -0,0 +1,61 @@
+#include "PaletteCache.h"
+
+PaletteCache::PaletteCache(uint8_t capacity) : entries_(capacity) {}
+
+void PaletteCache::interpolate(const Palette& palette, uint16_t count, std::vector<ColorRGB>& out) {
+    // Random stops and color rules resolve differently on every build, and
+    // single colors or mode -1 involve no interpolation to save.
+    if (entries_.empty() || !palette.hasFixedColors() || palette.size() < 2 ||
+        palette.getInterpolationMode() < 0) {
+        palette.interpolateInto(out, count);
+        return;
+    }
+
+    const uint32_t hash = palette.contentHash();
+    const int8_t mode = palette.getInterpolationMode();
+    Entry* victim = &entries_[0];
+    for (Entry& entry : entries_) {
+        if (entry.used && entry.hash == hash && entry.count == count && entry.mode == mode &&
+            entry.palette.sameContents(palette)) {
+            entry.lastUse = ++clock_;
+            hits_++;
+            out.assign(entry.colors.begin(), entry.colors.end());
+            return;
+        }
+        if (!entry.used) {
+            if (victim->used) {
+                victim = &entry;
+            }
+        } else if (victim->used && entry.lastUse < victim->lastUse) {
+            victim = &entry;
+        }
+    }
+
+    misses_++;
+    palette.interpolateInto(victim->colors, count);
+    victim->hash = hash;
+    victim->count = count;
+    victim->mode = mode;
+    victim->used = true;
+    victim->lastUse = ++clock_;
+    victim->palette = palette;
+    out.assign(victim->colors.begin(), victim->colors.end());
+}
+
+void PaletteCache::clear() {
+    for (Entry& entry : entries_) {
+        entry.used = false;
+        entry.palette = Palette();
+        entry.colors.clear();
+    }
+}
+
+uint8_t PaletteCache::size() const {
+    uint8_t used = 0;
+    for (const Entry& entry : entries_) {
+        if (entry.used) {
+            used++;
+        }
+    }
+    return used;
+}
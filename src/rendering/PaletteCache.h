@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Globals.h"
+#include "Palette.h"
+
+/**
+ * PaletteCache - interpolated palette tables of one State
+ *
+ * Keeps up to `capacity` interpolated color tables keyed by palette content
+ * hash, requested count and interpolation mode, evicting the least recently
+ * used one. Lists bound to the cache (LightList::bindPaletteCache) copy their
+ * colors from it, so repeated emits with the same palette and length skip
+ * the color-space math. Palettes with random stops or a color rule, and
+ * palettes that need no interpolation, bypass the cache. Like emission, lookups
+ * happen on the thread that drives the State, not on update workers.
+ */
+class PaletteCache {
+  public:
+    explicit PaletteCache(uint8_t capacity = LIGHTGRAPH_PALETTE_CACHE_CAPACITY);
+
+    PaletteCache(const PaletteCache&) = delete;
+    PaletteCache& operator=(const PaletteCache&) = delete;
+
+    // Writes palette.interpolate(count) into out, from the cache when possible.
+    void interpolate(const Palette& palette, uint16_t count, std::vector<ColorRGB>& out);
+    void clear();
+
+    uint8_t capacity() const {
+        return static_cast<uint8_t>(entries_.size());
+    }
+    uint8_t size() const;
+    // Lookups served from the cache and lookups that interpolated; palettes
+    // that bypass the cache count as neither.
+    uint32_t hits() const {
+        return hits_;
+    }
+    uint32_t misses() const {
+        return misses_;
+    }
+    void resetStats() {
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+  private:
+    struct Entry {
+        uint32_t hash = 0;
+        uint16_t count = 0;
+        int8_t mode = 0;
+        bool used = false;
+        uint32_t lastUse = 0;
+        Palette palette; // shared copy, compared on a hash match
+        std::vector<ColorRGB> colors;
+    };
+
+    std::vector<Entry> entries_;
+    uint32_t clock_ = 0;
+    uint32_t hits_ = 0;
+    uint32_t misses_ = 0;
+};
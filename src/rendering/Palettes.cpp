@@ -355,9 +355,18 @@ uint8_t getPaletteCount() {
     return sizeof(paletteFunctions) / sizeof(paletteFunctions[0]);
 }
 
-// Function to get a palette by index
+// Function to get a palette by index. Presets are built once and handed out
+// as shared copies, so callers can take one per emit without allocating.
 Palette getPalette(uint8_t index) {
     static const uint8_t paletteCount = getPaletteCount();
+    static const std::vector<Palette> presets = [] {
+        std::vector<Palette> palettes;
+        palettes.reserve(paletteCount);
+        for (uint8_t i = 0; i < paletteCount; i++) {
+            palettes.push_back(paletteFunctions[i]());
+        }
+        return palettes;
+    }();
 
     // Ensure index is in bounds
     if (index >= paletteCount) {
@@ -365,5 +374,5 @@ Palette getPalette(uint8_t index) {
     }
 
     // Return the palette
-    return paletteFunctions[index]();
+    return presets[index];
 }
@@ -1,4 +1,5 @@
 #include "Behaviour.h"
+#include "LightKernels.h"
 #include "RuntimeLight.h"
 #include "../core/Platform.h"
 #include "../topology/Model.h"
@@ -6,25 +7,21 @@
 
 uint16_t Behaviour::getBri(const RuntimeLight *light) const {
   if (flags & B_BRI_CONST_NOISE) {
-    return light->runtimeContext().perlinNoise.GetValue(light->getListId() * 10, light->pixel1 * 100) * 255;
+    return light_kernel::nextBri<true>(light, light->getFadeSpeed());
   }
-  return static_cast<uint16_t>(
-      light->bri + lightgraphMotionDistance(light->runtimeContext(), light->getFadeSpeed()));
+  return light_kernel::nextBri<false>(light, light->getFadeSpeed());
 }
 
 float Behaviour::getPosition(RuntimeLight* const light) const {
   if (flags & B_POS_CHANGE_FADE) {
-    if (light->bri >= 511) {
-      light->bri -= 511;
-      return LG_RANDOM(light->getModel()->getMaxLength());
-    }
+    return light_kernel::nextPosition<true>(light, light->getModel(), light->getSpeed());
   }
-  return light->position + lightgraphMotionDistance(light->runtimeContext(), light->getSpeed());
+  return light_kernel::nextPosition<false>(light, nullptr, light->getSpeed());
 }
 
 ColorRGB Behaviour::getColor(const RuntimeLight *light, uint8_t /*group*/) const {
   if (light->getPrev() != NULL) {
     return light->getPrev()->getColor();
   }
-  return ColorRGB(LG_RANDOM(255), LG_RANDOM(255), LG_RANDOM(255));
+  return ColorRGB(Random::below(255), Random::below(255), Random::below(255));
 }
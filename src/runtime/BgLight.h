@@ -14,6 +14,10 @@ class BgLight : public LightList {
 public:
     float offset = 0.0f;
     float position;
+    // Final color (maxBri applied) of every palette index in [0, length),
+    // baked by setPalette/setup so getColor is one lookup per pixel.
+    std::vector<ColorRGB> colorTable;
+    uint8_t colorTableBri = 255;
     
     // Override constructor to avoid allocating lights array
     BgLight() : LightList() {
@@ -46,6 +50,7 @@ public:
         // Just store the pixel count but don't actually create any lights
         this->length = numPixels;
         this->maxBri = maxBri;
+        bakeColorTable();
     }
     
     void reset() override {
@@ -55,7 +60,21 @@ public:
 
     void setPalette(const Palette& newPalette) override {
         palette = newPalette;
-        colors = palette.interpolate(length);
+        interpolateColors(length);
+        bakeColorTable();
+    }
+
+    void bakeColorTable() {
+        colorTable.clear();
+        colorTableBri = maxBri;
+        if (colors.empty()) {
+            return;
+        }
+        colorTable.reserve(length);
+        for (uint32_t i = 0; i < length; i++) {
+            const ColorRGB& color = Palette::wrapColors(i, length, colors, palette.getWrapMode(), palette.getSegmentation());
+            colorTable.push_back(maxBri < 255 ? color.dim(maxBri) : color);
+        }
     }
 
     // Internal time value to use with easing functions
@@ -73,6 +92,12 @@ public:
             return false;
         }
 
+        // maxBri can be assigned directly (e.g. by LayerJsonCodec); rebake
+        // once here so getColor stays a table lookup.
+        if (colorTableBri != maxBri || (!colors.empty() && colorTable.size() != length)) {
+            bakeColorTable();
+        }
+
         internalTime += lightgraphMotionDistance(runtimeContext(), speed);
         
         // Keep the internal time within a reasonable range
@@ -109,7 +134,13 @@ public:
         if (colors.empty()) {
             return Palette::noColor;
         }
-        ColorRGB color = getLightColor(uint32_t(position + pixel) % length);
+        const uint32_t index = uint32_t(position + pixel) % length;
+        if (colorTable.size() == length && colorTableBri == maxBri) {
+            return colorTable[index];
+        }
+        // Palette or brightness changed without setPalette/setup, and update()
+        // has not rebaked yet.
+        ColorRGB color = getLightColor(index);
         if (maxBri < 255) {
             return color.dim(maxBri);
         }
@@ -124,6 +155,7 @@ public:
     void init(uint16_t numPixels) override {
         // Just store the count but don't allocate anything
         this->length = numPixels;
+        bakeColorTable();
     }
     
     float getOffset() const override {
@@ -75,8 +75,7 @@ class EmitParams {
     }
 
     EmitParams(int8_t model, float speed, int64_t color) : model(model), speed(speed) {
-        std::vector<int64_t> colors = {color};
-        palette = Palette(colors);
+        palette.setColors(color);
     }
 
     EmitParams(int8_t model, float speed, const std::vector<int64_t>& colorArray) : model(model), speed(speed), palette(colorArray) {
@@ -132,8 +131,7 @@ class EmitParams {
     }
     
     void setColors(int64_t color) {
-        std::vector<int64_t> colors = {color};
-        palette.setColors(colors);
+        palette.setColors(color);
     }
     
     void setColorPositions(std::vector<float>& positions) {
@@ -0,0 +1,80 @@
+#include "FrameDelta.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "State.h"
+
+namespace {
+
+bool exceedsThreshold(uint8_t previous, uint8_t current, uint8_t threshold) {
+    return std::abs(static_cast<int>(current) - static_cast<int>(previous)) > threshold;
+}
+
+} // namespace
+
+FrameDeltaTracker::FrameDeltaTracker(uint16_t pixelCount)
+    : frame(static_cast<size_t>(pixelCount) * 3u, 0) {
+    litPixels.reserve(pixelCount);
+    candidates.reserve(pixelCount);
+}
+
+void FrameDeltaTracker::reset() {
+    std::fill(frame.begin(), frame.end(), 0);
+    litPixels.clear();
+    fullFrame = true;
+}
+
+uint16_t FrameDeltaTracker::collect(const State& state,
+                                    uint8_t threshold,
+                                    uint8_t maxBrightness,
+                                    std::vector<DeltaRun>& runs,
+                                    std::vector<uint8_t>& rgb) {
+    const uint16_t pixelCount = static_cast<uint16_t>(frame.size() / 3u);
+    candidates.clear();
+    if (fullFrame) {
+        for (uint16_t pixel = 0; pixel < pixelCount; pixel++) {
+            candidates.push_back(pixel);
+        }
+    } else {
+        // Any pixel outside both sets is black now and black in the retained frame.
+        candidates.insert(candidates.end(), state.touchedPixels.begin(), state.touchedPixels.end());
+        candidates.insert(candidates.end(), litPixels.begin(), litPixels.end());
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+    uint16_t changed = 0;
+    litPixels.clear();
+    for (const uint16_t pixel : candidates) {
+        if (pixel >= pixelCount) {
+            continue;
+        }
+        uint8_t* const retained = frame.data() + static_cast<size_t>(pixel) * 3u;
+        const ColorRGB color = state.getPixel(pixel, maxBrightness);
+        if (fullFrame || exceedsThreshold(retained[0], color.R, threshold) ||
+            exceedsThreshold(retained[1], color.G, threshold) ||
+            exceedsThreshold(retained[2], color.B, threshold)) {
+            retained[0] = color.R;
+            retained[1] = color.G;
+            retained[2] = color.B;
+            if (!runs.empty() && runs.back().start + runs.back().length == pixel) {
+                runs.back().length++;
+            } else {
+                DeltaRun run;
+                run.start = pixel;
+                run.length = 1;
+                runs.push_back(run);
+            }
+            rgb.push_back(color.R);
+            rgb.push_back(color.G);
+            rgb.push_back(color.B);
+            changed++;
+        }
+        if (retained[0] != 0 || retained[1] != 0 || retained[2] != 0) {
+            litPixels.push_back(pixel);
+        }
+    }
+    fullFrame = false;
+    return changed;
+}
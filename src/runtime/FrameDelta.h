@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class State;
+
+struct DeltaRun {
+    uint16_t start = 0;
+    uint16_t length = 0;
+};
+
+/**
+ * FrameDeltaTracker - changed-pixel runs between successive output frames
+ *
+ * Keeps the last emitted output frame and, on each collect(), reports the
+ * pixels whose resolved color moved away from it. Only pixels the State
+ * touched this frame or that are still lit in the retained frame are
+ * inspected, so the cost follows the number of lit pixels rather than the
+ * object size. The first collect() after construction or reset() reports
+ * every pixel so a receiver can start from a full frame.
+ */
+class FrameDeltaTracker {
+  public:
+    explicit FrameDeltaTracker(uint16_t pixelCount);
+
+    // Appends runs in ascending pixel order and their colors (packed RGB,
+    // concatenated in run order). A pixel counts as changed when any channel
+    // differs from the retained frame by more than `threshold`; suppressed
+    // pixels keep their retained value so slow drifts still surface later.
+    // Returns the number of changed pixels.
+    uint16_t collect(const State& state,
+                     uint8_t threshold,
+                     uint8_t maxBrightness,
+                     std::vector<DeltaRun>& runs,
+                     std::vector<uint8_t>& rgb);
+    void reset();
+
+  private:
+    std::vector<uint8_t> frame;
+    std::vector<uint16_t> litPixels;
+    std::vector<uint16_t> candidates;
+    bool fullFrame = true;
+};
@@ -3,60 +3,51 @@
 #include "LightList.h"
 #include "../Globals.h"
 
-Light::Light(LightList *list, float speed, uint32_t lifeMillis, uint16_t idx, uint8_t maxBri) : RuntimeLight(list, idx, maxBri) {
-    this->speed = speed;
-    this->lifeMillis = lifeMillis;
-    this->color = ColorRGB(255, 255, 255);
+Light::Light(LightList *list, uint16_t slot, float speed, uint32_t lifeMillis, uint16_t idx, uint8_t maxBri)
+    : RuntimeLight(list, slot, idx, maxBri) {
+    store->speed[slot] = speed;
+    store->lifeMillis[slot] = lifeMillis;
+}
+
+Light::Light(LightList *list, uint16_t slot, float speed, uint32_t lifeMillis, uint16_t idx, uint8_t maxBri,
+             LightStore::SlotReady ready)
+    : RuntimeLight(list, slot, idx, maxBri, ready) {
+    store->speed[slot] = speed;
+    store->lifeMillis[slot] = lifeMillis;
 }
 
 uint8_t Light::getBrightness() const {
-  uint16_t value = bri % 511;
-  value = (value > 255 ? 511 - value : value);
-  const uint8_t fadeThresh = (list != NULL ? list->fadeThresh : 0);
-  const int16_t fadeRange = 255 - static_cast<int16_t>(fadeThresh);
-  if (fadeRange <= 0) {
-    return 0;
-  }
-  const int16_t aboveThreshold = static_cast<int16_t>(value) - static_cast<int16_t>(fadeThresh);
-  if (aboveThreshold <= 0) {
-    return 0;
-  }
-  const float normalized = static_cast<float>(aboveThreshold) / static_cast<float>(fadeRange);
-  const float scaled = normalized * maxBri;
-  if (scaled >= maxBri) {
-    return maxBri;
-  }
-  return static_cast<uint8_t>(scaled);
+  return brightnessFor(bri(), maxBri(), list != NULL ? list->fadeThresh : 0);
 }
 
 ColorRGB Light::getPixelColor() const {
-    return getPixelColorAt(pixel1);
+    return getPixelColorAt(pixel1());
 }
 
 ColorRGB Light::getPixelColorAt(int16_t /*pixel*/) const {
-    if (brightness == 255) {
-        return color;
+    if (brightness() == 255) {
+        return store->color[slot];
     }
-    return color.dim(brightness);
+    return store->color[slot].dim(brightness());
 }
 
 void Light::nextFrame() {
-  bri = list->getBri(this);
-  brightness = getBrightness();
+  setBri(list->getBri(this));
+  setBrightness(getBrightness());
   if (list == NULL) {
-    position += lightgraphMotionDistance(runtimeContext(), speed);
+    setPosition(position() + lightgraphMotionDistance(runtimeContext(), getSpeed()));
   }
   else {
-    position = list->getPosition(this);
+    setPosition(list->getPosition(this));
   }
 }
 
 bool Light::shouldExpire() const {
-  if (lifeMillis >= INFINITE_DURATION) {
+  if (lifeMillis() >= INFINITE_DURATION) {
     return false;
   }
   const uint8_t fadeSpeed = (list != nullptr) ? list->fadeSpeed : 0;
-  return runtimeContext().nowMillis >= lifeMillis && (fadeSpeed == 0 || brightness == 0);
+  return runtimeContext().nowMillis >= lifeMillis() && (fadeSpeed == 0 || brightness() == 0);
 }
 
 const Model* Light::getModel() const {
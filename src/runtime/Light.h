@@ -9,39 +9,52 @@ class Light : public RuntimeLight {
 
   public:
 
-    Light(LightList *parent, float speed, uint32_t lifeMillis, uint16_t idx = 0, uint8_t maxBri = 255);
-    
-    Light(uint8_t maxBri, float speed, uint32_t lifeMillis) : Light(nullptr, speed, lifeMillis, 0, maxBri) {
-    }
-    
-    Light(uint8_t maxBri) : Light(maxBri, DEFAULT_SPEED, INFINITE_DURATION) {
-    }
-    
-    Light() : Light(255) {
-    }
+    // Speed, life and color live in the list's store next to the other fields.
+    Light(LightList *list, uint16_t slot, float speed, uint32_t lifeMillis, uint16_t idx = 0, uint8_t maxBri = 255);
+    Light(LightList *list, uint16_t slot, float speed, uint32_t lifeMillis, uint16_t idx, uint8_t maxBri,
+          LightStore::SlotReady ready);
 
     float getSpeed() const override {
-        return speed;
+        return store->speed[slot];
     }
     void setSpeed(float speed) {
-        this->speed = speed;
+        store->speed[slot] = speed;
     }
     uint32_t getLife() const override {
-        return lifeMillis;
+        return lifeMillis();
     }
     void setDuration(uint32_t durMillis) override {
-        lifeMillis = static_cast<uint32_t>(std::min(
+        setLifeMillis(static_cast<uint32_t>(std::min(
             static_cast<unsigned long>(runtimeContext().nowMillis + durMillis),
-            static_cast<unsigned long>(INFINITE_DURATION)));
+            static_cast<unsigned long>(INFINITE_DURATION))));
     }
     ColorRGB getColor() const override {
-        return color;
+        return store->color[slot];
     }
     void setColor(ColorRGB color) override {
-      this->color = color;
+      store->color[slot] = color;
     }
 
     uint8_t getBrightness() const override;
+    // getBrightness() on plain values, for the list kernels.
+    static uint8_t brightnessFor(uint16_t bri, uint8_t maxBri, uint8_t fadeThresh) {
+      uint16_t value = bri % 511;
+      value = (value > 255 ? 511 - value : value);
+      const int16_t fadeRange = 255 - static_cast<int16_t>(fadeThresh);
+      if (fadeRange <= 0) {
+        return 0;
+      }
+      const int16_t aboveThreshold = static_cast<int16_t>(value) - static_cast<int16_t>(fadeThresh);
+      if (aboveThreshold <= 0) {
+        return 0;
+      }
+      const float normalized = static_cast<float>(aboveThreshold) / static_cast<float>(fadeRange);
+      const float scaled = normalized * maxBri;
+      if (scaled >= maxBri) {
+        return maxBri;
+      }
+      return static_cast<uint8_t>(scaled);
+    }
     ColorRGB getPixelColorAt(int16_t pixel) const override;
     ColorRGB getPixelColor() const override;
     void nextFrame() override;
@@ -49,11 +62,4 @@ class Light : public RuntimeLight {
     
     const Model* getModel() const override;
     const Behaviour* getBehaviour() const override;
-
-  private:
-
-    float speed = DEFAULT_SPEED;
-    ColorRGB color; // 3 bytes
-    // int16_t pixel2 = -1; // 4 bytes
-  
 };
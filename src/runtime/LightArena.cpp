@@ -0,0 +1,208 @@
+#include "LightArena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "../core/Platform.h"
+#include "Light.h"
+#include "LightList.h"
+#include "LightStore.h"
+
+namespace {
+
+size_t storeRunBytes() {
+    return LightStore::bytesFor(LightArena::kStoreRunLights);
+}
+
+}  // namespace
+
+LightArena::LightArena(uint16_t capacity) : capacity_(capacity) {}
+
+LightArena::~LightArena() {
+    std::free(storage_);
+    std::free(freeSlots_);
+}
+
+bool LightArena::reserve() {
+    if (storage_ != nullptr) {
+        return true;
+    }
+    if (reserveFailed_ || capacity_ == 0) {
+        return false;
+    }
+    const size_t storeBytes = static_cast<size_t>(storeRuns()) * storeRunBytes();
+    storage_ = static_cast<uint8_t*>(std::malloc(storeOffset() + storeBytes));
+    freeSlots_ = static_cast<uint16_t*>(
+        std::malloc(static_cast<size_t>(capacity_) * sizeof(uint16_t) + storeRuns()));
+    if (storage_ == nullptr || freeSlots_ == nullptr) {
+        // Lists fall back to their own slabs and stores; don't retry on every emit.
+        LG_LOGF("LightArena::reserve failed: OOM for %u lights\n", capacity_);
+        std::free(storage_);
+        std::free(freeSlots_);
+        storage_ = nullptr;
+        freeSlots_ = nullptr;
+        reserveFailed_ = true;
+        return false;
+    }
+    noteHeapAllocation(2);
+    storeRunUsed_ = reinterpret_cast<uint8_t*>(freeSlots_ + capacity_);
+    std::fill(storeRunUsed_, storeRunUsed_ + storeRuns(), static_cast<uint8_t>(0));
+    // Stack top is slot 0 so consecutive acquires walk the block in order.
+    for (uint16_t i = 0; i < capacity_; i++) {
+        freeSlots_[i] = static_cast<uint16_t>(capacity_ - 1 - i);
+    }
+    freeCount_ = capacity_;
+    return true;
+}
+
+bool LightArena::reserveStorage() {
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    if (storage_ != nullptr) {
+        return true;
+    }
+    if (!reserve()) {
+        return false;
+    }
+    std::memset(storage_, 0, storeOffset() + static_cast<size_t>(storeRuns()) * storeRunBytes());
+    return true;
+}
+
+void* LightArena::acquire() {
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    if (freeCount_ == 0 && !reserve()) {
+        return nullptr;
+    }
+    if (freeCount_ == 0) {
+        return nullptr;
+    }
+    const uint16_t slot = freeSlots_[--freeCount_];
+    return storage_ + static_cast<size_t>(slot) * sizeof(Light);
+}
+
+void LightArena::release(void* slot) {
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    if (!owns(slot) || freeCount_ >= capacity_) {
+        return;
+    }
+    const size_t offset = static_cast<size_t>(static_cast<uint8_t*>(slot) - storage_);
+    freeSlots_[freeCount_++] = static_cast<uint16_t>(offset / sizeof(Light));
+}
+
+bool LightArena::owns(const void* slot) const {
+    if (storage_ == nullptr || slot == nullptr) {
+        return false;
+    }
+    const uint8_t* const probe = static_cast<const uint8_t*>(slot);
+    if (probe < storage_ || probe >= storage_ + static_cast<size_t>(capacity_) * sizeof(Light)) {
+        return false;
+    }
+    return (static_cast<size_t>(probe - storage_) % sizeof(Light)) == 0;
+}
+
+uint16_t LightArena::storeRuns() const {
+    return static_cast<uint16_t>((capacity_ + kStoreRunLights - 1) / kStoreRunLights);
+}
+
+size_t LightArena::storeOffset() const {
+    // Store arrays are 16-byte aligned relative to the block.
+    return (static_cast<size_t>(capacity_) * sizeof(Light) + 15u) & ~static_cast<size_t>(15u);
+}
+
+void* LightArena::acquireStore(uint16_t capacity) {
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    if (capacity == 0 || !reserve()) {
+        return nullptr;
+    }
+    const uint16_t runs = static_cast<uint16_t>((capacity + kStoreRunLights - 1) / kStoreRunLights);
+    const uint16_t total = storeRuns();
+    uint16_t start = 0;
+    while (static_cast<uint32_t>(start) + runs <= total) {
+        uint16_t used = 0;
+        while (used < runs && storeRunUsed_[start + used] == 0) {
+            used++;
+        }
+        if (used == runs) {
+            std::fill(storeRunUsed_ + start, storeRunUsed_ + start + runs, static_cast<uint8_t>(1));
+            return storage_ + storeOffset() + static_cast<size_t>(start) * storeRunBytes();
+        }
+        start = static_cast<uint16_t>(start + used + 1);
+    }
+    return nullptr;
+}
+
+void LightArena::releaseStore(void* block, uint16_t capacity) {
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    if (!ownsStore(block)) {
+        return;
+    }
+    const uint16_t start = static_cast<uint16_t>(
+        static_cast<size_t>(static_cast<uint8_t*>(block) - storage_ - storeOffset()) / storeRunBytes());
+    const uint16_t runs = static_cast<uint16_t>((capacity + kStoreRunLights - 1) / kStoreRunLights);
+    const uint16_t end = std::min<uint16_t>(static_cast<uint16_t>(start + runs), storeRuns());
+    std::fill(storeRunUsed_ + start, storeRunUsed_ + end, static_cast<uint8_t>(0));
+}
+
+bool LightArena::ownsStore(const void* block) const {
+    if (storage_ == nullptr || block == nullptr) {
+        return false;
+    }
+    const uint8_t* const first = storage_ + storeOffset();
+    const uint8_t* const probe = static_cast<const uint8_t*>(block);
+    if (probe < first || probe >= first + static_cast<size_t>(storeRuns()) * storeRunBytes()) {
+        return false;
+    }
+    return (static_cast<size_t>(probe - first) % storeRunBytes()) == 0;
+}
+
+uint16_t LightArena::available() const {
+    if (storage_ == nullptr) {
+        return reserveFailed_ ? 0 : capacity_;
+    }
+    return freeCount_;
+}
+
+LightListPool::~LightListPool() {
+    for (uint8_t i = 0; i < idleCount_; i++) {
+        delete idle_[i];
+        idle_[i] = nullptr;
+    }
+    idleCount_ = 0;
+}
+
+LightList* LightListPool::acquire() {
+    if (idleCount_ > 0) {
+        LightList* const list = idle_[--idleCount_];
+        idle_[idleCount_] = nullptr;
+        return list;
+    }
+    LightList* const list = new (std::nothrow) LightList();
+    if (list != nullptr) {
+        arena_.noteHeapAllocation();
+        list->bindLightArena(&arena_);
+    }
+    return list;
+}
+
+void LightListPool::release(LightList* list) {
+    if (list == nullptr) {
+        return;
+    }
+    if (list->lightArena() != &arena_ || idleCount_ >= MAX_LIGHT_LISTS) {
+        delete list;
+        return;
+    }
+    list->recycle();
+    idle_[idleCount_++] = list;
+}
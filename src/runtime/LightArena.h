@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../Globals.h"
+#include "../core/Limits.h"
+
+#if LIGHTGRAPH_PARALLEL_UPDATE
+#include <mutex>
+#endif
+
+class LightList;
+
+/**
+ * LightArena - preallocated storage for the lights of one State
+ *
+ * Holds `capacity` Light-sized slots in a single block, reserved by
+ * reserveStorage() or else on the first acquire() or acquireStore(). Slots are handed out from a free stack,
+ * so acquire() and release() are O(1) and a list released whole is handed
+ * back the same run of slots on its next acquire. The same block carries
+ * LightStore arrays for `capacity` lights, handed to lists in runs of
+ * kStoreRunLights, so building a list neither allocates nor first-touches
+ * store memory once the block is warm. The default capacity is twice the
+ * MAX_TOTAL_LIGHTS bound State enforces, so a list can be replaced while the
+ * scene is at the cap; lists that do not fit fall back to heap slabs and show
+ * up in heapAllocations(). All members that hand out or take back storage
+ * are thread-safe in LIGHTGRAPH_PARALLEL_UPDATE builds.
+ */
+class LightArena {
+  public:
+    // Store runs are whole multiples of this many lights.
+    static constexpr uint16_t kStoreRunLights = 16;
+
+    explicit LightArena(uint16_t capacity = LIGHTGRAPH_LIGHT_ARENA_CAPACITY);
+    ~LightArena();
+
+    LightArena(const LightArena&) = delete;
+    LightArena& operator=(const LightArena&) = delete;
+
+    // Reserves the block now and touches it, so the first emits neither
+    // allocate nor fault it in; State calls this on construction.
+    bool reserveStorage();
+    // Storage for one Light (or RuntimeLight); nullptr when exhausted or when
+    // the block could not be reserved. The caller constructs in place.
+    void* acquire();
+    // Returns a slot obtained from acquire(); the object must already be destroyed.
+    void release(void* slot);
+    bool owns(const void* slot) const;
+
+    // A block for LightStore::assign(capacity), first fit over the store
+    // runs; nullptr when no free run is long enough.
+    void* acquireStore(uint16_t capacity);
+    // Returns a block from acquireStore() with the capacity it was asked for.
+    void releaseStore(void* block, uint16_t capacity);
+    bool ownsStore(const void* block) const;
+
+    uint16_t capacity() const {
+        return capacity_;
+    }
+    uint16_t available() const;
+
+    // Heap allocations made for light storage on this State: the arena block
+    // itself plus every table, slab or light that could not come from a pool.
+    // Stays flat while emission is served entirely from the arena and pool.
+    uint32_t heapAllocations() const {
+        return heapAllocations_;
+    }
+    void noteHeapAllocation(uint32_t count = 1) {
+        heapAllocations_ += count;
+    }
+
+  private:
+    bool reserve();
+    uint16_t storeRuns() const;
+    size_t storeOffset() const;
+
+    uint16_t capacity_;
+    uint16_t freeCount_ = 0;
+    uint8_t* storage_ = nullptr;
+    uint16_t* freeSlots_ = nullptr;
+    // One flag per store run, after freeSlots_ in the same allocation.
+    uint8_t* storeRunUsed_ = nullptr;
+    bool reserveFailed_ = false;
+    uint32_t heapAllocations_ = 0;
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    // Lists expire lights from update worker threads.
+    std::mutex mutex_;
+#endif
+};
+
+/**
+ * LightListPool - recycled LightList objects bound to a LightArena
+ *
+ * Lists handed out by acquire() draw their lights and stores from the arena
+ * and keep their light table and Behaviour across reuse, so replacing a list (e.g. a
+ * repeated MIDI note) needs no heap allocation once the pool is warm. At
+ * most MAX_LIGHT_LISTS idle lists are retained.
+ */
+class LightListPool {
+  public:
+    explicit LightListPool(LightArena& arena) : arena_(arena) {}
+    ~LightListPool();
+
+    LightListPool(const LightListPool&) = delete;
+    LightListPool& operator=(const LightListPool&) = delete;
+
+    // O(1): a reset list bound to the arena, or nullptr on OOM.
+    LightList* acquire();
+    // O(1): recycles lists from acquire() and deletes any other list.
+    void release(LightList* list);
+
+    uint8_t idle() const {
+        return idleCount_;
+    }
+
+  private:
+    LightArena& arena_;
+    LightList* idle_[MAX_LIGHT_LISTS] = {nullptr};
+    uint8_t idleCount_ = 0;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../Globals.h"
+#include "../core/Platform.h"
+#include "../topology/Model.h"
+#include "RuntimeLight.h"
+
+// Per-frame light motion with the behaviour bits as template parameters.
+//
+// Behaviour flags never change during a list's lifetime, so State picks one
+// instantiation per list (see State::updateListLights) and the per-light
+// loop runs without flag tests or virtual calls. Behaviour::getBri() and
+// Behaviour::getPosition() forward here, so both paths share one definition.
+// The list kernels call the scalar forms on the list's LightStore arrays.
+namespace light_kernel {
+
+// How a light paints beyond its own pixel; mirrors RuntimeLight::writePixels.
+enum SpanMode : uint8_t {
+    SPAN_PIXEL = 0,
+    SPAN_SEGMENT = 1,
+    SPAN_FILL_EASE = 2,
+};
+
+constexpr uint8_t kSpanModes = 3;
+
+// Scalar forms, used by State's list kernels on LightStore arrays. `briStep`
+// and `step` are lightgraphMotionDistance() of the fade speed and the speed.
+template <bool ConstNoise>
+inline uint16_t nextBri(const LightgraphRuntimeContext& context, uint16_t listId, uint16_t bri, int16_t pixel1,
+                        float briStep) {
+    if constexpr (ConstNoise) {
+        return context.perlinNoise.GetValue(listId * 10, pixel1 * 100) * 255;
+    } else {
+        (void) context;
+        (void) listId;
+        (void) pixel1;
+        return static_cast<uint16_t>(bri + briStep);
+    }
+}
+
+template <bool PosChangeFade>
+inline float nextPosition(LightgraphRng& random, const Model* model, uint16_t& bri, float position, float step) {
+    if constexpr (PosChangeFade) {
+        if (bri >= 511) {
+            bri -= 511;
+            return random.uniform(model->getMaxLength());
+        }
+    } else {
+        (void) random;
+        (void) model;
+        (void) bri;
+    }
+    return position + step;
+}
+
+template <bool ConstNoise>
+inline uint16_t nextBri(const RuntimeLight* light, float fadeSpeed) {
+    return nextBri<ConstNoise>(light->runtimeContext(), light->getListId(), light->bri(), light->pixel1(),
+                               ConstNoise ? 0.0f : lightgraphMotionDistance(light->runtimeContext(), fadeSpeed));
+}
+
+template <bool PosChangeFade>
+inline float nextPosition(RuntimeLight* light, const Model* model, float speed) {
+    uint16_t bri = light->bri();
+    const float position = nextPosition<PosChangeFade>(light->random(), model, bri, light->position(),
+                                                       lightgraphMotionDistance(light->runtimeContext(), speed));
+    light->setBri(bri);
+    return position;
+}
+
+} // namespace light_kernel
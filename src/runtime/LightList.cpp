@@ -1,33 +1,36 @@
 #include "LightList.h"
 #include "Light.h"
+#include "LightArena.h"
+#include "../rendering/PaletteCache.h"
 #include "../core/Platform.h"
 #include "../topology/Model.h"
+#include "../topology/Owner.h"
 #include "../Globals.h"
+#include <algorithm>
 #include <cstdlib>
 #include <new>
 #include <stdio.h>
+#include <type_traits>
 #include <vector>
 
-uint16_t LightList::nextId = 0;
-
 LightList::~LightList() {
     clearAllocatedLights();
+    releaseLightStore();
     if (behaviour != NULL) {
         delete behaviour;
     }
 }
 
-void LightList::clearAllocatedLights() {
+void LightList::releaseLights() {
     if (lights != NULL) {
-        for (uint16_t i = 0; i < allocatedLights; i++) {
-            RuntimeLight*& light = lights[i];
+        // Back to front, so an arena hands the same slots out in slot order next time.
+        for (uint16_t i = allocatedLights; i > 0; i--) {
+            RuntimeLight*& light = lights[i - 1];
             if (light == NULL) {
                 continue;
             }
             releaseOwnedLight(light);
         }
-        delete[] lights;
-        lights = NULL;
     }
     if (contiguousLightStorage != nullptr) {
         std::free(contiguousLightStorage);
@@ -37,6 +40,15 @@ void LightList::clearAllocatedLights() {
     allocatedLights = 0;
 }
 
+void LightList::clearAllocatedLights() {
+    releaseLights();
+    if (lights != NULL) {
+        delete[] lights;
+        lights = NULL;
+    }
+    lightTableCapacity = 0;
+}
+
 bool LightList::ownsContiguousLight(const RuntimeLight* light) const {
     if (contiguousLightStorage == nullptr || contiguousLightStrideBytes == 0 || light == nullptr) {
         return false;
@@ -47,12 +59,67 @@ bool LightList::ownsContiguousLight(const RuntimeLight* light) const {
     return probe >= start && probe < end && ((probe - start) % contiguousLightStrideBytes) == 0;
 }
 
+bool LightList::reserveLightStore(uint16_t capacity) {
+    if (capacity <= lightStore_.capacity()) {
+        return true;
+    }
+    releaseLightStore();
+    if (lightArena_ != nullptr) {
+        void* const block = lightArena_->acquireStore(capacity);
+        if (block != nullptr) {
+            lightStore_.assign(block, capacity);
+            return true;
+        }
+    }
+    if (!lightStore_.reserve(capacity)) {
+        return false;
+    }
+    if (lightStore_.takeGrowth() && lightArena_ != nullptr) {
+        lightArena_->noteHeapAllocation();
+    }
+    return true;
+}
+
+void LightList::releaseLightStore() {
+    if (lightArena_ != nullptr && !lightStore_.ownsBlock()) {
+        lightArena_->releaseStore(lightStore_.block(), lightStore_.capacity());
+    }
+    lightStore_.clear();
+}
+
 void LightList::init(uint16_t numLights) {
+    if (lightArena_ != nullptr && lights != NULL && numLights <= lightTableCapacity &&
+        reserveLightStore(lightTableCapacity)) {
+        // Pooled lists keep their table; the lights and the store come from the arena.
+        releaseLights();
+        std::fill(lights, lights + lightTableCapacity, nullptr);
+        lightKinds_ = 0;
+        this->numLights = numLights;
+        allocatedLights = numLights;
+        numEmitted = 0;
+        return;
+    }
     clearAllocatedLights();
+    lightKinds_ = 0;
     this->numLights = numLights;
     allocatedLights = numLights;
     numEmitted = 0;
-    lights = new (std::nothrow) RuntimeLight*[numLights]();
+    // Pooled tables are rounded up so lists of similar length can trade places.
+    const uint16_t tableCapacity = (lightArena_ != nullptr)
+        ? static_cast<uint16_t>(std::min<uint32_t>((numLights + 15u) & ~15u, 0xFFF0u))
+        : numLights;
+    lights = new (std::nothrow) RuntimeLight*[std::max(tableCapacity, numLights)]();
+    if (lights != NULL) {
+        lightTableCapacity = std::max(tableCapacity, numLights);
+        if (lightArena_ != nullptr) {
+            lightArena_->noteHeapAllocation();
+        }
+        if (!reserveLightStore(lightTableCapacity)) {
+            delete[] lights;
+            lights = NULL;
+            lightTableCapacity = 0;
+        }
+    }
     if (numLights > 0 && lights == NULL) {
         LG_LOGF("LightList::init failed: OOM for %u lights\n", numLights);
         lightgraphReportAllocationFailure(
@@ -65,14 +132,30 @@ void LightList::init(uint16_t numLights) {
     }
 }
 
+bool LightList::allocateLightSlab(uint16_t numLights) {
+    if (numLights == 0 || lights == NULL) {
+        return false;
+    }
+    // One block for every light in the list: a single allocation per emit and
+    // lights laid out back to back in slot order for the per-frame walks.
+    contiguousLightStorage = std::malloc(static_cast<size_t>(numLights) * sizeof(Light));
+    if (contiguousLightStorage == nullptr) {
+        return false;
+    }
+    if (lightArena_ != nullptr) {
+        lightArena_->noteHeapAllocation();
+    }
+    contiguousLightStrideBytes = sizeof(Light);
+    return true;
+}
+
 bool LightList::initContiguousLights(uint16_t numLights) {
     init(numLights);
     if (numLights == 0 || lights == NULL) {
         return numLights == 0;
     }
 
-    contiguousLightStorage = std::malloc(static_cast<size_t>(numLights) * sizeof(Light));
-    if (contiguousLightStorage == nullptr) {
+    if (!allocateLightSlab(numLights)) {
         LG_LOGF("LightList::initContiguousLights failed: OOM for %u lights\n", numLights);
         lightgraphReportAllocationFailure(
             runtimeContext(),
@@ -85,14 +168,19 @@ bool LightList::initContiguousLights(uint16_t numLights) {
         allocatedLights = 0;
         return false;
     }
-
-    contiguousLightStrideBytes = sizeof(Light);
     return true;
 }
 
 void LightList::setup(uint16_t numLights, uint8_t maxBri) {
     init(lead + numLights + trail);
+    // Lights come from the arena when one is bound and has room, then from a
+    // per-list slab, and on a fragmented heap from one allocation each.
+    if (lightArena_ == nullptr || lightArena_->available() < this->numLights) {
+        allocateLightSlab(this->numLights);
+    }
     this->maxBri = maxBri;
+    // One pass per store array; createLight() then writes only idx and maxBri.
+    lightStore_.initSlots(this->numLights);
     uint16_t createdLights = 0;
     for (uint16_t i=0; i<this->numLights; i++) {
         if (createLight(i, maxBri) == NULL) {
@@ -122,14 +210,32 @@ RuntimeLight* LightList::createLight(uint16_t i, uint8_t brightness) {
     if (lights == NULL || i >= numLights) {
         return NULL;
     }
+    if ((*this)[i] != NULL) {
+        releaseOwnedLight((*this)[i]);
+    }
     float mult = getBriMult(i);
     RuntimeLight *light;
+    void* slot = lightSlabSlot(i);
+    if (slot == nullptr && lightArena_ != nullptr) {
+        slot = lightArena_->acquire();
+        if (slot == nullptr) {
+            lightArena_->noteHeapAllocation();
+        }
+    }
     // todo: fix if statement
+    uint8_t kind;
     if (behaviour != NULL/* && behaviour->colorChangeGroups > 0*/) {
-        light = new (std::nothrow) Light(this, speed, lifeMillis, linked ? i : 0, brightness * mult);
+        light = (slot != nullptr)
+            ? new (slot) Light(this, i, speed, lifeMillis, linked ? i : 0, brightness * mult, LightStore::SlotReady{})
+            : new (std::nothrow) Light(this, i, speed, lifeMillis, linked ? i : 0, brightness * mult,
+                                       LightStore::SlotReady{});
+        kind = LIGHT_KIND_LIGHT;
     }
     else {
-        light = new (std::nothrow) RuntimeLight(this, linked ? i : 0, brightness * mult);
+        light = (slot != nullptr)
+            ? new (slot) RuntimeLight(this, i, linked ? i : 0, brightness * mult, LightStore::SlotReady{})
+            : new (std::nothrow) RuntimeLight(this, i, linked ? i : 0, brightness * mult, LightStore::SlotReady{});
+        kind = LIGHT_KIND_RUNTIME;
     }
     if (light == NULL) {
         LG_LOGF("LightList::createLight failed: OOM at index %u\n", i);
@@ -141,6 +247,7 @@ RuntimeLight* LightList::createLight(uint16_t i, uint8_t brightness) {
         return NULL;
     }
     (*this)[i] = light;
+    lightKinds_ |= kind;
     return light;
 }
 
@@ -154,14 +261,28 @@ Light* LightList::createContiguousLight(uint16_t slot, float speed, uint32_t lif
         releaseOwnedLight(existing);
     }
 
-    uint8_t* const base = static_cast<uint8_t*>(contiguousLightStorage);
-    void* const storage = static_cast<void*>(base + (static_cast<size_t>(slot) * contiguousLightStrideBytes));
-    Light* const light = new (storage) Light(this, speed, lifeMillis, idx, maxBri);
-    existing = light;
+    Light* const light = new (lightSlabSlot(slot)) Light(this, slot, speed, lifeMillis, idx, maxBri);
+    placeLight(slot, light);
     return light;
 }
 
+void LightList::placeLight(uint16_t slot, Light* light) {
+    lights[slot] = light;
+    lightKinds_ |= LIGHT_KIND_LIGHT;
+}
+
+void* LightList::lightSlabSlot(uint16_t slot) const {
+    if (contiguousLightStorage == nullptr || slot >= allocatedLights) {
+        return nullptr;
+    }
+    uint8_t* const base = static_cast<uint8_t*>(contiguousLightStorage);
+    return static_cast<void*>(base + (static_cast<size_t>(slot) * contiguousLightStrideBytes));
+}
+
 RuntimeLight* LightList::createAutoLight(uint16_t slot, uint8_t brightness) {
+    if (lights != NULL && slot < numLights) {
+        lightStore_.initSlot(slot, 0, brightness);
+    }
     return createLight(slot, brightness);
 }
 
@@ -170,7 +291,13 @@ void LightList::releaseOwnedLight(RuntimeLight*& light) {
         return;
     }
     if (ownsContiguousLight(light)) {
-        static_cast<Light*>(light)->~Light();
+        light->~RuntimeLight();
+        light = NULL;
+        return;
+    }
+    if (lightArena_ != nullptr && lightArena_->owns(light)) {
+        light->~RuntimeLight();
+        lightArena_->release(light);
         light = NULL;
         return;
     }
@@ -178,9 +305,64 @@ void LightList::releaseOwnedLight(RuntimeLight*& light) {
     light = NULL;
 }
 
+void LightList::recycle() {
+    releaseLights();
+    // Idle lists hold no store run, so the arena only backs live lists.
+    releaseLightStore();
+    id = 0;
+    noteId = 0;
+    speed = DEFAULT_SPEED;
+    ease = ofxeasing::linear::easeNone;
+    easeIndex = EASE_NONE;
+    fadeSpeed = 0;
+    fadeThresh = 0;
+    minBri = 0;
+    maxBri = 255;
+    fadeEase = ofxeasing::linear::easeNone;
+    fadeEaseIndex = EASE_NONE;
+    lifeMillis = 0;
+    order = LIST_ORDER_SEQUENTIAL;
+    head = LIST_HEAD_FRONT;
+    linked = true;
+    model = 0;
+    length = 0;
+    numLights = 0;
+    lead = 0;
+    trail = 0;
+    emitter = 0;
+    numEmitted = 0;
+    numSplits = 0;
+    // colors/palette keep their capacity; every build assigns a palette.
+    colors.clear();
+    visible = true;
+    editable = false;
+    blendMode = BLEND_NORMAL;
+    duration = 1000;
+    emitOffset = 0;
+    compensateHiddenIngressContinuity = false;
+    clearExternalBatchForwardState();
+    runtimeContext_ = nullptr;
+}
+
 void LightList::setDuration(uint32_t durMillis) {
     this->duration = durMillis;
     this->lifeMillis = MIN(runtimeContext().nowMillis + durMillis, INFINITE_DURATION);
+    // Uniform lists skip the per-light virtual call: RuntimeLight keeps no
+    // life of its own and Light's is one store field.
+    if (lightKinds_ == LIGHT_KIND_RUNTIME) {
+        return;
+    }
+    if (lightKinds_ == LIGHT_KIND_LIGHT) {
+        const uint32_t lightLife = static_cast<uint32_t>(std::min(
+            static_cast<unsigned long>(runtimeContext().nowMillis + durMillis),
+            static_cast<unsigned long>(INFINITE_DURATION)));
+        for (uint16_t i=0; i<numLights; i++) {
+            if ((*this)[i] != 0) {
+                lightStore_.lifeMillis[i] = lightLife;
+            }
+        }
+        return;
+    }
     for (uint16_t i=0; i<numLights; i++) {
         if ((*this)[i] == 0) continue;
         ((*this)[i])->setDuration(durMillis);
@@ -188,7 +370,12 @@ void LightList::setDuration(uint32_t durMillis) {
 }
 
 void LightList::setLightColors() {
-    if (numLights > 0) {
+    if (numLights > 0 && lightKinds_ == LIGHT_KIND_LIGHT) {
+        for (uint16_t i=0; i<numLights; i++) {
+            if ((*this)[i] == 0) continue;
+            lightStore_.color[i] = getLightColor(i);
+        }
+    } else if (numLights > 0) {
         for (uint16_t i=0; i<numLights; i++) {
             if ((*this)[i] == 0) continue;
             ((*this)[i])->setColor(getLightColor(i));
@@ -233,16 +420,33 @@ void LightList::setupFrom(const EmitParams &params) {
     reset();
 }
 
+void LightList::traceRoute(uint16_t hop, uint16_t intersectionId, uint8_t portSlot) {
+    if (routeTrace_.empty()) {
+        size_t capacity = 4;
+        while (capacity < static_cast<size_t>(numLights) + 2u) {
+            capacity <<= 1;
+        }
+        routeTrace_.assign(capacity, RouteStep{0, 0, RouteStep::kUnusedSlot});
+    }
+    routeTrace_[hop & (routeTrace_.size() - 1)] = RouteStep{hop, intersectionId, portSlot};
+}
+
 void LightList::initEmit(uint8_t posOffset) {
+    // Sized on the first traced decision, so unlinked lists never allocate.
+    routeTrace_.clear();
+    // Lights sit in the store at their index, so the fields are set by slot.
     for (uint16_t i=0; i<numLights; i++) {
         RuntimeLight *light = (*this)[i];
         if (light == nullptr) {
             continue;
         }
-        initPosition(i, light);
-        light->position += posOffset;
-        initBri(i, light);
-        initLife(i, light);
+        lightStore_.routeHop[i] = 0;
+        initPosition(i);
+        lightStore_.position[i] += posOffset;
+        initBri(i);
+        initLife(i, lightKinds_ == LIGHT_KIND_LIGHT ? lightStore_.speed[i]
+                    : lightKinds_ == LIGHT_KIND_RUNTIME ? speed
+                    : light->getSpeed());
     }
 }
 
@@ -250,26 +454,26 @@ float LightList::getPosition(RuntimeLight* const light) const {
   if (behaviour != NULL) {
     return behaviour->getPosition(light);
   }
-  return light->position + lightgraphMotionDistance(runtimeContext(), light->getSpeed());
+  return light->position() + lightgraphMotionDistance(runtimeContext(), light->getSpeed());
 }
 
-void LightList::initPosition(uint16_t i, RuntimeLight* const light) const {
+void LightList::initPosition(uint16_t i) {
   float position = (speed != 0 ? i * -1.f : numLights - 1 - i * 1.f);
   if (order == LIST_ORDER_RANDOM) {
-    position = LG_RANDOM(model->getMaxLength());
+    position = Random::uniform(model->getMaxLength());
   }
-  light->position = position;
+  lightStore_.position[i] = position;
 }
 
-void LightList::initBri(uint16_t i, RuntimeLight* const light) const {
+void LightList::initBri(uint16_t i) {
   switch (order) {
     case LIST_ORDER_RANDOM:
       if (fadeThresh > 0) {
-        light->bri = LG_RANDOM(fadeThresh * 3);
+        lightStore_.bri[i] = Random::below(fadeThresh * 3);
       }
       break;
     case LIST_ORDER_NOISE:
-      light->bri = runtimeContext().perlinNoise.GetValue(id * 10, i * 100) * FULL_BRIGHTNESS;
+      lightStore_.bri[i] = runtimeContext().perlinNoise.GetValue(id * 10, i * 100) * FULL_BRIGHTNESS;
       break;
     default:
       break;
@@ -280,33 +484,58 @@ uint16_t LightList::getBri(const RuntimeLight* light) const {
   if (behaviour != NULL) {
     return behaviour->getBri(light);
   }
-  return static_cast<uint16_t>(light->bri + lightgraphMotionDistance(runtimeContext(), fadeSpeed));
+  return static_cast<uint16_t>(light->bri() + lightgraphMotionDistance(runtimeContext(), fadeSpeed));
 }
 
-void LightList::initLife(uint16_t i, RuntimeLight* const light) const {
-  uint32_t lifeMillis = light->lifeMillis;
-  if (order == LIST_ORDER_SEQUENTIAL && light->getSpeed() > 0) {
-    lifeMillis += ceil(1.f / light->getSpeed() * i) * EmitParams::frameMs();
+void LightList::initLife(uint16_t i, float lightSpeed) {
+  uint32_t lifeMillis = lightStore_.lifeMillis[i];
+  if (order == LIST_ORDER_SEQUENTIAL && lightSpeed > 0) {
+    lifeMillis += ceil(1.f / lightSpeed * i) * EmitParams::frameMs();
   }
-  light->lifeMillis = lifeMillis;
+  lightStore_.lifeMillis[i] = lifeMillis;
 }
 
 bool LightList::update() {
     doEmit();
+    switch (lightKinds_) {
+      case LIGHT_KIND_LIGHT:
+        return updateLights<LIGHT_KIND_LIGHT>();
+      case LIGHT_KIND_RUNTIME:
+        return updateLights<LIGHT_KIND_RUNTIME>();
+      default:
+        return updateLights<0>();
+    }
+}
+
+// Kind 0 is the generic path; otherwise every light is of that one type and
+// expiry, owner and brightness are read from the store by slot, so only the
+// owner call touches the light object.
+template <uint8_t Kind>
+bool LightList::updateLights() {
+    LightStore& store = lightStore_;
     bool allExpired = true;
     for (uint16_t j=0; j<numLights; j++) {
         RuntimeLight* const light = lights[j];
         if (light == NULL) continue;
-        if (light->isExpired) {
+        if (store.isExpired[j]) {
           RuntimeLight* const next = light->getNext();
           if (next != NULL) {
-            next->idx = 0;
+            next->setIdx(0);
           }
           releaseOwnedLight(lights[j]);
           continue;
         }
         allExpired = false;
-        light->update();
+        if constexpr (Kind == 0) {
+          light->update();
+        } else {
+          if (store.owner[j]) {
+              store.owner[j]->update(light);
+          }
+          store.brightness[j] = (Kind == LIGHT_KIND_LIGHT)
+              ? Light::brightnessFor(store.bri[j], store.maxBri[j], fadeThresh)
+              : RuntimeLight::brightnessFor(store.bri[j], store.maxBri[j], this);
+        }
     }
     return allExpired;
 }
@@ -326,7 +555,7 @@ void LightList::doEmit() {
             numEmitted++;
             continue;
         }
-        if (light->position < 0) {
+        if (light->position() < 0) {
             break;
         }
         numEmitted++;
@@ -340,7 +569,7 @@ void LightList::split() {
     for (uint8_t i=0; i<numSplits; i++) {
       uint16_t split = (i+1)*(numLights/(numSplits+1));
       if ((*this)[split] == 0) continue;
-      (*this)[split]->idx = 0;
+      (*this)[split]->setIdx(0);
     }
     // todo: modify trail
   }
@@ -348,25 +577,33 @@ void LightList::split() {
 
 float LightList::getOffset() const {
     if (numLights > 0 && lights != NULL && lights[0] != NULL) {
-        return lights[0]->position;
+        return lights[0]->position();
     }
     return 0.0f;
 }
 
 void LightList::setOffset(float newPosition) {
     if (numLights > 0 && lights != NULL && lights[0] != NULL) {
-        float currentPosition = lights[0]->position;
+        float currentPosition = lights[0]->position();
         float offset = newPosition - currentPosition;
         
         // Apply the offset to all lights in the list
         for (uint16_t i = 0; i < numLights; i++) {
             if (lights[i] != NULL) {
-                lights[i]->position += offset;
+                lights[i]->setPosition(lights[i]->position() + offset);
             }
         }
     }
 }
 
+void LightList::interpolateColors(uint16_t count) {
+    if (paletteCache_ != nullptr) {
+        paletteCache_->interpolate(palette, count, colors);
+    } else {
+        palette.interpolateInto(colors, count);
+    }
+}
+
 void LightList::reset() {
     clearExternalBatchForwardState();
     numEmitted = 0;
@@ -16,14 +16,22 @@
 class Model;
 class Light;
 class Owner;
+class LightArena;
+class PaletteCache;
+
+// Concrete light types held by a list, as a bitmask (see LightList::lightKinds).
+enum LightKind : uint8_t {
+  LIGHT_KIND_RUNTIME = 1,
+  LIGHT_KIND_LIGHT = 2,
+};
 
 class LightList {
 
   public:
 
-    static uint16_t nextId;
-    
-    uint16_t id;
+    // Drawn from the runtime context when the list is bound to it (see
+    // bindRuntimeContext); 0 until then.
+    uint16_t id = 0;
     uint16_t noteId = 0;
     float speed = DEFAULT_SPEED;
     ofxeasing::function ease = ofxeasing::linear::easeNone;
@@ -59,18 +67,13 @@ class LightList {
     bool externalBatchForwarded = false;
     bool externalBatchHasTargetId = false;
     uint8_t externalBatchDevice[6] = {0};
-    uint8_t externalBatchTargetId = 0;
-    int16_t externalBatchTargetIntersectionId = -1;
+    uint16_t externalBatchTargetId = 0;
+    int32_t externalBatchTargetIntersectionId = -1;
 
-    LightList() {
-      this->id = nextId++;
-    }
+    LightList() = default;
     
     // Copy constructor
     LightList(const LightList& other) {
-      // Assign a new ID
-      this->id = nextId++;
-      
       // Copy basic properties
       noteId = other.noteId;
       speed = other.speed;
@@ -115,7 +118,10 @@ class LightList {
         maxBri = other.maxBri;
       duration = other.duration;
       palette = other.palette;
-      runtimeContext_ = other.runtimeContext_;
+      if (other.runtimeContext_ != nullptr) {
+        bindRuntimeContext(*other.runtimeContext_); // assigns a new id
+      }
+      rng_.seed(Random::active().next64());
       reset();
     }
 
@@ -131,6 +137,15 @@ class LightList {
 
     float getBriMult(uint16_t i);
 
+    // Fields of this list's lights by slot, for the per-frame kernels; the
+    // RuntimeLight objects in `lights` are views onto it.
+    LightStore& lightStore() {
+      return lightStore_;
+    }
+    const LightStore& lightStore() const {
+      return lightStore_;
+    }
+
     RuntimeLight* operator [] (uint16_t i) const {
       return lights[i];
     }
@@ -158,10 +173,13 @@ class LightList {
     void setDuration(uint32_t durMillis);
     
     virtual void setPalette(const Palette& newPalette) {
-        palette = newPalette;        
-        colors = palette.interpolate(numLights);
+        palette = newPalette;
+        interpolateColors(numLights);
         setLightColors();
     }
+    // Fills colors with the palette interpolated to count entries, through
+    // the bound PaletteCache when there is one.
+    void interpolateColors(uint16_t count);
     void setupFrom(const EmitParams &params);
     void initEmit(uint8_t posOffset = 0);
     virtual bool update();
@@ -190,6 +208,14 @@ class LightList {
     virtual void setOffset(float newPosition);
     
     RuntimeLight* createAutoLight(uint16_t slot, uint8_t brightness);
+    // Stores a light created outside createLight() and records its type.
+    void placeLight(uint16_t slot, Light* light);
+    // Light types created since the last init(): a single LightKind lets the
+    // update loops call that type's members directly. 0 when unknown, e.g. a
+    // subclass that fills the table itself; callers then stay virtual.
+    uint8_t lightKinds() const {
+      return lightKinds_;
+    }
     void releaseOwnedLight(RuntimeLight*& light);
     bool initContiguousLights(uint16_t numLights);
     Light* createContiguousLight(uint16_t slot, float speed, uint32_t lifeMillis,
@@ -201,8 +227,8 @@ class LightList {
       externalBatchTargetIntersectionId = -1;
       std::memset(externalBatchDevice, 0, sizeof(externalBatchDevice));
     }
-    void markExternalBatchForwarded(const uint8_t device[6], uint8_t targetId,
-                                    int16_t targetIntersectionId = -1,
+    void markExternalBatchForwarded(const uint8_t device[6], uint16_t targetId,
+                                    int32_t targetIntersectionId = -1,
                                     bool hasTargetId = true) {
       if (device == nullptr) {
         clearExternalBatchForwardState();
@@ -214,8 +240,8 @@ class LightList {
       externalBatchTargetIntersectionId = targetIntersectionId;
       externalBatchForwarded = true;
     }
-    bool hasExternalBatchForwardedTo(const uint8_t device[6], uint8_t targetId,
-                                     int16_t targetIntersectionId = -1,
+    bool hasExternalBatchForwardedTo(const uint8_t device[6], uint16_t targetId,
+                                     int32_t targetIntersectionId = -1,
                                      bool hasTargetId = true) const {
       return externalBatchForwarded && device != nullptr &&
              externalBatchHasTargetId == hasTargetId &&
@@ -223,8 +249,30 @@ class LightList {
              externalBatchTargetIntersectionId == targetIntersectionId &&
              std::memcmp(externalBatchDevice, device, sizeof(externalBatchDevice)) == 0;
     }
+    // Lights and the store of a bound list are placed in the arena and its
+    // light table is kept across init() calls; see LightListPool.
+    void bindLightArena(LightArena* arena) {
+      lightArena_ = arena;
+    }
+    LightArena* lightArena() const {
+      return lightArena_;
+    }
+    // Interpolated palette tables shared by the lists of one State; kept
+    // across recycle(). Unbound lists interpolate on every setPalette.
+    void bindPaletteCache(PaletteCache* cache) {
+      paletteCache_ = cache;
+    }
+    PaletteCache* paletteCache() const {
+      return paletteCache_;
+    }
+    // Releases the lights and the store and resets every setting to its default
+    // while keeping the light table, Behaviour and palette storage for the next build.
+    void recycle();
+    // Binding also gives the list the context's next id, so list ids only
+    // depend on the order lists enter one engine.
     void bindRuntimeContext(LightgraphRuntimeContext& context) {
       runtimeContext_ = &context;
+      id = context.nextListId++;
     }
     LightgraphRuntimeContext& runtimeContext() {
       return (runtimeContext_ != nullptr) ? *runtimeContext_ : lightgraphDefaultRuntimeContext();
@@ -232,23 +280,64 @@ class LightList {
     const LightgraphRuntimeContext& runtimeContext() const {
       return (runtimeContext_ != nullptr) ? *runtimeContext_ : lightgraphDefaultRuntimeContext();
     }
+    // Stream for the draws made while this list is emitted and updated, so
+    // lists updated on different threads never share a generator. State
+    // seeds it from the runtime context when the list is activated.
+    LightgraphRng& random() {
+      return rng_;
+    }
+
+    // Route trace: the port each intersection decision of a linked list took,
+    // by hop (the deciding light's RuntimeLight::routeHop). Followers replay
+    // the entry for their own hop, so trains of any length keep the route the
+    // first light at that hop chose. The ring holds a hop per light plus
+    // slack, which covers followers as far behind as the list is long.
+    struct RouteStep {
+      uint16_t hop;
+      uint16_t intersectionId;
+      uint8_t portSlot; // index into Intersection::ports; kUnusedSlot while unused
+      static constexpr uint8_t kUnusedSlot = 0xFF;
+    };
+    const RouteStep* routeStep(uint16_t hop) const {
+      if (routeTrace_.empty()) {
+        return nullptr;
+      }
+      const RouteStep& step = routeTrace_[hop & (routeTrace_.size() - 1)];
+      return (step.portSlot != RouteStep::kUnusedSlot && step.hop == hop) ? &step : nullptr;
+    }
+    void traceRoute(uint16_t hop, uint16_t intersectionId, uint8_t portSlot);
 
   private:
 
+    // Expects the slot reset already (LightStore::initSlots or initSlot).
     RuntimeLight* createLight(uint16_t i, uint8_t brightness);
+    void releaseLights();
     void clearAllocatedLights();
     bool ownsContiguousLight(const RuntimeLight* light) const;
-    void initPosition(uint16_t i, RuntimeLight* const light) const;
-    void initBri(uint16_t i, RuntimeLight* const light) const;
-    void initLife(uint16_t i, RuntimeLight* const light) const;
+    bool allocateLightSlab(uint16_t numLights);
+    bool reserveLightStore(uint16_t capacity);
+    void releaseLightStore();
+    void* lightSlabSlot(uint16_t slot) const;
+    template <uint8_t Kind>
+    bool updateLights();
+    void initPosition(uint16_t i);
+    void initBri(uint16_t i);
+    void initLife(uint16_t i, float lightSpeed);
     void doEmit();
     void setLightColors();
     inline uint16_t body() {
         return numLights - lead - trail;
     }
     uint16_t allocatedLights = 0;
+    LightStore lightStore_;
     void* contiguousLightStorage = nullptr;
     size_t contiguousLightStrideBytes = 0;
     LightgraphRuntimeContext* runtimeContext_ = nullptr;
+    LightgraphRng rng_;
+    std::vector<RouteStep> routeTrace_;
+    LightArena* lightArena_ = nullptr;
+    PaletteCache* paletteCache_ = nullptr;
+    uint16_t lightTableCapacity = 0;
+    uint8_t lightKinds_ = 0;
 
 };
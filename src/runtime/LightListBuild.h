@@ -10,6 +10,7 @@
 #include "Behaviour.h"
 #include "EmitParams.h"
 #include "Light.h"
+#include "LightArena.h"
 #include "LightList.h"
 #include "../Globals.h"
 
@@ -77,6 +78,9 @@ struct Policy {
   LightgraphAllocationFailureSite listFailureSite = LightgraphAllocationFailureSite::Unknown;
   LightgraphAllocationFailureSite lightFailureSite = LightgraphAllocationFailureSite::Unknown;
   LightgraphAllocationFailureSite exceptionFailureSite = LightgraphAllocationFailureSite::Unknown;
+  // When set, lists are taken from and returned to this pool instead of the heap.
+  LightListPool* listPool = nullptr;
+  PaletteCache* paletteCache = nullptr;
 };
 
 inline Policy makePolicy(AllocationMode allocation,
@@ -104,6 +108,13 @@ inline Policy makeStateEmitPolicy() {
                     LightgraphAllocationFailureSite::StateSetupException);
 }
 
+inline Policy makeStateEmitPolicy(LightListPool& listPool, PaletteCache& paletteCache) {
+  Policy policy = makeStateEmitPolicy();
+  policy.listPool = &listPool;
+  policy.paletteCache = &paletteCache;
+  return policy;
+}
+
 inline Policy makeRemoteListPolicy(bool allocateBehaviour,
                                    AllocationMode allocation = AllocationMode::DefaultHeap) {
   return makePolicy(allocation,
@@ -312,6 +323,11 @@ inline bool applyBehaviour(LightList* list, const Spec& spec, const Policy& poli
   if (!policy.allocateBehaviour) {
     return true;
   }
+  if (list->behaviour != nullptr) {
+    // Recycled from a pool.
+    *list->behaviour = Behaviour(spec.style.behaviourFlags, spec.style.colorChangeGroups);
+    return true;
+  }
   list->behaviour = new (std::nothrow) Behaviour(spec.style.behaviourFlags, spec.style.colorChangeGroups);
   if (list->behaviour == nullptr) {
     reportAllocationFailure(
@@ -351,9 +367,9 @@ inline Light* allocateExplicitLight(LightList* list,
   if (policy.allocation == AllocationMode::ContiguousLights) {
     light = list->createContiguousLight(slot, spec.style.speed, lifeMillis, lightIdx, brightness);
   } else {
-    light = new (std::nothrow) Light(list, spec.style.speed, lifeMillis, lightIdx, brightness);
+    light = new (std::nothrow) Light(list, slot, spec.style.speed, lifeMillis, lightIdx, brightness);
     if (light != nullptr) {
-      (*list)[slot] = light;
+      list->placeLight(slot, light);
     }
   }
   if (light == nullptr) {
@@ -416,15 +432,15 @@ inline bool buildDenseSnapshot(LightList* list, const Spec& spec, const Policy&
     float position = (list->speed != 0.0f) ? static_cast<float>(i) * -1.0f
                                            : static_cast<float>(list->numLights - 1 - i);
     position += static_cast<float>(spec.positionOffset);
-    created->position = position;
+    created->setPosition(position);
 
     if (list->order == LIST_ORDER_SEQUENTIAL && list->speed > 0.0f) {
       const uint32_t delayFrames = static_cast<uint32_t>(std::ceil((1.0f / list->speed) * static_cast<float>(i)));
-      created->lifeMillis = addLifeDelayClamped(
+      created->setLifeMillis(addLifeDelayClamped(
           list->lifeMillis,
-          static_cast<uint32_t>(delayFrames * EmitParams::frameMs()));
+          static_cast<uint32_t>(delayFrames * EmitParams::frameMs())));
     } else {
-      created->lifeMillis = list->lifeMillis;
+      created->setLifeMillis(list->lifeMillis);
     }
   }
 
@@ -487,7 +503,7 @@ inline bool buildSparseSnapshot(LightList* list, const Spec& spec, const Policy&
       return false;
     }
     light->setColor(entry.color);
-    light->position = static_cast<float>(spec.positionOffset) - static_cast<float>(entry.lightIdx);
+    light->setPosition(static_cast<float>(spec.positionOffset) - static_cast<float>(entry.lightIdx));
   }
 
   return true;
@@ -510,20 +526,29 @@ inline bool buildSingleLight(LightList* list, const Spec& spec, const Policy& po
   return true;
 }
 
+inline void discardLightList(LightList* list, const Policy& policy) {
+  if (policy.listPool != nullptr) {
+    policy.listPool->release(list);
+  } else {
+    delete list;
+  }
+}
+
 inline LightList* buildLightList(const Spec& spec, const Policy& policy) {
   LightList* list = nullptr;
 #if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
   try {
 #endif
-    list = new (std::nothrow) LightList();
+    list = (policy.listPool != nullptr) ? policy.listPool->acquire() : new (std::nothrow) LightList();
     if (list == nullptr) {
       reportAllocationFailure(policy.listFailureSite, spec.numLights, spec.length);
       return nullptr;
     }
+    list->bindPaletteCache(policy.paletteCache);
 
     applyStyle(list, spec);
     if (!applyBehaviour(list, spec, policy)) {
-      delete list;
+      discardLightList(list, policy);
       return nullptr;
     }
 
@@ -546,17 +571,17 @@ inline LightList* buildLightList(const Spec& spec, const Policy& policy) {
     }
 
     if (!built) {
-      delete list;
+      discardLightList(list, policy);
       return nullptr;
     }
     return list;
 #if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
   } catch (const std::bad_alloc&) {
-    delete list;
+    discardLightList(list, policy);
     reportAllocationFailure(policy.exceptionFailureSite, spec.numLights, spec.length);
     return nullptr;
   } catch (...) {
-    delete list;
+    discardLightList(list, policy);
     reportAllocationFailure(policy.exceptionFailureSite, spec.numLights, spec.length);
     return nullptr;
   }
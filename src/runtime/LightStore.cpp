@@ -0,0 +1,119 @@
+#include "LightStore.h"
+
+#include <cstdlib>
+#include <type_traits>
+
+#include "../core/Platform.h"
+
+namespace {
+
+// Arrays start on 16-byte boundaries so the kernels can use aligned vector loads.
+constexpr size_t kArrayAlign = 16;
+
+size_t alignUp(size_t offset) {
+    return (offset + kArrayAlign - 1) & ~(kArrayAlign - 1);
+}
+
+// Lays the arrays out in `base` (or only measures them when base is null)
+// and returns the bytes used.
+size_t layout(LightStore* store, uint8_t* base, uint16_t capacity) {
+    size_t offset = 0;
+    const auto carve = [&](auto*& array) {
+        using T = typename std::remove_reference<decltype(*array)>::type;
+        offset = alignUp(offset);
+        if (base != nullptr) {
+            array = reinterpret_cast<T*>(base + offset);
+        }
+        offset += static_cast<size_t>(capacity) * sizeof(T);
+    };
+    carve(store->owner);
+    carve(store->inPort);
+    carve(store->outPort);
+    carve(store->position);
+    carve(store->speed);
+    carve(store->lifeMillis);
+    carve(store->idx);
+    carve(store->routeHop);
+    carve(store->bri);
+    carve(store->pixel1);
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+    carve(store->pixel2);
+    carve(store->pixel1Weight);
+    carve(store->pixel2Weight);
+#endif
+    carve(store->maxBri);
+    carve(store->brightness);
+    carve(store->isExpired);
+    carve(store->color);
+    return offset;
+}
+
+}  // namespace
+
+LightStore::~LightStore() {
+    clear();
+}
+
+bool LightStore::reserve(uint16_t capacity) {
+    if (capacity <= capacity_ && block_ != nullptr) {
+        return true;
+    }
+    clear();
+    if (capacity == 0) {
+        return true;
+    }
+    const size_t bytes = layout(this, nullptr, capacity);
+    block_ = std::malloc(bytes);
+    if (block_ == nullptr) {
+        LG_LOGF("LightStore::reserve failed: OOM for %u lights\n", capacity);
+        return false;
+    }
+    layout(this, static_cast<uint8_t*>(block_), capacity);
+    capacity_ = capacity;
+    ownsBlock_ = true;
+    grew_ = true;
+    return true;
+}
+
+void LightStore::assign(void* block, uint16_t capacity) {
+    clear();
+    if (block == nullptr || capacity == 0) {
+        return;
+    }
+    block_ = block;
+    layout(this, static_cast<uint8_t*>(block_), capacity);
+    capacity_ = capacity;
+}
+
+size_t LightStore::bytesFor(uint16_t capacity) {
+    LightStore probe;
+    return layout(&probe, nullptr, capacity);
+}
+
+void LightStore::clear() {
+    if (ownsBlock_) {
+        std::free(block_);
+    }
+    block_ = nullptr;
+    capacity_ = 0;
+    ownsBlock_ = false;
+    owner = nullptr;
+    inPort = nullptr;
+    outPort = nullptr;
+    position = nullptr;
+    speed = nullptr;
+    lifeMillis = nullptr;
+    idx = nullptr;
+    routeHop = nullptr;
+    bri = nullptr;
+    pixel1 = nullptr;
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+    pixel2 = nullptr;
+    pixel1Weight = nullptr;
+    pixel2Weight = nullptr;
+#endif
+    maxBri = nullptr;
+    brightness = nullptr;
+    isExpired = nullptr;
+    color = nullptr;
+}
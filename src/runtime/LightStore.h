@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "../Globals.h"
+#include "../core/Types.h"
+
+class Owner;
+class Port;
+
+/**
+ * LightStore - the per-light state of one LightList as parallel arrays
+ *
+ * Every field a light carries lives in one array per field, indexed by the
+ * light's slot in its list, so the per-frame kernels walk a few dense arrays
+ * instead of one object per light. RuntimeLight objects are views onto a
+ * slot (see RuntimeLight::store()) for owners, ports and the generic path.
+ * All arrays share one block that is kept across reserve() calls that fit:
+ * either the store's own allocation or a run of a LightArena (assign()).
+ */
+class LightStore {
+  public:
+    LightStore() = default;
+    ~LightStore();
+
+    LightStore(const LightStore&) = delete;
+    LightStore& operator=(const LightStore&) = delete;
+
+    // Makes room for `capacity` slots. Existing contents are not kept when
+    // the block grows. Returns false on OOM, leaving the store empty.
+    bool reserve(uint16_t capacity);
+    // Lays the arrays out on `block`, which the caller owns and which must
+    // hold bytesFor(capacity) bytes, 16-byte aligned.
+    void assign(void* block, uint16_t capacity);
+    // Frees the block when the store allocated it; forgets it either way.
+    void clear();
+    static size_t bytesFor(uint16_t capacity);
+
+    uint16_t capacity() const {
+        return capacity_;
+    }
+    void* block() const {
+        return block_;
+    }
+    bool ownsBlock() const {
+        return ownsBlock_;
+    }
+    // True when reserve() had to allocate since the last call; lets owners
+    // count the allocation.
+    bool takeGrowth() {
+        const bool grew = grew_;
+        grew_ = false;
+        return grew;
+    }
+
+    // Tag for the light constructors: the slot was already reset by initSlots().
+    struct SlotReady {};
+
+    // initSlot() for slots [0, count) in one pass per array, leaving idx and
+    // maxBri to the light constructors.
+    void initSlots(uint16_t count) {
+        std::fill_n(owner, count, nullptr);
+        std::fill_n(inPort, count, nullptr);
+        std::fill_n(outPort, count, nullptr);
+        std::fill_n(position, count, -1.0f);
+        std::fill_n(speed, count, DEFAULT_SPEED);
+        std::fill_n(lifeMillis, count, 0u);
+        std::fill_n(routeHop, count, static_cast<uint16_t>(0));
+        std::fill_n(bri, count, static_cast<uint16_t>(255));
+        std::fill_n(pixel1, count, static_cast<int16_t>(-1));
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+        std::fill_n(pixel2, count, static_cast<int16_t>(-1));
+        std::fill_n(pixel1Weight, count, static_cast<uint8_t>(FULL_BRIGHTNESS));
+        std::fill_n(pixel2Weight, count, static_cast<uint8_t>(0));
+#endif
+        std::fill_n(brightness, count, static_cast<uint8_t>(0));
+        std::fill_n(isExpired, count, false);
+        std::fill_n(color, count, ColorRGB(255, 255, 255));
+    }
+    // Resets one slot to the state a new light starts in.
+    void initSlot(uint16_t slot, uint16_t lightIdx, uint8_t lightMaxBri) {
+        owner[slot] = nullptr;
+        inPort[slot] = nullptr;
+        outPort[slot] = nullptr;
+        position[slot] = -1.0f;
+        speed[slot] = DEFAULT_SPEED;
+        lifeMillis[slot] = 0;
+        idx[slot] = lightIdx;
+        routeHop[slot] = 0;
+        bri[slot] = 255;
+        pixel1[slot] = -1;
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+        pixel2[slot] = -1;
+        pixel1Weight[slot] = FULL_BRIGHTNESS;
+        pixel2Weight[slot] = 0;
+#endif
+        maxBri[slot] = lightMaxBri;
+        brightness[slot] = 0;
+        isExpired[slot] = false;
+        color[slot] = ColorRGB(255, 255, 255);
+    }
+
+    const Owner** owner = nullptr;
+    Port** inPort = nullptr;
+    Port** outPort = nullptr;
+    float* position = nullptr;
+    float* speed = nullptr;          // Light only; RuntimeLight uses its list's speed
+    uint32_t* lifeMillis = nullptr;  // for RuntimeLight this is offsetMillis
+    uint16_t* idx = nullptr;
+    // Intersection routing decisions made so far; indexes the list's route trace.
+    uint16_t* routeHop = nullptr;
+    uint16_t* bri = nullptr;
+    int16_t* pixel1 = nullptr;
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+    int16_t* pixel2 = nullptr;
+    uint8_t* pixel1Weight = nullptr;
+    uint8_t* pixel2Weight = nullptr;
+#endif
+    uint8_t* maxBri = nullptr;
+    uint8_t* brightness = nullptr;
+    bool* isExpired = nullptr;
+    ColorRGB* color = nullptr;       // Light only
+
+  private:
+    void* block_ = nullptr;
+    uint16_t capacity_ = 0;
+    bool ownsBlock_ = false;
+    bool grew_ = false;
+};
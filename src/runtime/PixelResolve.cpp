@@ -0,0 +1,330 @@
+#include "PixelResolve.h"
+
+#include <cstddef>
+
+#if LIGHTGRAPH_SIMD_RESOLVE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LG_RESOLVE_SSE2 1
+#include <emmintrin.h>
+#if defined(__AVX2__) || defined(__GNUC__)
+#define LG_RESOLVE_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+#if (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define LG_RESOLVE_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+// The vector kernels reproduce resolveChannel() exactly:
+//  - accumulated / div is computed as a truncated float quotient. Both
+//    operands are below 2^16, so whenever the exact quotient is below 256 it
+//    is at least 1/255 away from the next integer while the float rounding
+//    error is below 2^-16; truncation therefore matches integer division.
+//  - (c * maxBrightness + 127) / 255 uses x / 255 == (x + 1 + (x >> 8)) >> 8,
+//    which holds for every x <= 65152 + 127.
+//  - div == 0 pixels are masked to black, like getPixel().
+
+namespace pixel_resolve {
+
+namespace {
+
+void resolveScalarRange(const Planes& planes,
+                        size_t begin,
+                        size_t end,
+                        uint8_t maxBrightness,
+                        uint8_t* rgb) {
+    for (size_t i = begin; i < end; i++) {
+        uint8_t* const out = rgb + i * 3u;
+        const uint8_t div = planes.div[i];
+        if (div == 0) {
+            out[0] = 0;
+            out[1] = 0;
+            out[2] = 0;
+            continue;
+        }
+        out[0] = resolveChannel(planes.r[i], div, maxBrightness);
+        out[1] = resolveChannel(planes.g[i], div, maxBrightness);
+        out[2] = resolveChannel(planes.b[i], div, maxBrightness);
+    }
+}
+
+#ifdef LG_RESOLVE_SSE2
+
+void interleave(const uint8_t* r,
+                const uint8_t* g,
+                const uint8_t* b,
+                size_t lanes,
+                uint8_t* out) {
+    for (size_t lane = 0; lane < lanes; lane++) {
+        out[lane * 3u] = r[lane];
+        out[lane * 3u + 1u] = g[lane];
+        out[lane * 3u + 2u] = b[lane];
+    }
+}
+
+inline __m128i scaleSse2(__m128i average, __m128i scale) {
+    const __m128i x = _mm_add_epi16(_mm_mullo_epi16(average, scale), _mm_set1_epi16(127));
+    const __m128i sum = _mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8));
+    return _mm_srli_epi16(sum, 8);
+}
+
+inline __m128i resolveLanesSse2(const uint16_t* values,
+                                __m128 divLo,
+                                __m128 divHi,
+                                __m128i scale,
+                                __m128i emptyMask) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 limit = _mm_set1_ps(255.0f);
+    const __m128i accumulated = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    const __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(accumulated, zero));
+    const __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(accumulated, zero));
+    const __m128i averageLo = _mm_cvttps_epi32(_mm_min_ps(_mm_div_ps(lo, divLo), limit));
+    const __m128i averageHi = _mm_cvttps_epi32(_mm_min_ps(_mm_div_ps(hi, divHi), limit));
+    const __m128i scaled = scaleSse2(_mm_packs_epi32(averageLo, averageHi), scale);
+    return _mm_packus_epi16(_mm_andnot_si128(emptyMask, scaled), zero);
+}
+
+void resolveSse2(const Planes& planes, uint16_t count, uint8_t maxBrightness, uint8_t* rgb) {
+    constexpr size_t kLanes = 8;
+    const size_t vectorEnd = count - (count % kLanes);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i scale = _mm_set1_epi16(maxBrightness);
+    alignas(16) uint8_t r[16];
+    alignas(16) uint8_t g[16];
+    alignas(16) uint8_t b[16];
+
+    for (size_t i = 0; i < vectorEnd; i += kLanes) {
+        const __m128i div8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(planes.div + i));
+        const __m128i div16 = _mm_unpacklo_epi8(div8, zero);
+        const __m128 divLo = _mm_max_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(div16, zero)), one);
+        const __m128 divHi = _mm_max_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(div16, zero)), one);
+        const __m128i emptyMask = _mm_cmpeq_epi16(div16, zero);
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(r),
+                        resolveLanesSse2(planes.r + i, divLo, divHi, scale, emptyMask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(g),
+                        resolveLanesSse2(planes.g + i, divLo, divHi, scale, emptyMask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(b),
+                        resolveLanesSse2(planes.b + i, divLo, divHi, scale, emptyMask));
+        interleave(r, g, b, kLanes, rgb + i * 3u);
+    }
+    resolveScalarRange(planes, vectorEnd, count, maxBrightness, rgb);
+}
+
+#endif
+
+#ifdef LG_RESOLVE_AVX2
+
+#if defined(__AVX2__)
+#define LG_RESOLVE_AVX2_TARGET
+#else
+#define LG_RESOLVE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+LG_RESOLVE_AVX2_TARGET inline __m256i resolveLanesAvx2(const uint16_t* values,
+                                                       __m256 divLo,
+                                                       __m256 divHi,
+                                                       __m256i scale,
+                                                       __m256i emptyMask) {
+    const __m256 limit = _mm256_set1_ps(255.0f);
+    const __m128i accumulatedLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    const __m128i accumulatedHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 8));
+    const __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(accumulatedLo));
+    const __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(accumulatedHi));
+    const __m256i averageLo = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_div_ps(lo, divLo), limit));
+    const __m256i averageHi = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_div_ps(hi, divHi), limit));
+    // packs works per 128-bit lane; restore pixel order before the 16-bit math.
+    const __m256i average =
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(averageLo, averageHi), 0xD8);
+    const __m256i x =
+        _mm256_add_epi16(_mm256_mullo_epi16(average, scale), _mm256_set1_epi16(127));
+    const __m256i sum =
+        _mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8));
+    const __m256i scaled = _mm256_andnot_si256(emptyMask, _mm256_srli_epi16(sum, 8));
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(scaled, _mm256_setzero_si256()), 0xD8);
+}
+
+LG_RESOLVE_AVX2_TARGET void resolveAvx2(const Planes& planes,
+                                        uint16_t count,
+                                        uint8_t maxBrightness,
+                                        uint8_t* rgb) {
+    constexpr size_t kLanes = 16;
+    const size_t vectorEnd = count - (count % kLanes);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i scale = _mm256_set1_epi16(maxBrightness);
+    alignas(16) uint8_t r[16];
+    alignas(16) uint8_t g[16];
+    alignas(16) uint8_t b[16];
+
+    for (size_t i = 0; i < vectorEnd; i += kLanes) {
+        const __m128i div8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes.div + i));
+        const __m256 divLo = _mm256_max_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(div8)), one);
+        const __m256 divHi =
+            _mm256_max_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(div8, 8))), one);
+        const __m256i emptyMask =
+            _mm256_cmpeq_epi16(_mm256_cvtepu8_epi16(div8), _mm256_setzero_si256());
+
+        _mm_store_si128(reinterpret_cast<__m128i*>(r),
+                        _mm256_castsi256_si128(
+                            resolveLanesAvx2(planes.r + i, divLo, divHi, scale, emptyMask)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(g),
+                        _mm256_castsi256_si128(
+                            resolveLanesAvx2(planes.g + i, divLo, divHi, scale, emptyMask)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(b),
+                        _mm256_castsi256_si128(
+                            resolveLanesAvx2(planes.b + i, divLo, divHi, scale, emptyMask)));
+        interleave(r, g, b, kLanes, rgb + i * 3u);
+    }
+    resolveScalarRange(planes, vectorEnd, count, maxBrightness, rgb);
+}
+
+bool cpuHasAvx2() {
+#if defined(__AVX2__)
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+#endif
+}
+
+#endif
+
+#ifdef LG_RESOLVE_NEON
+
+inline uint8x8_t resolveLanesNeon(const uint16_t* values,
+                                  float32x4_t divLo,
+                                  float32x4_t divHi,
+                                  uint16x8_t scale,
+                                  uint16x8_t emptyMask) {
+    const float32x4_t limit = vdupq_n_f32(255.0f);
+    const uint16x8_t accumulated = vld1q_u16(values);
+    const float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(accumulated)));
+    const float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(accumulated)));
+    const uint32x4_t averageLo = vcvtq_u32_f32(vminq_f32(vdivq_f32(lo, divLo), limit));
+    const uint32x4_t averageHi = vcvtq_u32_f32(vminq_f32(vdivq_f32(hi, divHi), limit));
+    const uint16x8_t average = vcombine_u16(vmovn_u32(averageLo), vmovn_u32(averageHi));
+    const uint16x8_t x = vmlaq_u16(vdupq_n_u16(127), average, scale);
+    const uint16x8_t sum = vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8));
+    return vmovn_u16(vbicq_u16(vshrq_n_u16(sum, 8), emptyMask));
+}
+
+void resolveNeon(const Planes& planes, uint16_t count, uint8_t maxBrightness, uint8_t* rgb) {
+    constexpr size_t kLanes = 8;
+    const size_t vectorEnd = count - (count % kLanes);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const uint16x8_t scale = vdupq_n_u16(maxBrightness);
+
+    for (size_t i = 0; i < vectorEnd; i += kLanes) {
+        const uint16x8_t div16 = vmovl_u8(vld1_u8(planes.div + i));
+        const float32x4_t divLo = vmaxq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(div16))), one);
+        const float32x4_t divHi = vmaxq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(div16))), one);
+        const uint16x8_t emptyMask = vceqq_u16(div16, vdupq_n_u16(0));
+
+        uint8x8x3_t pixels;
+        pixels.val[0] = resolveLanesNeon(planes.r + i, divLo, divHi, scale, emptyMask);
+        pixels.val[1] = resolveLanesNeon(planes.g + i, divLo, divHi, scale, emptyMask);
+        pixels.val[2] = resolveLanesNeon(planes.b + i, divLo, divHi, scale, emptyMask);
+        vst3_u8(rgb + i * 3u, pixels);
+    }
+    resolveScalarRange(planes, vectorEnd, count, maxBrightness, rgb);
+}
+
+#endif
+
+} // namespace
+
+bool isKernelAvailable(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+    case Kernel::Sse2:
+#ifdef LG_RESOLVE_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case Kernel::Avx2:
+#ifdef LG_RESOLVE_AVX2
+        return cpuHasAvx2();
+#else
+        return false;
+#endif
+    case Kernel::Neon:
+#ifdef LG_RESOLVE_NEON
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+Kernel activeKernel() {
+    if (isKernelAvailable(Kernel::Avx2)) {
+        return Kernel::Avx2;
+    }
+    if (isKernelAvailable(Kernel::Sse2)) {
+        return Kernel::Sse2;
+    }
+    if (isKernelAvailable(Kernel::Neon)) {
+        return Kernel::Neon;
+    }
+    return Kernel::Scalar;
+}
+
+const char* kernelName(Kernel kernel) {
+    switch (kernel) {
+    case Kernel::Scalar:
+        return "scalar";
+    case Kernel::Sse2:
+        return "sse2";
+    case Kernel::Avx2:
+        return "avx2";
+    case Kernel::Neon:
+        return "neon";
+    }
+    return "unknown";
+}
+
+void resolve(const Planes& planes, uint16_t count, uint8_t maxBrightness, uint8_t* rgb) {
+    static const Kernel kernel = activeKernel();
+    resolveWith(kernel, planes, count, maxBrightness, rgb);
+}
+
+void resolveWith(Kernel kernel,
+                 const Planes& planes,
+                 uint16_t count,
+                 uint8_t maxBrightness,
+                 uint8_t* rgb) {
+    if (rgb == nullptr || count == 0) {
+        return;
+    }
+    if (!isKernelAvailable(kernel)) {
+        kernel = Kernel::Scalar;
+    }
+    switch (kernel) {
+#ifdef LG_RESOLVE_AVX2
+    case Kernel::Avx2:
+        resolveAvx2(planes, count, maxBrightness, rgb);
+        return;
+#endif
+#ifdef LG_RESOLVE_SSE2
+    case Kernel::Sse2:
+        resolveSse2(planes, count, maxBrightness, rgb);
+        return;
+#endif
+#ifdef LG_RESOLVE_NEON
+    case Kernel::Neon:
+        resolveNeon(planes, count, maxBrightness, rgb);
+        return;
+#endif
+    default:
+        resolveScalarRange(planes, 0, count, maxBrightness, rgb);
+        return;
+    }
+}
+
+} // namespace pixel_resolve
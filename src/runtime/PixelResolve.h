@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+#ifndef LIGHTGRAPH_SIMD_RESOLVE
+#define LIGHTGRAPH_SIMD_RESOLVE 1
+#endif
+
+// Whole-frame resolve of the State accumulators into packed RGB.
+// Every kernel is bit-exact with resolveChannel(), which is also what
+// State::getPixel() uses for single pixels.
+namespace pixel_resolve {
+
+enum class Kernel : uint8_t {
+    Scalar = 0,
+    Sse2 = 1,
+    Avx2 = 2,
+    Neon = 3,
+};
+
+struct Planes {
+    const uint16_t* r = nullptr;
+    const uint16_t* g = nullptr;
+    const uint16_t* b = nullptr;
+    const uint8_t* div = nullptr;
+};
+
+inline uint8_t resolveChannel(uint16_t accumulated, uint8_t div, uint8_t maxBrightness) {
+    const uint16_t average = static_cast<uint16_t>(accumulated / div);
+    const uint16_t clamped = average > 255 ? 255 : average;
+    return static_cast<uint8_t>((clamped * maxBrightness + 127u) / 255u);
+}
+
+// True when `kernel` was compiled in and is supported by the running CPU.
+bool isKernelAvailable(Kernel kernel);
+// Widest available kernel; Scalar when LIGHTGRAPH_SIMD_RESOLVE is 0.
+Kernel activeKernel();
+const char* kernelName(Kernel kernel);
+
+// Writes `count` pixels (3 bytes each) to `rgb` using the active kernel.
+void resolve(const Planes& planes, uint16_t count, uint8_t maxBrightness, uint8_t* rgb);
+// Same as resolve() with an explicit kernel; unavailable kernels fall back
+// to Scalar. Intended for parity tests and benchmarks.
+void resolveWith(Kernel kernel,
+                 const Planes& planes,
+                 uint16_t count,
+                 uint8_t maxBrightness,
+                 uint8_t* rgb);
+
+} // namespace pixel_resolve
@@ -48,11 +48,11 @@ inline void normalizeSnapshotList(LightList* list) {
         if (light == nullptr) {
             continue;
         }
-        light->owner = nullptr;
-        light->isExpired = false;
+        light->setOwner(nullptr);
+        light->setExpired(false);
         light->setInPort(nullptr);
         light->setOutPort(nullptr);
-        light->lifeMillis = list->lifeMillis;
+        light->setLifeMillis(list->lifeMillis);
     }
 }
 
@@ -4,6 +4,7 @@
 #include "../core/Types.h"
 #include "../core/Limits.h"
 #include "../../vendor/ofxEasing/ofxEasing.h"
+#include "LightStore.h"
 #include <cstddef>
 
 class LightList;
@@ -17,36 +18,55 @@ class RuntimeLight
 
   public:
 
-    uint16_t idx;
-    uint8_t maxBri;
     LightList *list;
-    Port *inPort = 0;
-    Port *outPort = 0;
-    Port *outPorts[OUT_PORTS_MEMORY] = {0}; // 4 bytes * 7
-    int8_t outPortsInt[OUT_PORTS_MEMORY] = {-1};
-    int16_t pixel1 = -1;
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
-    uint8_t pixel1Weight = FULL_BRIGHTNESS;
-    int16_t pixel2 = -1;
-    uint8_t pixel2Weight = 0;
-#endif
-    bool isExpired = false;
-    float position;
-    uint16_t bri = 255;
-    uint8_t brightness = 0;
-    const Owner *owner = 0;
-    uint32_t lifeMillis = 0; // for RuntimeLight this is offsetMillis
+    // Where this light's fields live: the list's LightStore at `slot`.
+    LightStore *store;
+    uint16_t slot;
 
-    RuntimeLight(LightList* const list, uint16_t idx = 0, uint8_t maxBri = 255) : idx(idx), maxBri(maxBri), list(list) {
-        position = -1;
-    }
+    // The list must have reserved `slot` (LightList::init).
+    RuntimeLight(LightList* const list, uint16_t slot, uint16_t idx = 0, uint8_t maxBri = 255);
+    // For a slot the list already reset with LightStore::initSlots().
+    RuntimeLight(LightList* const list, uint16_t slot, uint16_t idx, uint8_t maxBri, LightStore::SlotReady);
     virtual ~RuntimeLight() = default;
 
+    // Fields, read from and written to the store at `slot`.
+    float position() const { return store->position[slot]; }
+    void setPosition(float value) { store->position[slot] = value; }
+    uint32_t lifeMillis() const { return store->lifeMillis[slot]; } // for RuntimeLight this is offsetMillis
+    void setLifeMillis(uint32_t value) { store->lifeMillis[slot] = value; }
+    uint16_t idx() const { return store->idx[slot]; }
+    void setIdx(uint16_t value) { store->idx[slot] = value; }
+    uint16_t routeHop() const { return store->routeHop[slot]; }
+    void setRouteHop(uint16_t value) { store->routeHop[slot] = value; }
+    uint16_t bri() const { return store->bri[slot]; }
+    void setBri(uint16_t value) { store->bri[slot] = value; }
+    int16_t pixel1() const { return store->pixel1[slot]; }
+    void setPixel1(int16_t value) { store->pixel1[slot] = value; }
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+    int16_t pixel2() const { return store->pixel2[slot]; }
+    void setPixel2(int16_t value) { store->pixel2[slot] = value; }
+    uint8_t pixel1Weight() const { return store->pixel1Weight[slot]; }
+    void setPixel1Weight(uint8_t value) { store->pixel1Weight[slot] = value; }
+    uint8_t pixel2Weight() const { return store->pixel2Weight[slot]; }
+    void setPixel2Weight(uint8_t value) { store->pixel2Weight[slot] = value; }
+#endif
+    uint8_t maxBri() const { return store->maxBri[slot]; }
+    void setMaxBri(uint8_t value) { store->maxBri[slot] = value; }
+    uint8_t brightness() const { return store->brightness[slot]; }
+    void setBrightness(uint8_t value) { store->brightness[slot] = value; }
+    bool isExpired() const { return store->isExpired[slot]; }
+    void setExpired(bool value) { store->isExpired[slot] = value; }
+    const Owner* owner() const { return store->owner[slot]; }
+    void setOwner(const Owner* value) { store->owner[slot] = value; }
+    Port* inPort() const { return store->inPort[slot]; }
+    Port* outPort() const { return store->outPort[slot]; }
+
     void setInPort(Port* const port) {
-      inPort = port;
+      store->inPort[slot] = port;
+    }
+    void setOutPort(Port* const port) {
+      store->outPort[slot] = port;
     }
-    Port* getOutPort(uint8_t intersectionId) const;
-    void setOutPort(Port* const port, int8_t intersectionId = -1);
     void resetPixels();
     void update();
     virtual void nextFrame();
@@ -64,12 +84,16 @@ class RuntimeLight
     virtual ColorRGB getColor() const;
     virtual void setColor(ColorRGB /*color*/) {}
     virtual uint8_t getBrightness() const;
+    // getBrightness() on plain values, for the list kernels.
+    static uint8_t brightnessFor(uint16_t bri, uint8_t maxBri, const LightList* list);
     virtual ColorRGB getPixelColorAt(int16_t pixel) const;
     virtual ColorRGB getPixelColor() const;
     uint16_t writePixels(uint16_t* buffer, size_t capacity) const;
     uint16_t getListId() const;
     LightgraphRuntimeContext& runtimeContext();
     const LightgraphRuntimeContext& runtimeContext() const;
+    // The owning list's stream; the thread's active generator without a list.
+    LightgraphRng& random() const;
     void setRenderedPixel(uint16_t pixel);
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
     void setRenderedPixelWeighted(uint16_t pixel, uint8_t weight);
@@ -82,8 +106,11 @@ class RuntimeLight
     uint8_t getPrimaryPixelWeight() const;
 #endif
 
-  private:
-    uint16_t setPixel1(uint16_t* buffer, size_t capacity) const;
+    // The span writers behind writePixels(), for callers that already know
+    // the behaviour; both expect pixel1 >= 0.
     uint16_t setSegmentPixels(uint16_t* buffer, size_t capacity) const;
     uint16_t setLinkPixels(uint16_t* buffer, size_t capacity) const;
+
+  private:
+    uint16_t setPixel1(uint16_t* buffer, size_t capacity) const;
 };
@@ -1,8 +1,10 @@
 #include "State.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <new>
+#include <type_traits>
 
 #include "../core/Platform.h"
 #include "../topology/TopologyObject.h"
@@ -10,8 +12,12 @@
 #include "Behaviour.h"
 #include "BgLight.h"
 #include "EmitParams.h"
+#include "Light.h"
+#include "LightKernels.h"
 #include "LightListBuild.h"
 #include "LightList.h"
+#include "PixelResolve.h"
+#include "../rendering/Blend.h"
 #include "../rendering/Palettes.h"
 #include "../Globals.h"
 
@@ -19,8 +25,6 @@
 #include <ArduinoOSC.h>
 #endif
 
-EmitParams State::autoParams(EmitParams::DEFAULT_MODEL, RANDOM_SPEED);
-
 namespace {
 
 uint8_t clampReservedTailSlots(uint8_t slots) {
@@ -40,8 +44,54 @@ ColorRGB scaleColorByWeight(const ColorRGB& color, uint8_t weight) {
         static_cast<uint8_t>((static_cast<uint16_t>(color.B) * weight + 127u) / 255u));
 }
 
+bool hasMirror(const LightList* lightList) {
+    return lightList != NULL && lightList->behaviour != NULL &&
+           (lightList->behaviour->mirrorFlip() || lightList->behaviour->mirrorRotate());
+}
+
 } // namespace
 
+ListLayer::ListLayer(uint16_t pixelCount)
+    : valuesR(pixelCount, 0),
+      valuesG(pixelCount, 0),
+      valuesB(pixelCount, 0) {
+    touchedPixels.reserve(pixelCount);
+}
+
+void ListLayer::add(uint16_t pixel, const ColorRGB& color) {
+    if (pixel >= valuesR.size()) {
+        return;
+    }
+    if (color.R == 0 && color.G == 0 && color.B == 0) {
+        return;
+    }
+
+    if (valuesR[pixel] == 0 && valuesG[pixel] == 0 && valuesB[pixel] == 0) {
+        touchedPixels.push_back(pixel);
+    }
+
+    valuesR[pixel] = std::min<uint16_t>(
+        FULL_BRIGHTNESS,
+        static_cast<uint16_t>(valuesR[pixel] + color.R));
+    valuesG[pixel] = std::min<uint16_t>(
+        FULL_BRIGHTNESS,
+        static_cast<uint16_t>(valuesG[pixel] + color.G));
+    valuesB[pixel] = std::min<uint16_t>(
+        FULL_BRIGHTNESS,
+        static_cast<uint16_t>(valuesB[pixel] + color.B));
+}
+
+ColorRGB ListLayer::take(uint16_t pixel) {
+    const ColorRGB color(
+        static_cast<uint8_t>(std::min<uint16_t>(valuesR[pixel], FULL_BRIGHTNESS)),
+        static_cast<uint8_t>(std::min<uint16_t>(valuesG[pixel], FULL_BRIGHTNESS)),
+        static_cast<uint8_t>(std::min<uint16_t>(valuesB[pixel], FULL_BRIGHTNESS)));
+    valuesR[pixel] = 0;
+    valuesG[pixel] = 0;
+    valuesB[pixel] = 0;
+    return color;
+}
+
 State::State(TopologyObject& obj)
     : object(obj),
       pixelValuesR(obj.pixelCount, 0),
@@ -49,16 +99,14 @@ State::State(TopologyObject& obj)
       pixelValuesB(obj.pixelCount, 0),
       pixelDiv(obj.pixelCount, 0),
       renderPixelScratch(static_cast<size_t>(obj.pixelCount) + 3u, 0)
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
+#if LIGHTGRAPH_LAYER_COMPOSITING
       ,
-      listPixelValuesR(obj.pixelCount, 0),
-      listPixelValuesG(obj.pixelCount, 0),
-      listPixelValuesB(obj.pixelCount, 0)
+      listLayer(obj.pixelCount)
 #endif
 {
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
-    listTouchedPixels.reserve(obj.pixelCount);
-#endif
+    touchedPixels.reserve(obj.pixelCount);
+    previousTouchedPixels.reserve(obj.pixelCount);
+    lightArena.reserveStorage();
     setupBg(0);
 }
 
@@ -72,22 +120,24 @@ State::~State() {
 }
 
 uint8_t State::randomModel() {
-  return floor(LG_RANDOM(object.models.size()));
+  return Random::below(object.models.size());
 }
 
 ColorRGB State::paletteColor(uint8_t index, uint8_t /*maxBrightness*/) {
-    Palette palette = getPalette(currentPalette);
+    const Palette palette = getPalette(currentPalette);
     return Palette::wrapColors(index, 60, palette.getRGBColors(), palette.getWrapMode());
 }
 
 void State::autoEmit(unsigned long ms) {
     if (autoEnabled && nextEmit <= ms) {
+        Random::Scope random(object.runtimeContext().rng);
         emit(autoParams);
         nextEmit = ms + Random::randomNextEmit();
     }
 }
 
 int8_t State::emit(EmitParams &params) {
+    Random::Scope random(object.runtimeContext().rng);
     uint8_t which = params.model >= 0 ? params.model : randomModel();
     Model *model = object.getModel(which);
     if (model == NULL) {
@@ -109,7 +159,7 @@ int8_t State::emit(EmitParams &params) {
         Owner *emitter = getEmitter(model, replacement->behaviour, params);
         if (emitter == NULL) {
             LG_LOGF("emit failed, no free emitter %d %d.\n", params.getEmit(), params.getEmitGroups(model->emitGroups));
-            delete replacement;
+            releaseList(replacement);
             return -1;
         }
         if (hadCountedList) {
@@ -122,9 +172,7 @@ int8_t State::emit(EmitParams &params) {
                 totalLightLists--;
             }
         }
-        if (existing != NULL) {
-            delete existing;
-        }
+        releaseList(existing);
         lightLists[index] = replacement;
         doEmit(emitter, replacement, params);
         #ifdef LG_OSC_REPLY
@@ -174,32 +222,34 @@ LightList* State::setupListFrom(uint8_t i, EmitParams &params) {
     }
 
     const lightlist_build::Spec spec = lightlist_build::makeSpecFromEmitParams(params, newLen);
-    return lightlist_build::buildLightList(spec, lightlist_build::makeStateEmitPolicy());
+    return lightlist_build::buildLightList(spec, lightlist_build::makeStateEmitPolicy(lightListPool, paletteCache));
 }
 
 Owner* State::getEmitter(Model* model, Behaviour* behaviour, EmitParams& params) {
     if (model == NULL || behaviour == NULL) {
         return NULL;
     }
-    int8_t from = params.getEmit();
+    const int8_t requested = params.getEmit();
     if (behaviour->emitFromConnection()) {
         uint8_t emitGroups = params.emitGroups;
-        uint8_t connCount = object.countConnections(emitGroups);
+        uint16_t connCount = object.countConnections(emitGroups);
         if (connCount == 0) {
             LG_LOGF("emit failed, no connections for groups %d\n", emitGroups);
             return NULL;
         }
-        from = from >= 0 ? from : LG_RANDOM(connCount);
+        const uint16_t from = requested >= 0 ? static_cast<uint16_t>(requested)
+                                             : static_cast<uint16_t>(Random::below(connCount));
         return object.getConnection(from % connCount, emitGroups);
     }
     else {
         uint8_t emitGroups = params.getEmitGroups(model->emitGroups);
-        uint8_t interCount = object.countEmittableIntersections(emitGroups);
+        uint16_t interCount = object.countEmittableIntersections(emitGroups);
         if (interCount == 0) {
             LG_LOGF("emit failed, no intersections for groups %d\n", emitGroups);
             return NULL;
         }
-        from = from >= 0 ? from : LG_RANDOM(interCount);
+        const uint16_t from = requested >= 0 ? static_cast<uint16_t>(requested)
+                                             : static_cast<uint16_t>(Random::below(interCount));
         return object.getEmittableIntersection(from % interCount, emitGroups);
     }
 }
@@ -209,6 +259,8 @@ void State::activateList(Owner* from, LightList *lightList, uint8_t emitOffset,
         return;
     }
     lightList->bindRuntimeContext(object.runtimeContext());
+    lightList->random().seed(object.runtimeContext().rng.next64());
+    Random::Scope random(lightList->random());
     if (lightList->duration > 0) {
         // Rebase finite durations against the bound topology clock. Lists are
         // constructed before they have a runtime context, so without this they
@@ -246,59 +298,209 @@ void State::update() {
 
 void State::updatePass(bool renderStep) {
   if (renderStep) {
-    std::fill(pixelValuesR.begin(), pixelValuesR.end(), 0);
-    std::fill(pixelValuesG.begin(), pixelValuesG.end(), 0);
-    std::fill(pixelValuesB.begin(), pixelValuesB.end(), 0);
-    std::fill(pixelDiv.begin(), pixelDiv.end(), 0);
+    clearTouchedPixels();
   }
 
+#if LIGHTGRAPH_PARALLEL_UPDATE
+  if (updateWorkers != nullptr) {
+    updatePassParallel(renderStep);
+    return;
+  }
+#endif
   for (uint8_t i=0; i<MAX_LIGHT_LISTS; i++) {
-    LightList* lightList = lightLists[i];
-    if (lightList == NULL) continue;
-
-    bool allExpired = lightList->update();
-    if (allExpired) {
-      // Keep slot 0 allocated for background, but make it non-visible once expired.
-          if (i == 0) {
-              lightList->visible = false;
-              continue;
-          }
-          clearListSlot(i);
-        }
-        else if (lightList->visible) {
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
+    updateSlot(i, renderStep);
+  }
+}
+
+void State::updateSlot(uint8_t slot, bool renderStep) {
+    LightList* lightList = lightLists[slot];
+    if (lightList == NULL) return;
+    Random::Scope random(lightList->random());
+
+    if (retireIfExpired(slot, lightList->update()) || !lightList->visible) {
+      return;
+    }
+    // Check if the lightList is a BgLight
+    if (lightList->editable && lightList->numLights == 0) {
       if (renderStep) {
-        beginListRender(lightList);
-      }
+        // A background writes every pixel exactly once, so it is already a
+        // flat layer and can be composited without the scratch round trip.
+        for (uint16_t p = 0; p < object.pixelCount; p++) {
+            ColorRGB color = lightList->getColor(p);
+#if LIGHTGRAPH_LAYER_COMPOSITING
+            if (color.R == 0 && color.G == 0 && color.B == 0) continue;
+            setFramePixel(p, color, lightList);
+#else
+            setPixel(p, color, lightList);
 #endif
-      // Check if the lightList is a BgLight
-      if (lightList->editable && lightList->numLights == 0) {
-        if (renderStep) {
-          for (uint16_t p = 0; p < object.pixelCount; p++) {
-              ColorRGB color = lightList->getColor(p);
-              setPixel(p, color, lightList);
-          }
         }
       }
-      else {
-        // Normal light list processing
-        for (uint16_t j=0; j<lightList->numLights; j++) {
-            RuntimeLight* light = lightList->lights[j];
-            if (light == NULL) continue;
-            if (renderStep) {
-              updateLight(light);
-            } else {
-              light->nextFrame();
-            }
-        }
+      return;
+    }
+#if LIGHTGRAPH_LAYER_COMPOSITING
+    if (renderStep) {
+      beginListRender(lightList);
+    }
+#endif
+    // Normal light list processing
+    updateListLights(lightList, renderStep, renderLayer(), renderPixelScratch);
+#if LIGHTGRAPH_LAYER_COMPOSITING
+    if (renderStep) {
+      endListRender(lightList);
+    }
+#endif
+}
+
+bool State::retireIfExpired(uint8_t slot, bool allExpired) {
+    if (!allExpired) {
+      return false;
+    }
+    // Keep slot 0 allocated for background, but make it non-visible once expired.
+    if (slot == 0) {
+      lightLists[slot]->visible = false;
+      return true;
+    }
+    clearListSlot(slot);
+    return true;
+}
+
+bool State::setUpdateThreads(uint8_t threads) {
+    if (threads == 0) {
+      return false;
+    }
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    if (threads == getUpdateThreads()) {
+      return true;
+    }
+    if (threads == 1) {
+      updateWorkers.reset();
+      workerScratch.clear();
+      return true;
+    }
+    std::unique_ptr<UpdateWorkers> workers(new (std::nothrow) UpdateWorkers(threads));
+    if (workers == nullptr) {
+      LG_LOGF("State::setUpdateThreads failed: OOM for %u threads\n", threads);
+      return false;
+    }
+    updateWorkers.reset();
+    workerScratch.clear();
+    workerScratch.reserve(threads);
+    for (uint8_t i = 0; i < threads; i++) {
+      workerScratch.push_back(WorkerScratch{ListLayer(object.pixelCount),
+                                            std::vector<uint16_t>(renderPixelScratch.size(), 0)});
+    }
+    updateWorkers = std::move(workers);
+    return true;
+#else
+    return threads == 1;
+#endif
+}
+
+uint8_t State::getUpdateThreads() const {
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    return (updateWorkers != nullptr) ? updateWorkers->size() : 1;
+#else
+    return 1;
+#endif
+}
+
+#if LIGHTGRAPH_PARALLEL_UPDATE
+bool State::isParallelSafe(const LightList* lightList) const {
+    // Mirrored pixels come from a scratch buffer in the object and the generic
+    // per-light path renders through State's own layer, so both stay serial.
+    const uint8_t kinds = lightList->lightKinds();
+    return specializedLightUpdate &&
+           (kinds == LIGHT_KIND_LIGHT || kinds == LIGHT_KIND_RUNTIME) &&
+           !(lightList->editable && lightList->numLights == 0) &&
+           !hasMirror(lightList);
+}
+
+// Lists only share the arena (which locks) and the frame, so they advance
+// concurrently, each rendering into its worker's layer. The layers are then
+// blended in slot order exactly as endListRender() would, so the frame is
+// the same as a serial pass. External send hooks are not required to be
+// thread-safe, so a topology with external ports updates serially. Routing
+// tables are compiled up front so workers only read them.
+void State::updatePassParallel(bool renderStep) {
+    uint8_t count = 0;
+    const bool allowParallel = !object.hasExternalPorts();
+    for (uint8_t i = 0; i < MAX_LIGHT_LISTS; i++) {
+      slotIsParallel[i] = allowParallel && lightLists[i] != NULL && isParallelSafe(lightLists[i]);
+      if (slotIsParallel[i]) {
+        parallelSlots[count++] = i;
       }
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
-      if (renderStep) {
-        endListRender(lightList);
+    }
+    parallelRenderStep = renderStep;
+    if (count > 1) {
+      object.compileRoutes();
+    }
+    updateWorkers->run(count, &State::updateParallelSlot, this);
+
+    for (uint8_t i = 0; i < MAX_LIGHT_LISTS; i++) {
+      if (!slotIsParallel[i]) {
+        updateSlot(i, renderStep);
+        continue;
+      }
+      LightList* const lightList = lightLists[i];
+      SlotResult& result = slotResults[i];
+      if (retireIfExpired(i, result.allExpired) || !lightList->visible || !renderStep) {
+        continue;
+      }
+      for (size_t k = 0; k < result.pixels.size(); k++) {
+        setFramePixel(result.pixels[k], result.colors[k], lightList);
+      }
+    }
+}
+
+void State::updateParallelSlot(void* context, uint8_t worker, uint16_t item) {
+    State& state = *static_cast<State*>(context);
+    const uint8_t slot = state.parallelSlots[item];
+    LightList* const lightList = state.lightLists[slot];
+    SlotResult& result = state.slotResults[slot];
+    WorkerScratch& scratch = state.workerScratch[worker];
+    const bool renderStep = state.parallelRenderStep;
+
+    Random::Scope random(lightList->random());
+    result.pixels.clear();
+    result.colors.clear();
+    result.allExpired = lightList->update();
+    if (result.allExpired || !lightList->visible) {
+      return;
+    }
+    state.updateListLights(lightList, renderStep, renderStep ? &scratch.layer : nullptr, scratch.spanPixels);
+    if (!renderStep) {
+      return;
+    }
+    ListLayer& layer = scratch.layer;
+    for (uint16_t pixel : layer.touchedPixels) {
+      const ColorRGB color = layer.take(pixel);
+      if (color.R != 0 || color.G != 0 || color.B != 0) {
+        result.pixels.push_back(pixel);
+        result.colors.push_back(color);
       }
+    }
+    layer.touchedPixels.clear();
+}
 #endif
+
+void State::clearTouchedPixels() {
+  // A dense frame (e.g. a visible background) is cheaper to wipe linearly
+  // than through scattered stores.
+  if (touchedPixels.size() * 4u >= pixelDiv.size()) {
+    std::fill(pixelValuesR.begin(), pixelValuesR.end(), 0);
+    std::fill(pixelValuesG.begin(), pixelValuesG.end(), 0);
+    std::fill(pixelValuesB.begin(), pixelValuesB.end(), 0);
+    std::fill(pixelDiv.begin(), pixelDiv.end(), 0);
+  } else {
+    for (const uint16_t pixel : touchedPixels) {
+      pixelValuesR[pixel] = 0;
+      pixelValuesG[pixel] = 0;
+      pixelValuesB[pixel] = 0;
+      pixelDiv[pixel] = 0;
     }
   }
+  previousTouchedPixels.swap(touchedPixels);
+  touchedPixels.clear();
 }
 
 void State::updateLight(RuntimeLight* light) {
@@ -312,60 +514,239 @@ void State::updateLight(RuntimeLight* light) {
         }
       }
     }
-    else if (light->pixel1 >= 0) {
+    else if (light->pixel1() >= 0) {
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
       setPixelsWeighted(
-          static_cast<uint16_t>(light->pixel1),
-          light->getPixelColorAt(light->pixel1),
+          static_cast<uint16_t>(light->pixel1()),
+          light->getPixelColorAt(light->pixel1()),
           light->list,
           light->getPrimaryPixelWeight());
       if (light->hasSecondaryPixel()) {
         setPixelsWeighted(
-            static_cast<uint16_t>(light->pixel2),
-            light->getPixelColorAt(light->pixel2),
+            static_cast<uint16_t>(light->pixel2()),
+            light->getPixelColorAt(light->pixel2()),
             light->list,
-            light->pixel2Weight);
+            light->pixel2Weight());
       }
 #else
       ColorRGB color = light->getPixelColor();
-      setPixels(static_cast<uint16_t>(light->pixel1), color, light->list);
+      setPixels(static_cast<uint16_t>(light->pixel1()), color, light->list);
 #endif
     }
     light->nextFrame();
 }
 
-ColorRGB State::getPixel(uint16_t i, uint8_t maxBrightness) {
+template <class LightT, size_t... Keys>
+constexpr std::array<State::ListKernel, sizeof...(Keys)> State::makeListKernels(std::index_sequence<Keys...>) {
+    return {{&State::updateListLightsWith<LightT,
+                                          static_cast<uint8_t>(Keys % light_kernel::kSpanModes),
+                                          ((Keys / light_kernel::kSpanModes) & 1u) != 0,
+                                          ((Keys / light_kernel::kSpanModes) & 2u) != 0,
+                                          ((Keys / light_kernel::kSpanModes) & 4u) != 0>...}};
+}
+
+template <class LightT>
+const State::ListKernel* State::listKernels() {
+    static constexpr std::array<ListKernel, kListKernelCount> kernels =
+        makeListKernels<LightT>(std::make_index_sequence<kListKernelCount>());
+    return kernels.data();
+}
+
+namespace {
+
+// getPixelColorAt() for the light in `slot`, read from the store.
+template <class LightT>
+inline ColorRGB storePixelColor(LightList* lightList, const LightStore& store, uint16_t slot, int16_t pixel) {
+    const uint8_t brightness = store.brightness[slot];
+    ColorRGB color;
+    if constexpr (std::is_same<LightT, Light>::value) {
+        (void) lightList;
+        (void) pixel;
+        color = store.color[slot];
+    } else {
+        color = lightList->getColor(pixel);
+    }
+    return brightness == 255 ? color : color.dim(brightness);
+}
+
+}  // namespace
+
+// One list, one behaviour combination: light types and flags are resolved at
+// compile time, so the loop below has no virtual calls and no behaviour
+// tests. It reads and writes the list's LightStore arrays by slot; the light
+// objects are only touched by the span modes, which walk the topology. Must
+// stay equivalent to updateLight() + nextFrame().
+template <class LightT, uint8_t Span, bool ConstNoise, bool PosChangeFade, bool Mirror>
+void State::updateListLightsWith(LightList* lightList,
+                                 bool renderStep,
+                                 ListLayer* layer,
+                                 std::vector<uint16_t>& spanPixels) {
+    constexpr bool kIsLight = std::is_same<LightT, Light>::value;
+    RuntimeLight* const* const lights = lightList->lights;
+    LightStore& store = lightList->lightStore();
+    const uint16_t numLights = lightList->numLights;
+    const Model* const model = lightList->model;
+    const LightgraphRuntimeContext& context = lightList->runtimeContext();
+    LightgraphRng& random = lightList->random();
+    const uint16_t listId = lightList->id;
+    const uint8_t fadeThresh = lightList->fadeThresh;
+    const float briStep = lightgraphMotionDistance(context, lightList->fadeSpeed);
+    const float listStep = kIsLight ? 0.0f : lightgraphMotionDistance(context, lightList->speed);
+    for (uint16_t j = 0; j < numLights; j++) {
+        if (lights[j] == NULL) continue;
+        const int16_t pixel1 = store.pixel1[j];
+        if (renderStep) {
+            if constexpr (Span != light_kernel::SPAN_PIXEL) {
+                ColorRGB color = storePixelColor<LightT>(lightList, store, j, pixel1);
+                uint16_t numPixels = 0;
+                if (pixel1 >= 0) {
+                    LightT* const light = static_cast<LightT*>(lights[j]);
+                    numPixels = (Span == light_kernel::SPAN_SEGMENT)
+                        ? light->setSegmentPixels(spanPixels.data(), spanPixels.size())
+                        : light->setLinkPixels(spanPixels.data(), spanPixels.size());
+                }
+                for (uint16_t k = 1; k < numPixels + 1; k++) {
+                    writeLightPixels<Mirror>(layer, spanPixels[k], color, lightList);
+                }
+            } else if (pixel1 >= 0) {
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
+                writeLightPixelsWeighted<Mirror>(
+                    layer,
+                    static_cast<uint16_t>(pixel1),
+                    storePixelColor<LightT>(lightList, store, j, pixel1),
+                    lightList,
+                    store.pixel1Weight[j]);
+                const int16_t pixel2 = store.pixel2[j];
+                if (pixel2 >= 0 && store.pixel2Weight[j] > 0) {
+                    writeLightPixelsWeighted<Mirror>(
+                        layer,
+                        static_cast<uint16_t>(pixel2),
+                        storePixelColor<LightT>(lightList, store, j, pixel2),
+                        lightList,
+                        store.pixel2Weight[j]);
+                }
+#else
+                ColorRGB color = storePixelColor<LightT>(lightList, store, j, pixel1);
+                writeLightPixels<Mirror>(layer, static_cast<uint16_t>(pixel1), color, lightList);
+#endif
+            }
+        }
+
+        // nextFrame()
+        uint16_t bri = light_kernel::nextBri<ConstNoise>(context, listId, store.bri[j], pixel1, briStep);
+        float step = listStep;
+        if constexpr (kIsLight) {
+            store.brightness[j] = Light::brightnessFor(bri, store.maxBri[j], fadeThresh);
+            step = lightgraphMotionDistance(context, store.speed[j]);
+        }
+        store.position[j] = light_kernel::nextPosition<PosChangeFade>(random, model, bri, store.position[j], step);
+        store.bri[j] = bri;
+    }
+}
+
+void State::updateListLights(LightList* lightList,
+                             bool renderStep,
+                             ListLayer* layer,
+                             std::vector<uint16_t>& spanPixels) {
+    const uint16_t flags = (lightList->behaviour != NULL) ? lightList->behaviour->flags : 0;
+    const uint8_t span = (flags & B_RENDER_SEGMENT) ? light_kernel::SPAN_SEGMENT
+                         : (flags & B_FILL_EASE)    ? light_kernel::SPAN_FILL_EASE
+                                                    : light_kernel::SPAN_PIXEL;
+    const size_t key = span + light_kernel::kSpanModes *
+                                  (((flags & B_BRI_CONST_NOISE) ? 1u : 0u) +
+                                   ((flags & B_POS_CHANGE_FADE) ? 2u : 0u) +
+                                   (hasMirror(lightList) ? 4u : 0u));
+    switch (specializedLightUpdate ? lightList->lightKinds() : 0) {
+      case LIGHT_KIND_LIGHT:
+        (this->*listKernels<Light>()[key])(lightList, renderStep, layer, spanPixels);
+        return;
+      case LIGHT_KIND_RUNTIME:
+        (this->*listKernels<RuntimeLight>()[key])(lightList, renderStep, layer, spanPixels);
+        return;
+      default:
+        break;
+    }
+    // Mixed or unknown light types keep the virtual per-light path, which
+    // renders through renderLayer() (serial passes only).
+    for (uint16_t j=0; j<lightList->numLights; j++) {
+        RuntimeLight* light = lightList->lights[j];
+        if (light == NULL) continue;
+        if (renderStep) {
+          updateLight(light);
+        } else {
+          light->nextFrame();
+        }
+    }
+}
+
+ColorRGB State::getPixel(uint16_t i, uint8_t maxBrightness) const {
   ColorRGB color = ColorRGB(0, 0, 0);
   if (i >= pixelDiv.size()) {
     return color;
   }
   const uint8_t div = pixelDiv[i];
   if (div != 0) {
-    const uint16_t avgR = static_cast<uint16_t>(pixelValuesR[i] / div);
-    const uint16_t avgG = static_cast<uint16_t>(pixelValuesG[i] / div);
-    const uint16_t avgB = static_cast<uint16_t>(pixelValuesB[i] / div);
-
-    const uint16_t clampedR = avgR > 255 ? 255 : avgR;
-    const uint16_t clampedG = avgG > 255 ? 255 : avgG;
-    const uint16_t clampedB = avgB > 255 ? 255 : avgB;
-
-    color.R = static_cast<uint8_t>((clampedR * maxBrightness + 127u) / 255u);
-    color.G = static_cast<uint8_t>((clampedG * maxBrightness + 127u) / 255u);
-    color.B = static_cast<uint8_t>((clampedB * maxBrightness + 127u) / 255u);
+    color.R = pixel_resolve::resolveChannel(pixelValuesR[i], div, maxBrightness);
+    color.G = pixel_resolve::resolveChannel(pixelValuesG[i], div, maxBrightness);
+    color.B = pixel_resolve::resolveChannel(pixelValuesB[i], div, maxBrightness);
   }
   return color;
 }
 
+uint16_t State::resolvePixels(uint8_t* rgb, uint16_t count, uint8_t maxBrightness) const {
+  if (rgb == nullptr) {
+    return 0;
+  }
+  const uint16_t resolved = static_cast<uint16_t>(std::min<size_t>(count, pixelDiv.size()));
+  pixel_resolve::Planes planes;
+  planes.r = pixelValuesR.data();
+  planes.g = pixelValuesG.data();
+  planes.b = pixelValuesB.data();
+  planes.div = pixelDiv.data();
+  pixel_resolve::resolve(planes, resolved, maxBrightness, rgb);
+  return resolved;
+}
+
+void State::collectChangedPixels(std::vector<uint16_t>& out) const {
+  out.clear();
+  out.reserve(touchedPixels.size() + previousTouchedPixels.size());
+  out.insert(out.end(), touchedPixels.begin(), touchedPixels.end());
+  out.insert(out.end(), previousTouchedPixels.begin(), previousTouchedPixels.end());
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
 void State::setPixelsWeighted(uint16_t pixel,
                               const ColorRGB& color,
                               const LightList* const lightList,
                               uint8_t weight) {
+    if (hasMirror(lightList)) {
+        writeLightPixelsWeighted<true>(renderLayer(), pixel, color, lightList, weight);
+    } else {
+        writeLightPixelsWeighted<false>(renderLayer(), pixel, color, lightList, weight);
+    }
+}
+
+void State::setPixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList) {
+    if (hasMirror(lightList)) {
+        writeLightPixels<true>(renderLayer(), pixel, color, lightList);
+    } else {
+        writeLightPixels<false>(renderLayer(), pixel, color, lightList);
+    }
+}
+
+template <bool Mirror>
+void State::writeLightPixelsWeighted(ListLayer* layer,
+                                     uint16_t pixel,
+                                     const ColorRGB& color,
+                                     const LightList* const lightList,
+                                     uint8_t weight) {
     if (weight == 0) {
         return;
     }
     if (weight == FULL_BRIGHTNESS) {
         ColorRGB fullColor = color;
-        setPixels(pixel, fullColor, lightList);
+        writeLightPixels<Mirror>(layer, pixel, fullColor, lightList);
         return;
     }
 
@@ -373,102 +754,61 @@ void State::setPixelsWeighted(uint16_t pixel,
     if (weightedColor.R == 0 && weightedColor.G == 0 && weightedColor.B == 0) {
         return;
     }
-    setPixels(pixel, weightedColor, lightList);
+    writeLightPixels<Mirror>(layer, pixel, weightedColor, lightList);
 }
 
-void State::setPixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList) {
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
-    if (renderingList != nullptr) {
-        setListPixels(pixel, color, lightList);
-        return;
+template <bool Mirror>
+void State::writeLightPixels(ListLayer* layer, uint16_t pixel, ColorRGB &color, const LightList* const lightList) {
+    if (layer != nullptr) {
+        layer->add(pixel, color);
+    } else {
+        setFramePixel(pixel, color, lightList);
     }
-#endif
-    setFramePixels(pixel, color, lightList);
-}
-
-void State::setFramePixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList) {
-    setFramePixel(pixel, color, lightList);
-    if (lightList != NULL && lightList->behaviour != NULL &&
-        (lightList->behaviour->mirrorFlip() || lightList->behaviour->mirrorRotate())) {
+    if constexpr (Mirror) {
         uint16_t* mirrorPixels = object.getMirroredPixels(pixel, lightList->behaviour->mirrorFlip() ? lightList->emitter : 0, lightList->behaviour->mirrorRotate());
         if (mirrorPixels != NULL) {
             // first value is length
             uint16_t numPixels = mirrorPixels[0];
             for (uint16_t k=1; k<numPixels+1; k++) {
-                setFramePixel(mirrorPixels[k], color, lightList);
+                if (layer != nullptr) {
+                    layer->add(mirrorPixels[k], color);
+                } else {
+                    setFramePixel(mirrorPixels[k], color, lightList);
+                }
             }
         }
     }
 }
 
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
+ListLayer* State::renderLayer() {
+#if LIGHTGRAPH_LAYER_COMPOSITING
+    return (renderingList != nullptr) ? &listLayer : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+#if LIGHTGRAPH_LAYER_COMPOSITING
 void State::beginListRender(const LightList* lightList) {
     renderingList = lightList;
 }
 
 void State::endListRender(const LightList* lightList) {
     renderingList = nullptr;
-    for (uint16_t pixel : listTouchedPixels) {
-        const uint16_t red = listPixelValuesR[pixel];
-        const uint16_t green = listPixelValuesG[pixel];
-        const uint16_t blue = listPixelValuesB[pixel];
-        if (red != 0 || green != 0 || blue != 0) {
-            ColorRGB color(
-                static_cast<uint8_t>(std::min<uint16_t>(red, FULL_BRIGHTNESS)),
-                static_cast<uint8_t>(std::min<uint16_t>(green, FULL_BRIGHTNESS)),
-                static_cast<uint8_t>(std::min<uint16_t>(blue, FULL_BRIGHTNESS)));
+    for (uint16_t pixel : listLayer.touchedPixels) {
+        ColorRGB color = listLayer.take(pixel);
+        if (color.R != 0 || color.G != 0 || color.B != 0) {
             setFramePixel(pixel, color, lightList);
         }
-        listPixelValuesR[pixel] = 0;
-        listPixelValuesG[pixel] = 0;
-        listPixelValuesB[pixel] = 0;
     }
-    listTouchedPixels.clear();
-}
-
-void State::setListPixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList) {
-    setListPixel(pixel, color);
-    if (lightList != NULL && lightList->behaviour != NULL &&
-        (lightList->behaviour->mirrorFlip() || lightList->behaviour->mirrorRotate())) {
-        uint16_t* mirrorPixels = object.getMirroredPixels(pixel, lightList->behaviour->mirrorFlip() ? lightList->emitter : 0, lightList->behaviour->mirrorRotate());
-        if (mirrorPixels != NULL) {
-            // first value is length
-            uint16_t numPixels = mirrorPixels[0];
-            for (uint16_t k=1; k<numPixels+1; k++) {
-                setListPixel(mirrorPixels[k], color);
-            }
-        }
-    }
-}
-
-void State::setListPixel(uint16_t pixel, ColorRGB &color) {
-    if (pixel >= listPixelValuesR.size()) {
-        return;
-    }
-    if (color.R == 0 && color.G == 0 && color.B == 0) {
-        return;
-    }
-
-    if (listPixelValuesR[pixel] == 0 && listPixelValuesG[pixel] == 0 && listPixelValuesB[pixel] == 0) {
-        listTouchedPixels.push_back(pixel);
-    }
-
-    listPixelValuesR[pixel] = std::min<uint16_t>(
-        FULL_BRIGHTNESS,
-        static_cast<uint16_t>(listPixelValuesR[pixel] + color.R));
-    listPixelValuesG[pixel] = std::min<uint16_t>(
-        FULL_BRIGHTNESS,
-        static_cast<uint16_t>(listPixelValuesG[pixel] + color.G));
-    listPixelValuesB[pixel] = std::min<uint16_t>(
-        FULL_BRIGHTNESS,
-        static_cast<uint16_t>(listPixelValuesB[pixel] + color.B));
+    listLayer.touchedPixels.clear();
 }
 #endif
 
 void State::setPixel(uint16_t pixel, ColorRGB &color, const LightList* const lightList) {
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
+#if LIGHTGRAPH_LAYER_COMPOSITING
     if (renderingList != nullptr) {
-        setListPixel(pixel, color);
+        listLayer.add(pixel, color);
         return;
     }
 #endif
@@ -483,12 +823,14 @@ void State::setFramePixel(uint16_t pixel, ColorRGB &color, const LightList* cons
     // Apply blend mode based on the light list's setting
     BlendMode mode = lightList ? lightList->blendMode : BLEND_NORMAL;
 
-    // Variables for current color components
-    float r = 0.0f, g = 0.0f, b = 0.0f;
-    // Normalize the new color to 0-1 range
-    float newR = color.R / 255.0f;
-    float newG = color.G / 255.0f;
-    float newB = color.B / 255.0f;
+    if (pixelDiv[pixel] == 0 && pixelValuesR[pixel] == 0 &&
+        pixelValuesG[pixel] == 0 && pixelValuesB[pixel] == 0) {
+        // Black BLEND_ADD writes are no-ops; skip them so the pixel stays untracked.
+        if (mode == BLEND_ADD && color.R == 0 && color.G == 0 && color.B == 0) {
+            return;
+        }
+        touchedPixels.push_back(pixel);
+    }
 
     // Check most common basic blend modes first for efficiency
     if (mode == BLEND_NORMAL) {
@@ -513,12 +855,8 @@ void State::setFramePixel(uint16_t pixel, ColorRGB &color, const LightList* cons
         return;
     }
 
-    // For other blend modes, we need current color values
-    if (pixelDiv[pixel] > 0) {
-        r = (pixelValuesR[pixel] / (float)pixelDiv[pixel]) / 255.0f;
-        g = (pixelValuesG[pixel] / (float)pixelDiv[pixel]) / 255.0f;
-        b = (pixelValuesB[pixel] / (float)pixelDiv[pixel]) / 255.0f;
-    } else {
+    const uint8_t div = pixelDiv[pixel];
+    if (div == 0) {
         // No existing color, just use the new color for most blend modes
         pixelValuesR[pixel] = color.R;
         pixelValuesG[pixel] = color.G;
@@ -527,102 +865,31 @@ void State::setFramePixel(uint16_t pixel, ColorRGB &color, const LightList* cons
         return;
     }
 
-    // Now handle the more complex blend modes
-    switch (mode) {
-        case BLEND_MULTIPLY:
-            r *= newR;
-            g *= newG;
-            b *= newB;
-            break;
-
-        case BLEND_SCREEN:
-            r = 1.0f - (1.0f - r) * (1.0f - newR);
-            g = 1.0f - (1.0f - g) * (1.0f - newG);
-            b = 1.0f - (1.0f - b) * (1.0f - newB);
-            break;
-
-        case BLEND_OVERLAY:
-            r = (r < 0.5f) ? (2.0f * r * newR) : (1.0f - 2.0f * (1.0f - r) * (1.0f - newR));
-            g = (g < 0.5f) ? (2.0f * g * newG) : (1.0f - 2.0f * (1.0f - g) * (1.0f - newG));
-            b = (b < 0.5f) ? (2.0f * b * newB) : (1.0f - 2.0f * (1.0f - b) * (1.0f - newB));
-            break;
-
-        case BLEND_SUBTRACT:
-            r = max(0.0f, r - newR);
-            g = max(0.0f, g - newG);
-            b = max(0.0f, b - newB);
-            break;
-
-        case BLEND_DIFFERENCE:
-            r = std::abs(r - newR);
-            g = std::abs(g - newG);
-            b = std::abs(b - newB);
-            break;
-
-        case BLEND_EXCLUSION:
-            r = r + newR - 2.0f * r * newR;
-            g = g + newG - 2.0f * g * newG;
-            b = b + newB - 2.0f * b * newB;
-            break;
-
-        case BLEND_DODGE:
-            r = (newR == 1.0f) ? 1.0f : min(1.0f, r / (1.0f - newR));
-            g = (newG == 1.0f) ? 1.0f : min(1.0f, g / (1.0f - newG));
-            b = (newB == 1.0f) ? 1.0f : min(1.0f, b / (1.0f - newB));
-            break;
-
-        case BLEND_BURN:
-            r = (newR == 0.0f) ? 0.0f : max(0.0f, 1.0f - (1.0f - r) / newR);
-            g = (newG == 0.0f) ? 0.0f : max(0.0f, 1.0f - (1.0f - g) / newG);
-            b = (newB == 0.0f) ? 0.0f : max(0.0f, 1.0f - (1.0f - b) / newB);
-            break;
-
-        case BLEND_HARD_LIGHT:
-            r = (newR < 0.5f) ? (2.0f * newR * r) : (1.0f - 2.0f * (1.0f - newR) * (1.0f - r));
-            g = (newG < 0.5f) ? (2.0f * newG * g) : (1.0f - 2.0f * (1.0f - newG) * (1.0f - g));
-            b = (newB < 0.5f) ? (2.0f * newB * b) : (1.0f - 2.0f * (1.0f - newB) * (1.0f - b));
-            break;
-
-        case BLEND_SOFT_LIGHT:
-            r = (newR < 0.5f) ? (r - (1.0f - 2.0f * newR) * r * (1.0f - r)) : (r + (2.0f * newR - 1.0f) * (sqrt(r) - r));
-            g = (newG < 0.5f) ? (g - (1.0f - 2.0f * newG) * g * (1.0f - g)) : (g + (2.0f * newG - 1.0f) * (sqrt(g) - g));
-            b = (newB < 0.5f) ? (b - (1.0f - 2.0f * newB) * b * (1.0f - b)) : (b + (2.0f * newB - 1.0f) * (sqrt(b) - b));
-            break;
-
-        case BLEND_LINEAR_LIGHT:
-            r = (newR < 0.5f) ? max(0.0f, r + 2.0f * newR - 1.0f) : min(1.0f, r + 2.0f * (newR - 0.5f));
-            g = (newG < 0.5f) ? max(0.0f, g + 2.0f * newG - 1.0f) : min(1.0f, g + 2.0f * (newG - 0.5f));
-            b = (newB < 0.5f) ? max(0.0f, b + 2.0f * newB - 1.0f) : min(1.0f, b + 2.0f * (newB - 0.5f));
-            break;
-
-        case BLEND_VIVID_LIGHT:
-            r = (newR < 0.5f) ? (newR == 0.0f ? 0.0f : max(0.0f, 1.0f - (1.0f - r) / (2.0f * newR))) :
-                               (newR == 1.0f ? 1.0f : min(1.0f, r / (2.0f * (1.0f - newR))));
-            g = (newG < 0.5f) ? (newG == 0.0f ? 0.0f : max(0.0f, 1.0f - (1.0f - g) / (2.0f * newG))) :
-                               (newG == 1.0f ? 1.0f : min(1.0f, g / (2.0f * (1.0f - newG))));
-            b = (newB < 0.5f) ? (newB == 0.0f ? 0.0f : max(0.0f, 1.0f - (1.0f - b) / (2.0f * newB))) :
-                               (newB == 1.0f ? 1.0f : min(1.0f, b / (2.0f * (1.0f - newB))));
-            break;
-
-        case BLEND_PIN_LIGHT:
-            r = (newR < 0.5f) ? min(r, 2.0f * newR) : max(r, 2.0f * (newR - 0.5f));
-            g = (newG < 0.5f) ? min(g, 2.0f * newG) : max(g, 2.0f * (newG - 0.5f));
-            b = (newB < 0.5f) ? min(b, 2.0f * newB) : max(b, 2.0f * (newB - 0.5f));
-            break;
-
-        default:
-            // Fallback to normal blend for any unrecognized modes
-            pixelValuesR[pixel] += color.R;
-            pixelValuesG[pixel] += color.G;
-            pixelValuesB[pixel] += color.B;
-            pixelDiv[pixel]++;
-            return;
+    if (!blend::isCompositeMode(mode)) {
+        // Fallback to normal blend for any unrecognized modes
+        pixelValuesR[pixel] += color.R;
+        pixelValuesG[pixel] += color.G;
+        pixelValuesB[pixel] += color.B;
+        pixelDiv[pixel]++;
+        return;
     }
 
-    // Set the calculated color values
-    pixelValuesR[pixel] = r * 255.0f * pixelDiv[pixel];
-    pixelValuesG[pixel] = g * 255.0f * pixelDiv[pixel];
-    pixelValuesB[pixel] = b * 255.0f * pixelDiv[pixel];
+#if LIGHTGRAPH_FIXED_POINT_BLEND
+    pixelValuesR[pixel] = blend::toAccumulator(
+        blend::blendFixed(mode, blend::toFixedAverage(pixelValuesR[pixel], div), blend::toFixed(color.R)), div);
+    pixelValuesG[pixel] = blend::toAccumulator(
+        blend::blendFixed(mode, blend::toFixedAverage(pixelValuesG[pixel], div), blend::toFixed(color.G)), div);
+    pixelValuesB[pixel] = blend::toAccumulator(
+        blend::blendFixed(mode, blend::toFixedAverage(pixelValuesB[pixel], div), blend::toFixed(color.B)), div);
+#else
+    // Current color components and the new color, normalized to 0-1 range
+    const float r = (pixelValuesR[pixel] / (float)div) / 255.0f;
+    const float g = (pixelValuesG[pixel] / (float)div) / 255.0f;
+    const float b = (pixelValuesB[pixel] / (float)div) / 255.0f;
+    pixelValuesR[pixel] = blend::blendFloat(mode, r, color.R / 255.0f) * 255.0f * div;
+    pixelValuesG[pixel] = blend::blendFloat(mode, g, color.G / 255.0f) * 255.0f * div;
+    pixelValuesB[pixel] = blend::blendFloat(mode, b, color.B / 255.0f) * 255.0f * div;
+#endif
 }
 
 void State::setupBg(uint8_t i) {
@@ -637,6 +904,7 @@ void State::setupBg(uint8_t i) {
         return;
     }
     bgLight->bindRuntimeContext(object.runtimeContext());
+    bgLight->bindPaletteCache(&paletteCache);
     lightLists[i] = bgLight;
 
     // Configure the BgLight
@@ -664,6 +932,10 @@ uint8_t State::getLocalSlotEndExclusive() const {
     return static_cast<uint8_t>(MAX_LIGHT_LISTS - slotsToReserve);
 }
 
+void State::releaseList(LightList* lightList) {
+    lightListPool.release(lightList);
+}
+
 bool State::clearListSlot(uint8_t slot) {
     if (slot >= MAX_LIGHT_LISTS) {
         return false;
@@ -689,14 +961,14 @@ bool State::clearListSlot(uint8_t slot) {
         totalLightLists--;
     }
 
-    delete existing;
+    releaseList(existing);
     lightLists[slot] = nullptr;
     return true;
 }
 
 bool State::replaceListSlot(uint8_t slot, LightList* replacement) {
     if (slot >= MAX_LIGHT_LISTS) {
-        delete replacement;
+        releaseList(replacement);
         return false;
     }
 
@@ -717,7 +989,7 @@ bool State::replaceListSlot(uint8_t slot, LightList* replacement) {
         if (totalLightLists > 0) {
             totalLightLists--;
         }
-        delete existing;
+        releaseList(existing);
         lightLists[0] = nullptr;
     } else if (slot != 0) {
         clearListSlot(slot);
@@ -728,6 +1000,7 @@ bool State::replaceListSlot(uint8_t slot, LightList* replacement) {
     }
 
     replacement->bindRuntimeContext(object.runtimeContext());
+    replacement->bindPaletteCache(&paletteCache);
     lightLists[slot] = replacement;
     totalLights = static_cast<uint16_t>(totalLights + replacement->numLights);
     if (totalLightLists < std::numeric_limits<uint8_t>::max()) {
@@ -737,12 +1010,13 @@ bool State::replaceListSlot(uint8_t slot, LightList* replacement) {
 }
 
 void State::colorAll() {
+    Random::Scope random(object.runtimeContext().rng);
     ColorRGB color;
     color.setRandom();
     for (uint8_t i=0; i<MAX_LIGHT_LISTS; i++) {
         if (lightLists[i] == NULL) continue;
         Palette updatedPalette = lightLists[i]->getPalette();
-        updatedPalette.setColors({color});
+        updatedPalette.setColors(static_cast<int64_t>(color.get()));
         lightLists[i]->setPalette(updatedPalette);
     }
 }
@@ -810,13 +1084,13 @@ void State::debug() {
     if (lightLists[i] == NULL) continue;
     LG_STRING lights = "";
     for (uint16_t j=0; j<lightLists[i]->numLights; j++) {
-      if (lightLists[i]->lights[j] == NULL || lightLists[i]->lights[j]->isExpired) {
+      if (lightLists[i]->lights[j] == NULL || lightLists[i]->lights[j]->isExpired()) {
         continue;
       }
       else {
         lights += j;
         lights += "(";
-        lights += lightLists[i]->lights[j]->pixel1;
+        lights += lightLists[i]->lights[j]->pixel1();
         lights += ")";
         lights += ", ";
       }
@@ -1,10 +1,17 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "../Globals.h"
 #include "../core/Types.h"
 #include "../core/Limits.h"
+#include "LightArena.h"
+#include "../rendering/PaletteCache.h"
+#include "UpdateWorkers.h"
 
 class EmitParams;
 class TopologyObject;
@@ -14,14 +21,34 @@ class Behaviour;
 class Owner;
 class RuntimeLight;
 
+// One list's lights summed per pixel (saturating at 255) before the list is
+// blended into the frame as a single layer.
+struct ListLayer {
+    std::vector<uint16_t> valuesR;
+    std::vector<uint16_t> valuesG;
+    std::vector<uint16_t> valuesB;
+    std::vector<uint16_t> touchedPixels;
+
+    explicit ListLayer(uint16_t pixelCount = 0);
+    void add(uint16_t pixel, const ColorRGB& color);
+    // Returns the summed color of `pixel` and zeroes it; touchedPixels is
+    // left for the caller to clear.
+    ColorRGB take(uint16_t pixel);
+};
+
 class State {
 
   public:
 
-    static EmitParams autoParams;
-
     TopologyObject &object;
     LightList *lightLists[MAX_LIGHT_LISTS] = {0};
+    // Emitted lists and their lights are recycled through these, so repeated
+    // emits reach a steady state without heap allocations.
+    LightArena lightArena;
+    LightListPool lightListPool{lightArena};
+    // Interpolated palette tables shared by this State's lists; hits() and
+    // misses() show whether its capacity fits the show.
+    PaletteCache paletteCache;
     uint16_t totalLights = 0;
     uint8_t totalLightLists = 0;
     unsigned long nextEmit = 0;
@@ -30,17 +57,26 @@ class State {
     std::vector<uint16_t> pixelValuesB;
     std::vector<uint8_t> pixelDiv;
     std::vector<uint16_t> renderPixelScratch;
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
-    std::vector<uint16_t> listPixelValuesR;
-    std::vector<uint16_t> listPixelValuesG;
-    std::vector<uint16_t> listPixelValuesB;
-    std::vector<uint16_t> listTouchedPixels;
+    // Pixels written since the last render-step clear, and those written in
+    // the frame before it. Only these are cleared by the next render step.
+    std::vector<uint16_t> touchedPixels;
+    std::vector<uint16_t> previousTouchedPixels;
+#if LIGHTGRAPH_LAYER_COMPOSITING
+    // Layer scratch for the list being rendered: its lights add up here and
+    // each touched pixel is blended into the frame once with the list's
+    // blendMode, so overlapping lights act as a single layer.
+    ListLayer listLayer;
 #endif
     bool autoEnabled = false;
+    // Parameters for autoEmit, owned per State so engines never share them.
+    EmitParams autoParams{EmitParams::DEFAULT_MODEL, RANDOM_SPEED};
     uint8_t currentPalette = 0;
     bool showIntersections = false;
     bool showConnections = false;
     uint8_t reservedTailSlots = 0;
+    // When false every list takes the generic updateLight() path instead of
+    // its specialized kernel; the two render identical frames.
+    bool specializedLightUpdate = true;
 
     explicit State(TopologyObject &obj);
     ~State();
@@ -61,7 +97,13 @@ class State {
     int8_t findList(uint16_t noteId) const;
     LightList* findListById(uint16_t id);
     void stopNote(uint16_t noteId);
-    ColorRGB getPixel(uint16_t i, uint8_t maxBrightness = FULL_BRIGHTNESS);
+    ColorRGB getPixel(uint16_t i, uint8_t maxBrightness = FULL_BRIGHTNESS) const;
+    // Resolves the first `count` accumulated pixels into packed RGB triplets
+    // (3 bytes per pixel) and returns the number of pixels written.
+    uint16_t resolvePixels(uint8_t* rgb, uint16_t count, uint8_t maxBrightness = FULL_BRIGHTNESS) const;
+    // Collects, in ascending order, every pixel lit in the current or the
+    // previous rendered frame; all other pixels are unchanged and black.
+    void collectChangedPixels(std::vector<uint16_t>& out) const;
     void debug();
     bool isOn();
     void setOn(bool newState);
@@ -73,21 +115,72 @@ class State {
     uint8_t getLocalSlotEndExclusive() const;
     bool clearListSlot(uint8_t slot);
     bool replaceListSlot(uint8_t slot, LightList* replacement);
+    // Threads used by update(), counting the caller. 1 (the default) updates
+    // lists serially; more advances lists concurrently and blends their
+    // layers in slot order, rendering the same frame. Returns false, leaving
+    // the setting unchanged, when threads is 0 or the build has no
+    // LIGHTGRAPH_PARALLEL_UPDATE.
+    bool setUpdateThreads(uint8_t threads);
+    uint8_t getUpdateThreads() const;
 
   private:
     void doEmit(Owner* from, LightList *lightList, EmitParams& params);
+    void releaseList(LightList* lightList);
     void updatePass(bool renderStep);
+    void updateSlot(uint8_t slot, bool renderStep);
+    bool retireIfExpired(uint8_t slot, bool allExpired);
+    // Renders (on a render step) and advances every light of a normal list,
+    // through a kernel specialized for its light type and behaviour flags.
+    // Lights go to `layer`, or straight to the frame when it is null.
+    void updateListLights(LightList* lightList, bool renderStep, ListLayer* layer,
+                          std::vector<uint16_t>& spanPixels);
+    using ListKernel = void (State::*)(LightList*, bool, ListLayer*, std::vector<uint16_t>&);
+    // Span mode x const noise x position-change fade x mirror.
+    static constexpr size_t kListKernelCount = 3 * 2 * 2 * 2;
+    template <class LightT>
+    static const ListKernel* listKernels();
+    template <class LightT, size_t... Keys>
+    static constexpr std::array<ListKernel, sizeof...(Keys)> makeListKernels(std::index_sequence<Keys...>);
+    template <class LightT, uint8_t Span, bool ConstNoise, bool PosChangeFade, bool Mirror>
+    void updateListLightsWith(LightList* lightList, bool renderStep, ListLayer* layer,
+                              std::vector<uint16_t>& spanPixels);
+    void clearTouchedPixels();
     void setPixelsWeighted(uint16_t pixel, const ColorRGB& color, const LightList* const lightList, uint8_t weight);
     void setPixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList);
+    template <bool Mirror>
+    void writeLightPixelsWeighted(ListLayer* layer, uint16_t pixel, const ColorRGB& color, const LightList* const lightList, uint8_t weight);
+    template <bool Mirror>
+    void writeLightPixels(ListLayer* layer, uint16_t pixel, ColorRGB &color, const LightList* const lightList);
+    // The layer setPixel() writes to: the list being rendered, or null for the frame.
+    ListLayer* renderLayer();
     void setPixel(uint16_t pixel, ColorRGB &color, const LightList* const lightList);
-    void setFramePixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList);
     void setFramePixel(uint16_t pixel, ColorRGB &color, const LightList* const lightList);
-#if LIGHTGRAPH_FRACTIONAL_RENDERING
+#if LIGHTGRAPH_LAYER_COMPOSITING
     void beginListRender(const LightList* lightList);
     void endListRender(const LightList* lightList);
-    void setListPixels(uint16_t pixel, ColorRGB &color, const LightList* const lightList);
-    void setListPixel(uint16_t pixel, ColorRGB &color);
     const LightList* renderingList = nullptr;
 #endif
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    // A worker's layer and span scratch.
+    struct WorkerScratch {
+        ListLayer layer;
+        std::vector<uint16_t> spanPixels;
+    };
+    // What a worker produced for one slot, blended in slot order afterwards.
+    struct SlotResult {
+        bool allExpired = false;
+        std::vector<uint16_t> pixels;
+        std::vector<ColorRGB> colors;
+    };
+    bool isParallelSafe(const LightList* lightList) const;
+    void updatePassParallel(bool renderStep);
+    static void updateParallelSlot(void* context, uint8_t worker, uint16_t item);
+    std::unique_ptr<UpdateWorkers> updateWorkers;
+    std::vector<WorkerScratch> workerScratch;
+    std::array<SlotResult, MAX_LIGHT_LISTS> slotResults;
+    std::array<bool, MAX_LIGHT_LISTS> slotIsParallel = {};
+    std::array<uint8_t, MAX_LIGHT_LISTS> parallelSlots = {};
+    bool parallelRenderStep = false;
+#endif
 
 };
@@ -0,0 +1,108 @@
+#include "UpdateWorkers.h"
+
+#if LIGHTGRAPH_PARALLEL_UPDATE
+
+#include <system_error>
+
+#include "../core/Platform.h"
+
+UpdateWorkers::UpdateWorkers(uint8_t workers) {
+    const uint8_t extra = (workers > 1) ? static_cast<uint8_t>(workers - 1) : 0;
+    threads_.reserve(extra);
+    for (uint8_t i = 0; i < extra; i++) {
+        try {
+            threads_.emplace_back(&UpdateWorkers::workerLoop, this, static_cast<uint8_t>(i + 1));
+        } catch (const std::system_error&) {
+            // Run with the threads we got; size() reports the real count.
+            LG_LOGF("UpdateWorkers: started %u of %u threads\n", i + 1u, static_cast<unsigned>(workers));
+            break;
+        }
+    }
+}
+
+UpdateWorkers::~UpdateWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void UpdateWorkers::run(uint16_t count, Task task, void* context) {
+    if (count == 0) {
+        return;
+    }
+    if (threads_.empty() || count == 1) {
+        for (uint16_t item = 0; item < count; item++) {
+            task(context, 0, item);
+        }
+        return;
+    }
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = task;
+        context_ = context;
+        count_ = count;
+        generation = ++generation_;
+        pending_.store(count, std::memory_order_relaxed);
+        next_.store(static_cast<uint64_t>(generation) << 32, std::memory_order_relaxed);
+    }
+    wake_.notify_all();
+    drain(0, generation, task, context, count);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+    task_ = nullptr;
+    context_ = nullptr;
+}
+
+void UpdateWorkers::workerLoop(uint8_t worker) {
+    uint32_t seen = 0;
+    for (;;) {
+        Task task;
+        void* context;
+        uint16_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+            context = context_;
+            count = count_;
+        }
+        drain(worker, seen, task, context, count);
+    }
+}
+
+void UpdateWorkers::drain(uint8_t worker, uint32_t generation, Task task, void* context, uint16_t count) {
+    const uint64_t first = static_cast<uint64_t>(generation) << 32;
+    const uint64_t end = first + count;
+    uint64_t claim = next_.load(std::memory_order_relaxed);
+    for (;;) {
+        if (claim < first || claim >= end) {
+            return;
+        }
+        if (!next_.compare_exchange_weak(claim, claim + 1, std::memory_order_relaxed)) {
+            continue;
+        }
+        task(context, worker, static_cast<uint16_t>(claim - first));
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            {
+                // Orders the last decrement with run()'s predicate check, so
+                // the wakeup cannot be missed.
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+            done_.notify_one();
+            return;
+        }
+        claim = next_.load(std::memory_order_relaxed);
+    }
+}
+
+#endif
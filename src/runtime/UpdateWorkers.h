@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../Globals.h"
+
+#if LIGHTGRAPH_PARALLEL_UPDATE
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * UpdateWorkers - fixed worker pool for State's parallel update pass
+ *
+ * size() workers share each run(): the calling thread is worker 0 and
+ * size() - 1 threads are parked between runs. Items are claimed one at a
+ * time from an atomic counter and counted off with another, so the mutex
+ * is only taken to start and finish a run. Which worker handles an item is
+ * not deterministic; callers keep results per item and combine them in
+ * item order afterwards.
+ */
+class UpdateWorkers {
+  public:
+    using Task = void (*)(void* context, uint8_t worker, uint16_t item);
+
+    // `workers` counts the calling thread; 0 is treated as 1.
+    explicit UpdateWorkers(uint8_t workers);
+    ~UpdateWorkers();
+
+    UpdateWorkers(const UpdateWorkers&) = delete;
+    UpdateWorkers& operator=(const UpdateWorkers&) = delete;
+
+    uint8_t size() const {
+        return static_cast<uint8_t>(threads_.size() + 1);
+    }
+
+    // Calls task(context, worker, item) once for every item in [0, count)
+    // and returns when all calls have finished.
+    void run(uint16_t count, Task task, void* context);
+
+  private:
+    void workerLoop(uint8_t worker);
+    void drain(uint8_t worker, uint32_t generation, Task task, void* context, uint16_t count);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Task task_ = nullptr;
+    void* context_ = nullptr;
+    uint16_t count_ = 0;
+    uint32_t generation_ = 0;
+    bool stopping_ = false;
+    // Run generation in the high half, next unclaimed item in the low half,
+    // so a worker still leaving the previous run cannot claim from this one.
+    std::atomic<uint64_t> next_{0};
+    // Items of the current run not finished yet.
+    std::atomic<uint16_t> pending_{0};
+};
+
+#endif
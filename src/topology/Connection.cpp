@@ -9,6 +9,7 @@
 
 namespace {
 
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
 bool isDestinationIntersectionFullyOwnedByPreviousLight(const RuntimeLight* light,
                                                         const Intersection* destination) {
   if (light == nullptr || destination == nullptr) {
@@ -17,11 +18,12 @@ bool isDestinationIntersectionFullyOwnedByPreviousLight(const RuntimeLight* ligh
 
   const RuntimeLight* previous = light->getPrev();
   return previous != nullptr &&
-         previous->owner == destination &&
-         previous->pixel1 == static_cast<int16_t>(destination->topPixel) &&
-         previous->pixel1Weight > 0 &&
+         previous->owner() == destination &&
+         previous->pixel1() == static_cast<int16_t>(destination->topPixel) &&
+         previous->pixel1Weight() > 0 &&
          !previous->hasSecondaryPixel();
 }
+#endif
 
 bool hasAvailablePortSlot(const Intersection* intersection) {
   if (intersection == nullptr) {
@@ -113,6 +115,7 @@ void Connection::configurePixels(uint16_t objectPixelCount) {
 
     if (forcedNumLeds_ > -1) {
         numLeds = static_cast<uint16_t>(forcedNumLeds_);
+        buildPixelTable();
         return;
     }
 
@@ -145,6 +148,16 @@ void Connection::configurePixels(uint16_t objectPixelCount) {
         leds = abs(fromPixel - toPixel) + 1;
     }
     numLeds = leds;
+    buildPixelTable();
+}
+
+void Connection::buildPixelTable() {
+    pixelTable_.resize(static_cast<size_t>(numLeds) * 2u);
+    for (uint16_t i = 0; i < numLeds; i++) {
+        pixelTable_[i] = getPixel(i);
+        pixelTable_[static_cast<size_t>(numLeds) * 2u - 1u - i] = pixelTable_[i];
+    }
+    maxCoord_ = std::nextafter(static_cast<float>(numLeds), 0.0f);
 }
 
 void Connection::add(RuntimeLight* const light) const {
@@ -156,25 +169,25 @@ void Connection::add(RuntimeLight* const light) const {
 }
 
 void Connection::emit(RuntimeLight* const light) const {
-    light->setOutPort(fromPort, from->id);
+    light->setOutPort(fromPort);
     add(light);
 }
 
 void Connection::update(RuntimeLight* const light) const {
-    if (light == nullptr || light->outPort == nullptr) {
+    if (light == nullptr || light->outPort() == nullptr) {
         if (light != nullptr) {
-            light->isExpired = true;
-            light->owner = NULL;
+            light->setExpired(true);
+            light->setOwner(NULL);
         }
         return;
     }
     light->resetPixels();
     if (shouldExpire(light)) {
-        light->isExpired = true;
-        light->owner = NULL;
+        light->setExpired(true);
+        light->setOwner(NULL);
         return;
     }
-    if (light->position < 0.0f) {
+    if (light->position() < 0.0f) {
         return;
     }
     if (render(light)) {
@@ -191,32 +204,22 @@ bool Connection::shouldExpire(const RuntimeLight* const light) const {
 
 bool Connection::render(RuntimeLight* const light) const {
     // handle float inprecision
-    float pos = round(light->position * 1000) / 1000.0;
+    float pos = round(light->position() * 1000) / 1000.0;
     if (numLeds > 0 && pos < numLeds) {
-        const float coordRaw = ofxeasing::map(light->position, 0, numLeds, 0, numLeds, light->getEasing());
+        const float coordRaw = ofxeasing::map(light->position(), 0, numLeds, 0, numLeds, light->getEasing());
+        const bool reverseDirection = light->outPort()->direction;
+        const uint16_t* pixels = pixelTable(reverseDirection);
+        // Eased coordinates can overshoot the run; clamped, the integer part
+        // is a valid LED index.
+        const float coord = std::clamp(coordRaw, 0.0f, maxCoord_);
+        const uint16_t logicalIndex = static_cast<uint16_t>(coord);
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
-        const float maxCoord = std::nextafter(static_cast<float>(numLeds), 0.0f);
-        const float coord = std::clamp(coordRaw, 0.0f, maxCoord);
-        const int32_t logicalIndex = std::clamp<int32_t>(
-            static_cast<int32_t>(floor(coord)),
-            0,
-            static_cast<int32_t>(numLeds) - 1);
         const float frac = coord - static_cast<float>(logicalIndex);
-        const bool reverseDirection = light->outPort->direction;
-
-        const auto physicalIndexForLogical = [this, reverseDirection](int32_t logical) -> int32_t {
-            return reverseDirection ? static_cast<int32_t>(numLeds) - logical - 1 : logical;
-        };
-
-        const int32_t primaryPhysicalIndex = physicalIndexForLogical(logicalIndex);
-        const uint16_t primaryPixel = getPixel(static_cast<uint16_t>(primaryPhysicalIndex));
+        const uint8_t secondaryWeight = static_cast<uint8_t>(round(frac * FULL_BRIGHTNESS));
+        const uint16_t primaryPixel = pixels[logicalIndex];
 
-        const int32_t nextLogicalIndex = logicalIndex + 1;
-        if (nextLogicalIndex >= static_cast<int32_t>(numLeds)) {
-            const uint8_t secondaryWeight = static_cast<uint8_t>(std::clamp<int32_t>(
-                static_cast<int32_t>(round(frac * FULL_BRIGHTNESS)),
-                0,
-                FULL_BRIGHTNESS));
+        const uint16_t nextLogicalIndex = static_cast<uint16_t>(logicalIndex + 1);
+        if (nextLogicalIndex >= numLeds) {
             const uint8_t primaryWeight = static_cast<uint8_t>(FULL_BRIGHTNESS - secondaryWeight);
             const Intersection* destination = reverseDirection ? from : to;
             if (secondaryWeight == 0 || destination == nullptr) {
@@ -231,21 +234,9 @@ bool Connection::render(RuntimeLight* const light) const {
             return true;
         }
 
-        const uint8_t secondaryWeight = static_cast<uint8_t>(std::clamp<int32_t>(
-            static_cast<int32_t>(round(frac * FULL_BRIGHTNESS)),
-            0,
-            FULL_BRIGHTNESS));
-        const uint16_t secondaryPixel =
-            getPixel(static_cast<uint16_t>(physicalIndexForLogical(nextLogicalIndex)));
-        light->setRenderedPixels(primaryPixel, secondaryPixel, secondaryWeight);
+        light->setRenderedPixels(primaryPixel, pixels[nextLogicalIndex], secondaryWeight);
 #else
-        const float led_idx =
-            light->outPort->direction ? ceil((float) numLeds - coordRaw - 1.0f) : floor(coordRaw);
-        const int32_t clamped_led_idx = std::clamp<int32_t>(
-            static_cast<int32_t>(led_idx),
-            0,
-            static_cast<int32_t>(numLeds) - 1);
-        light->setRenderedPixel(getPixel(static_cast<uint16_t>(clamped_led_idx)));
+        light->setRenderedPixel(pixels[logicalIndex]);
 #endif
         return true;
     }
@@ -253,8 +244,8 @@ bool Connection::render(RuntimeLight* const light) const {
 }
 
 inline void Connection::outgoing(RuntimeLight* const light) const {
-    light->position -= numLeds;
-    const bool dir = light->outPort->direction;
+    light->setPosition(light->position() - numLeds);
+    const bool dir = light->outPort()->direction;
     if (dir) {
         light->setInPort(fromPort);
     }
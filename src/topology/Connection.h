@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include "Owner.h"
 #include "Port.h"
 
@@ -31,6 +32,12 @@ class Connection : public Owner {
     uint16_t getPixel(uint16_t i) const {
       return fromPixel + (i * (pixelDir ? 1 : -1));
     }
+    // getPixel() for every LED in travel order: `reverse` (the out port's
+    // direction) walks from the to-end. numLeds entries, rebuilt whenever
+    // configurePixels() lays out the run.
+    const uint16_t* pixelTable(bool reverse) const {
+      return pixelTable_.data() + (reverse ? numLeds : 0);
+    }
     uint16_t getFromPixel() const;
     uint16_t getToPixel() const;
     void attachToObject(TopologyObject& object);
@@ -40,5 +47,10 @@ class Connection : public Owner {
     void outgoing(RuntimeLight* const light) const;
     bool shouldExpire(const RuntimeLight* const light) const;
     bool render(RuntimeLight* const light) const;
+    void buildPixelTable();
     int16_t forcedNumLeds_ = -1;
+    // Forward run, then reverse run.
+    std::vector<uint16_t> pixelTable_;
+    // Largest float below numLeds; eased coordinates are clamped to it.
+    float maxCoord_ = 0.0f;
 };
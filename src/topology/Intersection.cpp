@@ -5,13 +5,12 @@
 #include "Connection.h"
 #include "Model.h"
 #include "TopologyObject.h"
+#include "../Globals.h"
 #include "../core/Platform.h"
 #include "../runtime/Behaviour.h"
 #include "../runtime/Light.h"
 #include "../runtime/LightList.h"
 
-uint8_t Intersection::nextId = 0;
-
 namespace {
 
 void tryForwardSequentialBatchAtExternalPort(RuntimeLight* const light, Port* const port) {
@@ -42,27 +41,28 @@ void tryForwardSequentialBatchAtExternalPort(RuntimeLight* const light, Port* co
     }
 }
 
+#if LIGHTGRAPH_FRACTIONAL_RENDERING
 bool shouldCompensateHiddenIngressContinuity(const RuntimeLight* light,
                                              const Connection* connection,
                                              uint16_t adjacentPixel) {
     if (light == nullptr || connection == nullptr || light->list == nullptr ||
-        !light->list->compensateHiddenIngressContinuity || light->inPort != nullptr) {
+        !light->list->compensateHiddenIngressContinuity || light->inPort() != nullptr) {
         return false;
     }
 
     const RuntimeLight* previous = light->getPrev();
     return previous != nullptr &&
-           previous->owner == connection &&
-           previous->pixel1 == static_cast<int16_t>(adjacentPixel) &&
-           previous->pixel1Weight > 0;
+           previous->owner() == connection &&
+           previous->pixel1() == static_cast<int16_t>(adjacentPixel) &&
+           previous->pixel1Weight() > 0;
 }
+#endif
 
 }  // namespace
 
 Intersection::Intersection(uint8_t numPorts, uint16_t topPixel, int16_t bottomPixel, uint8_t group,
                            bool allowEndOfLife, bool allowEmit)
     : Owner(group) {
-  this->id = nextId++;
   this->numPorts = numPorts;
   this->topPixel = topPixel;
   this->bottomPixel = bottomPixel;
@@ -79,6 +79,7 @@ void Intersection::addPort(Port *p) {
       break;
     }
   }
+  invalidateRoutes();
 }
 
 bool Intersection::addPortAt(Port* p, uint8_t slotIndex) {
@@ -87,6 +88,7 @@ bool Intersection::addPortAt(Port* p, uint8_t slotIndex) {
     }
     ports[slotIndex] = p;
     p->intersection = this;
+    invalidateRoutes();
     return true;
 }
 
@@ -97,6 +99,82 @@ void Intersection::removePort(const Port* p) {
             break;
         }
     }
+    invalidateRoutes();
+}
+
+void Intersection::invalidateRoutes() {
+    routeTables_.clear();
+    routeWeights_.clear();
+    routeAlias_.clear();
+    routePorts_ = 0;
+}
+
+void Intersection::compileRoutes(const Model* model) const {
+    routeRow(model, nullptr);
+}
+
+void Intersection::fillRouteRow(const Model* model, const Port* incoming, uint16_t* row) const {
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i < numPorts; i++) {
+        if (ports[i] != nullptr) {
+            sum += model->get(ports[i], incoming);
+        }
+        row[i] = sum;
+    }
+}
+
+const uint16_t* Intersection::routeRow(const Model* model, const Port* incoming) const {
+    uint8_t slot = numPorts;
+    if (incoming != nullptr) {
+        slot = 0;
+        while (slot < numPorts && ports[slot] != incoming) {
+            slot++;
+        }
+        if (slot == numPorts) {
+            return nullptr;
+        }
+    }
+
+    if (routePorts_ != numPorts) {
+        routeTables_.clear();
+        routeWeights_.clear();
+        routeAlias_.clear();
+        routePorts_ = numPorts;
+    }
+    const bool useAlias = numPorts >= LIGHTGRAPH_ALIAS_ROUTING_MIN_PORTS;
+    const size_t rows = static_cast<size_t>(numPorts) + 1;
+    const size_t tableSize = rows * numPorts;
+    if (model->id >= routeTables_.size()) {
+        routeTables_.resize(static_cast<size_t>(model->id) + 1);
+        routeWeights_.resize(routeTables_.size() * tableSize);
+        if (useAlias) {
+            routeAlias_.resize(routeWeights_.size());
+        }
+    }
+
+    RouteTable& table = routeTables_[model->id];
+    uint16_t* const weights = routeWeights_.data() + model->id * tableSize;
+    if (table.model != model || table.revision != model->routesRevision()) {
+        for (uint8_t r = 0; r < numPorts; r++) {
+            fillRouteRow(model, ports[r], weights + r * numPorts);
+        }
+        fillRouteRow(model, nullptr, weights + numPorts * numPorts);
+        if (useAlias) {
+            for (size_t r = 0; r < rows; r++) {
+                const uint16_t* row = weights + r * numPorts;
+                if (row[numPorts - 1] > 0) {
+                    route_select::buildAlias(row, numPorts, routeAlias(row));
+                }
+            }
+        }
+        table.model = model;
+        table.revision = model->routesRevision();
+    }
+    return weights + slot * numPorts;
+}
+
+route_select::AliasEntry* Intersection::routeAlias(const uint16_t* row) const {
+    return routeAlias_.data() + (row - routeWeights_.data());
 }
 
 void Intersection::emit(RuntimeLight* const light) const {
@@ -117,32 +195,32 @@ void Intersection::emit(RuntimeLight* const light) const {
         }
       }
     }
-    light->owner = this;
+    light->setOwner(this);
 }
 
 void Intersection::update(RuntimeLight* const light) const {
-    if (!light->isExpired) {
+    if (!light->isExpired()) {
         light->resetPixels();
         if (light->shouldExpire()) {
-            if (light->getSpeed() == 0 || (allowEndOfLife && light->position >= 1.f)) { // expire
-                light->isExpired = true;
-                light->owner = NULL;
+            if (light->getSpeed() == 0 || (allowEndOfLife && light->position() >= 1.f)) { // expire
+                light->setExpired(true);
+                light->setOwner(NULL);
             }
-            if (light->isExpired) {
+            if (light->isExpired()) {
                 return;
             }
         }
-        Port* port = light->outPort;
-        if (port == NULL) {
-            port = getPrevOutPort(light);
-        }
+        Port* port = light->outPort();
         if (port == NULL) {
-            port = choosePort(light->getModel(), light);
-        }
-        if (port != light->outPort) {
-            light->setOutPort(port, id);
+            port = getTracedOutPort(light);
+            if (port == NULL) {
+                port = choosePort(light->getModel(), light);
+                traceOutPort(light, port);
+            }
+            light->setOutPort(port);
+            light->setRouteHop(light->routeHop() + 1);
         }
-        if (light->position >= 0.f && light->position < 1.f) { // render
+        if (light->position() >= 0.f && light->position() < 1.f) { // render
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
             if (port != nullptr && !port->isExternal() && port->connection != nullptr &&
                 port->connection->numLeds > 0) {
@@ -150,16 +228,16 @@ void Intersection::update(RuntimeLight* const light) const {
                     ? port->connection->getPixel(static_cast<uint16_t>(port->connection->numLeds - 1))
                     : port->connection->getPixel(0);
                 const uint8_t secondaryWeight = static_cast<uint8_t>(std::clamp<int32_t>(
-                    static_cast<int32_t>(round(light->position * FULL_BRIGHTNESS)),
+                    static_cast<int32_t>(round(light->position() * FULL_BRIGHTNESS)),
                     0,
                     FULL_BRIGHTNESS));
                 const uint8_t primaryWeight = static_cast<uint8_t>(FULL_BRIGHTNESS - secondaryWeight);
                 const RuntimeLight* previous = light->getPrev();
                 const bool previousFullyOwnsAdjacentPixel =
                     previous != nullptr &&
-                    previous->owner == port->connection &&
-                    previous->pixel1 == static_cast<int16_t>(adjacentPixel) &&
-                    previous->pixel1Weight > 0 &&
+                    previous->owner() == port->connection &&
+                    previous->pixel1() == static_cast<int16_t>(adjacentPixel) &&
+                    previous->pixel1Weight() > 0 &&
                     !previous->hasSecondaryPixel();
                 const bool compensateHiddenIngress =
                     secondaryWeight > 0 &&
@@ -192,8 +270,8 @@ void Intersection::update(RuntimeLight* const light) const {
         }
         // sendOut
         light->setInPort(NULL);
-        light->position -= 1.f;
-        light->owner = NULL;
+        light->setPosition(light->position() - 1.f);
+        light->setOwner(NULL);
         if (port != NULL) {
             bool sendList = false;
             if (port->isExternal() && light->list != nullptr) {
@@ -207,25 +285,27 @@ void Intersection::update(RuntimeLight* const light) const {
   }
 }
 
-Port* Intersection::getPrevOutPort(const RuntimeLight* const light) const {
-    Port* port = NULL;
-    const RuntimeLight* linkedPrev = light->getPrev();
-    if (linkedPrev != NULL) {
-        port = linkedPrev->getOutPort(id);
+Port* Intersection::getTracedOutPort(const RuntimeLight* const light) const {
+    if (light->getPrev() == NULL) {
+        return NULL;
     }
-    return port;
+    const LightList::RouteStep* step = light->list->routeStep(light->routeHop());
+    if (step == nullptr || step->intersectionId != id || step->portSlot >= numPorts) {
+        return NULL;
+    }
+    return ports[step->portSlot];
 }
 
-uint16_t Intersection::sumW(const Model* const model, const Port* const incoming) const {
-  uint16_t sum = 0;
-  for (uint8_t i=0; i<numPorts; i++) {
-    Port *port = ports[i];
-    if (port == nullptr) {
-        continue;
+void Intersection::traceOutPort(const RuntimeLight* const light, const Port* const port) const {
+    if (port == NULL || light->list == NULL || !light->list->linked) {
+        return;
+    }
+    for (uint8_t i = 0; i < numPorts; i++) {
+        if (ports[i] == port) {
+            light->list->traceRoute(light->routeHop(), id, i);
+            return;
+        }
     }
-    sum += model->get(port, incoming);
-  }
-  return sum;
 }
 
 Port* Intersection::randomPort(const Port* const incoming, const Behaviour* const behaviour) const {
@@ -247,24 +327,35 @@ Port* Intersection::randomPort(const Port* const incoming, const Behaviour* cons
   if (candidates.empty()) {
       return nullptr;
   }
-  return candidates[(uint8_t) LG_RANDOM(candidates.size())];
+  return candidates[Random::below(candidates.size())];
 }
 
 Port* Intersection::choosePort(const Model* const model, const RuntimeLight* const light) const {
-    Port *incoming = light->inPort;
+    Port *incoming = light->inPort();
     if (model == nullptr) {
         return nullptr;
     }
 
+    const uint16_t* row = routeRow(model, incoming);
+    std::vector<uint16_t> foreignRow;
+    if (row == nullptr) {
+      // Incoming port belongs to another intersection; not worth caching.
+      foreignRow.resize(numPorts);
+      fillRouteRow(model, incoming, foreignRow.data());
+      row = foreignRow.data();
+    }
+
     if (model->getRoutingStrategy() == RoutingStrategy::Deterministic) {
       Port* bestPort = nullptr;
       uint8_t bestWeight = 0;
+      uint16_t previous = 0;
       for (uint8_t i = 0; i < numPorts; i++) {
+        const uint8_t weight = static_cast<uint8_t>(row[i] - previous);
+        previous = row[i];
         Port* port = ports[i];
         if (port == nullptr || port == incoming) {
           continue;
         }
-        const uint8_t weight = model->get(port, incoming);
         if (weight > bestWeight || (weight == bestWeight && bestPort != nullptr && port->id < bestPort->id)) {
           bestWeight = weight;
           bestPort = port;
@@ -278,22 +369,16 @@ Port* Intersection::choosePort(const Model* const model, const RuntimeLight* con
       return randomPort(incoming, light->getBehaviour());
     }
 
-    uint16_t sum = sumW(model, incoming);
+    const uint16_t sum = (numPorts > 0) ? row[numPorts - 1] : 0;
     if (sum == 0) {
       return randomPort(incoming, light->getBehaviour());
     }
-    uint16_t rnd = LG_RANDOM(sum);
-    for (uint8_t i=0; i<numPorts; i++) {
-       Port *port = ports[i];
-       if (port == nullptr) {
-           continue;
-       }
-       uint8_t w = model->get(port, incoming);
-       if (port == incoming || w == 0) continue;
-       if (rnd < w) {
-         return port;
-       }
-       rnd -= w;
+    if (numPorts >= LIGHTGRAPH_ALIAS_ROUTING_MIN_PORTS && foreignRow.empty()) {
+      const uint32_t span = static_cast<uint32_t>(numPorts) * sum;
+      return ports[route_select::pickAlias(routeAlias(row), sum, light->random().below(span))];
     }
-    return NULL;
+    // Zero-weight and incoming ports add nothing to the running sum, so the
+    // first slot whose cumulative weight exceeds the draw is always eligible.
+    const uint8_t slot = route_select::pickCumulative(row, numPorts, light->random().below(sum));
+    return (slot < numPorts) ? ports[slot] : NULL;
   }
@@ -4,6 +4,7 @@
 #include <vector>
 #include "Owner.h"
 #include "Port.h"
+#include "RouteSelect.h"
 
 class Behaviour;
 class Model;
@@ -12,9 +13,9 @@ class Intersection : public Owner {
 
   public:
 
-    static uint8_t nextId;
-  
-    uint8_t id;
+    // Assigned by TopologyObject::addIntersection, in the order intersections
+    // are added to their object.
+    uint16_t id = 0;
     uint8_t numPorts;
     std::vector<Port*> ports; // typically 2, 3, or 4 ports
     uint16_t topPixel;
@@ -38,12 +39,38 @@ class Intersection : public Owner {
     void emit(RuntimeLight* const light) const override;
     void update(RuntimeLight* const light) const override;
 
+    // Routing tables are compiled lazily per model (see routeRow) and follow
+    // Model::routesRevision(). Code that edits `ports`, `numPorts` or the id
+    // of an attached port directly calls invalidateRoutes() afterwards.
+    void invalidateRoutes();
+    // Brings the table for `model` up to date ahead of concurrent routing.
+    void compileRoutes(const Model* model) const;
+
   private:
 
-    uint16_t sumW(const Model* const model, const Port* const incoming) const;
+    struct RouteTable {
+        const Model* model = nullptr;
+        uint32_t revision = 0;
+    };
+
+    const uint16_t* routeRow(const Model* model, const Port* incoming) const;
+    route_select::AliasEntry* routeAlias(const uint16_t* row) const;
+    void fillRouteRow(const Model* model, const Port* incoming, uint16_t* row) const;
     Port* randomPort(const Port* const incoming, const Behaviour* const behaviour) const;
     Port* choosePort(const Model* const model, const RuntimeLight* const light) const;
     Port* getOutPortFor(const RuntimeLight* const light) const;
-    Port* getPrevOutPort(const RuntimeLight* const light) const;
+    // Port the light's list took at this hop, when a linked follower reaches
+    // the intersection the trace recorded for it.
+    Port* getTracedOutPort(const RuntimeLight* const light) const;
+    void traceOutPort(const RuntimeLight* const light, const Port* const port) const;
+
+    // One table per Model::id, each numPorts + 1 rows (one per incoming slot,
+    // then "no incoming port") of numPorts cumulative outgoing weights, all in
+    // routeWeights_. With LIGHTGRAPH_ALIAS_ROUTING_MIN_PORTS or more ports,
+    // routeAlias_ holds the matching alias table for every row.
+    mutable std::vector<RouteTable> routeTables_;
+    mutable std::vector<uint16_t> routeWeights_;
+    mutable std::vector<route_select::AliasEntry> routeAlias_;
+    mutable uint8_t routePorts_ = 0;
   
 };
@@ -1,8 +1,13 @@
 #include "Model.h"
+
+#include <atomic>
+
 #include "TopologyObject.h"
 
-// override from your Sculpture Object
-uint8_t Model::maxWeights = 1;
+uint32_t Model::nextRoutesRevision() {
+    static std::atomic<uint32_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
 
 uint16_t Model::getMaxLength() const {
     if (maxLength > 0) {
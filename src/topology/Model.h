@@ -19,8 +19,6 @@ class Model {
 
   public:
 
-    static uint8_t maxWeights;
-     
     uint8_t id;
     uint8_t defaultW;
     uint8_t emitGroups;
@@ -36,6 +34,7 @@ class Model {
     ~Model() = default;
     
     void put(Port *outgoing, Port *incoming, uint8_t weight) {
+      invalidateRoutes();
       Weight* outgoingWeight = _getOrCreate(outgoing, defaultW);
       Weight* incomingWeight = _getOrCreate(incoming, defaultW);
       if (outgoingWeight != nullptr) {
@@ -77,6 +76,8 @@ class Model {
         if (outgoing == nullptr) {
             return nullptr;
         }
+        // Callers may add conditional weights to the result.
+        invalidateRoutes();
         auto it = weights.find(outgoing->id);
         if (it == weights.end()) {
             auto created = std::make_unique<Weight>(w);
@@ -91,6 +92,7 @@ class Model {
       if (port == nullptr) {
         return;
       }
+      invalidateRoutes();
       weights.erase(port->id);
       for (auto& entry : weights) {
         if (entry.second != nullptr) {
@@ -100,6 +102,7 @@ class Model {
     }
 
     void clearWeights() {
+      invalidateRoutes();
       weights.clear();
     }
 
@@ -107,6 +110,17 @@ class Model {
       return weights.size();
     }
 
+    // Intersections compile their routing tables from `weights` and `defaultW`
+    // and rebuild them when this changes. The mutators above bump it; code
+    // that edits `weights`, a Weight or `defaultW` directly calls
+    // invalidateRoutes() afterwards. Values are unique across all models.
+    uint32_t routesRevision() const {
+      return routesRevision_;
+    }
+    void invalidateRoutes() {
+      routesRevision_ = nextRoutesRevision();
+    }
+
     void setRoutingStrategy(RoutingStrategy strategy) {
       routingStrategy = strategy;
     }
@@ -118,7 +132,10 @@ class Model {
     uint16_t getMaxLength() const;
 
   private:
+    static uint32_t nextRoutesRevision();
+
     TopologyObject* object_ = nullptr;
+    uint32_t routesRevision_ = nextRoutesRevision();
 
     friend class TopologyObject;
 };
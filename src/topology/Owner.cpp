@@ -3,6 +3,6 @@
 #include "../runtime/RuntimeLight.h"
 
 void Owner::add(RuntimeLight* const light) const {
-    light->owner = this;
-    light->owner->update(light);
+    light->setOwner(this);
+    light->owner()->update(light);
 }
@@ -1,5 +1,6 @@
 #include "Port.h"
 
+#include <atomic>
 #include <cstring>
 #include "Connection.h"
 #include "Intersection.h"
@@ -9,12 +10,12 @@
 #include "../runtime/RuntimeLight.h"
 
 // Initialize function pointer to null
-bool (*sendLightViaESPNow)(const uint8_t* mac, uint8_t id, RuntimeLight* const light, bool sendList) = nullptr;
+bool (*sendLightViaESPNow)(const uint8_t* mac, uint16_t id, RuntimeLight* const light, bool sendList) = nullptr;
 
 namespace {
 
-uint16_t gLegacyLivePortCount = 0;
-uint16_t gLegacyNextPortIdHint = 0;
+// Atomic so objects can build and tear down ports on separate threads.
+std::atomic<uint16_t> gLivePortCount{0};
 
 } // namespace
 
@@ -30,7 +31,7 @@ Port::Port(Connection* connection, Intersection* intersection, bool direction, u
             this->intersection->addPort(this);
         }
     }
-    gLegacyLivePortCount++;
+    gLivePortCount.fetch_add(1, std::memory_order_relaxed);
 }
 
 Port::~Port() {
@@ -41,21 +42,11 @@ Port::~Port() {
     if (intersection != nullptr) {
         intersection->removePort(this);
     }
-    if (gLegacyLivePortCount > 0) {
-        gLegacyLivePortCount--;
-    }
+    gLivePortCount.fetch_sub(1, std::memory_order_relaxed);
 }
 
 uint16_t Port::poolCount() {
-    return gLegacyLivePortCount;
-}
-
-void Port::setNextId(uint16_t id) {
-    gLegacyNextPortIdHint = id;
-}
-
-uint16_t Port::nextId() {
-    return gLegacyNextPortIdHint;
+    return gLivePortCount.load(std::memory_order_relaxed);
 }
 
 InternalPort::InternalPort(Connection* connection, Intersection* intersection, bool direction, uint8_t group,
@@ -64,8 +55,8 @@ InternalPort::InternalPort(Connection* connection, Intersection* intersection, b
 }
 
 ExternalPort::ExternalPort(Connection* connection, Intersection* intersection, bool direction, uint8_t group,
-                           const uint8_t device[6], uint8_t targetId, int16_t slotIndex,
-                           int16_t targetIntersectionId, bool hasTargetId)
+                           const uint8_t device[6], uint16_t targetId, int16_t slotIndex,
+                           int32_t targetIntersectionId, bool hasTargetId)
     : Port(connection, intersection, direction, group, slotIndex) {
     memcpy(this->device.data(), device, 6);
     this->targetId = targetId;
@@ -90,11 +81,10 @@ void InternalPort::sendOut(RuntimeLight* const light, bool /*sendList*/) {
     if (light == nullptr) {
         return;
     }
-    if (light->outPort == nullptr) {
+    if (light->outPort() == nullptr) {
         // Remote-injected lights arrive without routing context.
         // Treat this internal port as the ingress direction for this connection pass.
-        const int8_t intersectionId = (intersection != nullptr) ? static_cast<int8_t>(intersection->id) : -1;
-        light->setOutPort(this, intersectionId);
+        light->setOutPort(this);
     }
     handleColorChange(light);
     connection->add(light);
@@ -133,17 +123,12 @@ void ExternalPort::sendOut(RuntimeLight* const light, bool sendList) {
 
     if (sendSucceeded) {
         // Remove each light only when it actually reaches the external port.
-        light->isExpired = true;
+        light->setExpired(true);
         return;
     }
 
     // Failed sends stay local and re-enter normal routing on the next frame.
-    light->isExpired = false;
-    if (intersection != nullptr) {
-        light->owner = intersection;
-        light->setOutPort(nullptr, static_cast<int8_t>(intersection->id));
-    } else {
-        light->owner = nullptr;
-        light->setOutPort(nullptr);
-    }
+    light->setExpired(false);
+    light->setOwner(intersection);
+    light->setOutPort(nullptr);
 }
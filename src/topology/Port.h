@@ -31,9 +31,8 @@ class Port {
     virtual void sendOut(RuntimeLight* const light, bool sendList = false) = 0;
     virtual bool isExternal() const { return false; }
     virtual Type portType() const { return Type::Internal; }
+    // Live ports in the process, for leak checks.
     static uint16_t poolCount();
-    static void setNextId(uint16_t id);
-    static uint16_t nextId();
 
   protected:
     void handleColorChange(RuntimeLight* const light) const;
@@ -50,13 +49,13 @@ class ExternalPort : public Port {
 
   public:
     std::array<uint8_t, 6> device{};
-    uint8_t targetId = 0;
+    uint16_t targetId = 0;
     bool hasTargetId = true;
-    int16_t targetIntersectionId = -1;
+    int32_t targetIntersectionId = -1;
     
     ExternalPort(Connection* connection, Intersection* intersection, bool direction, uint8_t group,
-                 const uint8_t device[6], uint8_t targetId, int16_t slotIndex = -1,
-                 int16_t targetIntersectionId = -1, bool hasTargetId = true);
+                 const uint8_t device[6], uint16_t targetId, int16_t slotIndex = -1,
+                 int32_t targetIntersectionId = -1, bool hasTargetId = true);
     virtual void sendOut(RuntimeLight* const light, bool sendList = false) override;
     virtual bool isExternal() const override { return true; }
     virtual Type portType() const override { return Type::External; }
@@ -64,4 +63,4 @@ class ExternalPort : public Port {
 
 // Legacy global fallback for source integrations that have not yet migrated to
 // TopologyObject::setExternalSendHook().
-extern bool (*sendLightViaESPNow)(const uint8_t* mac, uint8_t id, RuntimeLight* const light, bool sendList);
+extern bool (*sendLightViaESPNow)(const uint8_t* mac, uint16_t id, RuntimeLight* const light, bool sendList);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+// Weighted port selection over one routing row.
+//
+// A row holds `count` cumulative weights (see Intersection::routeRow), so
+// port i has weight row[i] - row[i - 1] and the row total is row[count - 1].
+// pickCumulative() is the linear scan; the alias table (Walker/Vose) picks
+// with one division and one compare. Both map draws in their range to ports
+// with exactly the row's weights: the alias table is built in integers, so
+// over all count * total draws port i comes up count * weight(i) times.
+namespace route_select {
+
+struct AliasEntry {
+    uint16_t threshold; // keep this column when draw % total < threshold
+    uint8_t alias;      // otherwise take this port
+};
+
+// Port for `draw` in [0, total); count when draw >= total.
+inline uint8_t pickCumulative(const uint16_t* row, uint8_t count, uint16_t draw) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (draw < row[i]) {
+            return i;
+        }
+    }
+    return count;
+}
+
+// Fills `table` (count entries) for a row with a non-zero total.
+inline void buildAlias(const uint16_t* row, uint8_t count, AliasEntry* table) {
+    const uint16_t total = row[count - 1];
+    // Each column holds `total` draws; port weights are scaled by `count`
+    // so the columns sum to count * total.
+    uint32_t scaled[256];
+    uint8_t small[256];
+    uint8_t large[256];
+    uint16_t smallCount = 0;
+    uint16_t largeCount = 0;
+    uint16_t previous = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        scaled[i] = static_cast<uint32_t>(row[i] - previous) * count;
+        previous = row[i];
+        if (scaled[i] < total) {
+            small[smallCount++] = i;
+        } else {
+            large[largeCount++] = i;
+        }
+    }
+    while (smallCount > 0 && largeCount > 0) {
+        const uint8_t lesser = small[--smallCount];
+        const uint8_t greater = large[largeCount - 1];
+        table[lesser].threshold = static_cast<uint16_t>(scaled[lesser]);
+        table[lesser].alias = greater;
+        scaled[greater] -= total - scaled[lesser];
+        if (scaled[greater] < total) {
+            largeCount--;
+            small[smallCount++] = greater;
+        }
+    }
+    // Whatever is left fills its column exactly.
+    while (largeCount > 0) {
+        const uint8_t i = large[--largeCount];
+        table[i].threshold = total;
+        table[i].alias = i;
+    }
+    while (smallCount > 0) {
+        const uint8_t i = small[--smallCount];
+        table[i].threshold = total;
+        table[i].alias = i;
+    }
+}
+
+// Port for `draw` in [0, count * total).
+inline uint8_t pickAlias(const AliasEntry* table, uint16_t total, uint32_t draw) {
+    const AliasEntry& entry = table[draw / total];
+    return (draw % total < entry.threshold) ? static_cast<uint8_t>(draw / total) : entry.alias;
+}
+
+} // namespace route_select
@@ -49,7 +49,7 @@ inline bool parseTopologyMacAddress(const String& input, uint8_t out[6]) {
 }
 
 inline size_t normalizeTopologySnapshotDuplicatePortIds(TopologySnapshot& snapshot) {
-  bool usedIds[256] = {false};
+  std::vector<bool> usedIds(static_cast<size_t>(Port::INVALID_ID) + 1u, false);
   bool hasDuplicate = false;
 
   for (const TopologyPortSnapshot& port : snapshot.ports) {
@@ -64,26 +64,24 @@ inline size_t normalizeTopologySnapshotDuplicatePortIds(TopologySnapshot& snapsh
     return 0;
   }
 
-  for (size_t i = 0; i < 256; i++) {
-    usedIds[i] = false;
-  }
+  usedIds.assign(usedIds.size(), false);
 
   size_t normalizedCount = 0;
+  uint16_t replacementId = 0;
   for (TopologyPortSnapshot& port : snapshot.ports) {
     if (!usedIds[port.id]) {
       usedIds[port.id] = true;
       continue;
     }
 
-    uint16_t replacementId = 0;
-    while (replacementId < 256 && usedIds[replacementId]) {
+    while (replacementId < Port::INVALID_ID && usedIds[replacementId]) {
       replacementId += 1;
     }
-    if (replacementId >= 256) {
+    if (replacementId >= Port::INVALID_ID) {
       break;
     }
 
-    port.id = static_cast<uint8_t>(replacementId);
+    port.id = replacementId;
     usedIds[port.id] = true;
     normalizedCount += 1;
   }
@@ -102,8 +100,8 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
     error = "Missing schemaVersion";
     return false;
   }
-  if (schemaVersion != 3) {
-    error = "Unsupported schemaVersion; expected 3";
+  if (schemaVersion < TOPOLOGY_SCHEMA_VERSION_MIN || schemaVersion > TOPOLOGY_SCHEMA_VERSION) {
+    error = "Unsupported schemaVersion; expected 3 or 4";
     return false;
   }
   snapshot.schemaVersion = static_cast<uint8_t>(schemaVersion);
@@ -127,7 +125,7 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
     long group = 0;
     bool allowEndOfLife = true;
     bool allowEmit = true;
-    if (!parseTopologyBoundedLong(intersectionJson["id"], 0, 255, id) ||
+    if (!parseTopologyBoundedLong(intersectionJson["id"], 0, 65535, id) ||
         !parseTopologyBoundedLong(intersectionJson["numPorts"], 2, 9, numPorts) ||
         !parseTopologyBoundedLong(intersectionJson["topPixel"], 0, 65535, topPixel) ||
         !parseTopologyBoundedLong(intersectionJson["group"], 1, 255, group)) {
@@ -156,7 +154,7 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
       allowEmit = intersectionJson["allowEmit"].as<bool>();
     }
     snapshot.intersections.push_back({
-        static_cast<uint8_t>(id),
+        static_cast<uint16_t>(id),
         static_cast<uint8_t>(numPorts),
         static_cast<uint16_t>(topPixel),
         static_cast<int16_t>(bottomPixel),
@@ -176,16 +174,16 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
     long toIntersectionId = 0;
     long group = 0;
     long numLeds = 0;
-    if (!parseTopologyBoundedLong(connectionJson["fromIntersectionId"], 0, 255, fromIntersectionId) ||
-        !parseTopologyBoundedLong(connectionJson["toIntersectionId"], 0, 255, toIntersectionId) ||
+    if (!parseTopologyBoundedLong(connectionJson["fromIntersectionId"], 0, 65535, fromIntersectionId) ||
+        !parseTopologyBoundedLong(connectionJson["toIntersectionId"], 0, 65535, toIntersectionId) ||
         !parseTopologyBoundedLong(connectionJson["group"], 1, 255, group) ||
         !parseTopologyBoundedLong(connectionJson["numLeds"], 0, 65535, numLeds)) {
       error = "Invalid connection entry";
       return false;
     }
     snapshot.connections.push_back({
-        static_cast<uint8_t>(fromIntersectionId),
-        static_cast<uint8_t>(toIntersectionId),
+        static_cast<uint16_t>(fromIntersectionId),
+        static_cast<uint16_t>(toIntersectionId),
         static_cast<uint8_t>(group),
         static_cast<uint16_t>(numLeds),
     });
@@ -201,8 +199,8 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
     long intersectionId = 0;
     long slotIndex = 0;
     long group = 0;
-    if (!parseTopologyBoundedLong(portJson["id"], 0, 255, id) ||
-        !parseTopologyBoundedLong(portJson["intersectionId"], 0, 255, intersectionId) ||
+    if (!parseTopologyBoundedLong(portJson["id"], 0, Port::INVALID_ID - 1, id) ||
+        !parseTopologyBoundedLong(portJson["intersectionId"], 0, 65535, intersectionId) ||
         !parseTopologyBoundedLong(portJson["slotIndex"], 0, 255, slotIndex) ||
         !parseTopologyBoundedLong(portJson["group"], 1, 255, group)) {
       error = "Invalid port entry";
@@ -249,7 +247,7 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
         }
       }
       if (!portJson["targetPortId"].isNull()) {
-        if (!parseTopologyBoundedLong(portJson["targetPortId"], 0, 255, targetPortId)) {
+        if (!parseTopologyBoundedLong(portJson["targetPortId"], 0, 65535, targetPortId)) {
           if (!options.allowLenientExternalPorts) {
             error = "Invalid external port targetPortId";
             return false;
@@ -259,7 +257,7 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
         }
       }
       if (!portJson["targetIntersectionId"].isNull() &&
-          !parseTopologyBoundedLong(portJson["targetIntersectionId"], 0, 255, targetIntersectionId) &&
+          !parseTopologyBoundedLong(portJson["targetIntersectionId"], 0, 65535, targetIntersectionId) &&
           !options.allowLenientExternalPorts) {
         error = "Invalid external port targetIntersectionId";
         return false;
@@ -279,11 +277,11 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
             continue;
           }
           if (hasTargetPortId) {
-            if (!existingPort.hasTargetPortId || existingPort.targetPortId != static_cast<uint8_t>(targetPortId)) {
+            if (!existingPort.hasTargetPortId || existingPort.targetPortId != static_cast<uint16_t>(targetPortId)) {
               continue;
             }
           } else if (existingPort.hasTargetPortId ||
-                     existingPort.targetIntersectionId != static_cast<int16_t>(targetIntersectionId)) {
+                     existingPort.targetIntersectionId != static_cast<int32_t>(targetIntersectionId)) {
             continue;
           }
 
@@ -314,15 +312,15 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
     }
 
     snapshot.ports.push_back({
-        static_cast<uint8_t>(id),
-        static_cast<uint8_t>(intersectionId),
+        static_cast<uint16_t>(id),
+        static_cast<uint16_t>(intersectionId),
         static_cast<uint8_t>(slotIndex),
         portType,
         direction,
         static_cast<uint8_t>(group),
         deviceMac,
-        static_cast<uint8_t>(targetPortId),
-        static_cast<int16_t>(targetIntersectionId),
+        static_cast<uint16_t>(targetPortId),
+        static_cast<int32_t>(targetIntersectionId),
         hasTargetPortId,
     });
   }
@@ -362,13 +360,13 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
         for (JsonObjectConst weightJson : weights) {
           long outgoingPortId = 0;
           long portDefaultWeight = 0;
-          if (!parseTopologyBoundedLong(weightJson["outgoingPortId"], 0, 255, outgoingPortId) ||
+          if (!parseTopologyBoundedLong(weightJson["outgoingPortId"], 0, Port::INVALID_ID - 1, outgoingPortId) ||
               !parseTopologyBoundedLong(weightJson["defaultWeight"], 0, 255, portDefaultWeight)) {
             error = "Invalid model weight entry";
             return false;
           }
           TopologyPortWeightSnapshot weightSnapshot{
-              static_cast<uint8_t>(outgoingPortId),
+              static_cast<uint16_t>(outgoingPortId),
               static_cast<uint8_t>(portDefaultWeight),
               {},
           };
@@ -378,13 +376,13 @@ inline bool parseTopologySnapshotFromJson(JsonObjectConst root, TopologySnapshot
             for (JsonObjectConst conditionalJson : conditionals) {
               long incomingPortId = 0;
               long conditionalWeight = 0;
-              if (!parseTopologyBoundedLong(conditionalJson["incomingPortId"], 0, 255, incomingPortId) ||
+              if (!parseTopologyBoundedLong(conditionalJson["incomingPortId"], 0, Port::INVALID_ID - 1, incomingPortId) ||
                   !parseTopologyBoundedLong(conditionalJson["weight"], 0, 255, conditionalWeight)) {
                 error = "Invalid conditional model weight entry";
                 return false;
               }
               weightSnapshot.conditionals.push_back({
-                  static_cast<uint8_t>(incomingPortId),
+                  static_cast<uint16_t>(incomingPortId),
                   static_cast<uint8_t>(conditionalWeight),
               });
             }
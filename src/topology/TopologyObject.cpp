@@ -12,7 +12,7 @@
 namespace {
 
 struct IntersectionSlotKey {
-    uint8_t intersectionId;
+    uint16_t intersectionId;
     uint8_t slotIndex;
 
     bool operator==(const IntersectionSlotKey& other) const {
@@ -36,7 +36,7 @@ bool isZeroMac(const std::array<uint8_t, 6>& mac) {
 }
 
 bool matchesExternalEndpoint(const ExternalPort* port, const uint8_t device[6], bool hasTargetPortId,
-                            uint8_t targetPortId, int16_t targetIntersectionId, bool direction,
+                            uint16_t targetPortId, int32_t targetIntersectionId, bool direction,
                             uint8_t group) {
     if (port == nullptr || port->direction != direction || port->group != group ||
         std::memcmp(port->device.data(), device, 6) != 0) {
@@ -161,6 +161,9 @@ bool TopologyObject::registerPort(Port* port, std::optional<uint16_t> preferredI
     port->id = portId;
     port->object = this;
     portRegistry_[portId] = port;
+    if (port->intersection != nullptr) {
+        port->intersection->invalidateRoutes();
+    }
     nextPortId_ = static_cast<uint16_t>(std::max<uint32_t>(nextPortId_, static_cast<uint32_t>(portId) + 1U));
     return true;
 }
@@ -210,6 +213,7 @@ Intersection* TopologyObject::addIntersection(Intersection *intersection) {
         return nullptr;
     }
     ownedIntersections_.emplace_back(intersection);
+    intersection->id = nextIntersectionId_++;
 
     for (uint8_t i = 0; i < MAX_GROUPS; i++) {
         if (intersection->group & groupMaskForIndex(i)) {
@@ -217,6 +221,7 @@ Intersection* TopologyObject::addIntersection(Intersection *intersection) {
             break;
         }
     }
+    invalidateEmitters();
     return intersection;
 }
 
@@ -240,12 +245,13 @@ Connection* TopologyObject::addConnection(Connection *connection) {
             break;
         }
     }
+    invalidateEmitters();
     return connection;
 }
 
 ExternalPort* TopologyObject::addExternalPort(Intersection* intersection, uint8_t slotIndex, bool direction,
-                                              uint8_t group, const uint8_t device[6], uint8_t targetPortId,
-                                              int16_t targetIntersectionId,
+                                              uint8_t group, const uint8_t device[6], uint16_t targetPortId,
+                                              int32_t targetIntersectionId,
                                               bool hasTargetPortId,
                                               bool allowDuplicateEndpoint) {
     if (intersection == nullptr || slotIndex >= intersection->numPorts || intersection->ports[slotIndex] != nullptr) {
@@ -341,6 +347,7 @@ bool TopologyObject::removeIntersection(Intersection* intersection) {
             intersections.end());
         removedFromView = removedFromView || intersections.size() != before;
     }
+    invalidateEmitters();
 
     const bool owned = std::any_of(
         ownedIntersections_.begin(),
@@ -362,6 +369,7 @@ bool TopologyObject::removeConnection(uint8_t groupIndex, size_t index) {
     }
     Connection* connection = conn[groupIndex][index];
     conn[groupIndex].erase(conn[groupIndex].begin() + static_cast<std::ptrdiff_t>(index));
+    invalidateEmitters();
     if (connection != nullptr) {
         removePortFromModels(connection->fromPort);
         removePortFromModels(connection->toPort);
@@ -378,6 +386,7 @@ bool TopologyObject::removeConnection(Connection* connection) {
         auto it = std::find(conn[i].begin(), conn[i].end(), connection);
         if (it != conn[i].end()) {
             conn[i].erase(it);
+            invalidateEmitters();
             removePortFromModels(connection->fromPort);
             removePortFromModels(connection->toPort);
             releaseOwnership(connection);
@@ -414,6 +423,7 @@ bool TopologyObject::updateIntersection(Intersection* intersection, const Topolo
         }
         intersection->ports = std::move(resizedPorts);
         intersection->numPorts = update.numPorts;
+        intersection->invalidateRoutes();
     }
 
     const bool topologyChanged =
@@ -468,10 +478,11 @@ bool TopologyObject::updateIntersection(Intersection* intersection, const Topolo
 
     intersection->allowEndOfLife = update.allowEndOfLife;
     intersection->allowEmit = update.allowEmit;
+    invalidateEmitters();
     return true;
 }
 
-Intersection* TopologyObject::findIntersectionById(uint8_t intersectionId) const {
+Intersection* TopologyObject::findIntersectionById(uint16_t intersectionId) const {
     for (uint8_t group = 0; group < MAX_GROUPS; group++) {
         for (Intersection* intersection : inter[group]) {
             if (intersection != nullptr && intersection->id == intersectionId) {
@@ -482,7 +493,7 @@ Intersection* TopologyObject::findIntersectionById(uint8_t intersectionId) const
     return nullptr;
 }
 
-Intersection* TopologyObject::findIntersectionByIdAndGroup(uint8_t intersectionId, uint8_t requestedGroup) const {
+Intersection* TopologyObject::findIntersectionByIdAndGroup(uint16_t intersectionId, uint8_t requestedGroup) const {
     const uint8_t maxGroupMask = static_cast<uint8_t>((1u << MAX_GROUPS) - 1u);
 
     if (requestedGroup < MAX_GROUPS) {
@@ -531,7 +542,7 @@ Intersection* TopologyObject::findIntersectionContainingInternalPortId(uint16_t
 }
 
 ExternalPort* TopologyObject::findExternalPortByExactParams(const uint8_t deviceMac[6], bool hasTargetPortId,
-                                                            uint8_t targetPortId, int16_t targetIntersectionId,
+                                                            uint16_t targetPortId, int32_t targetIntersectionId,
                                                             bool direction, uint8_t group) const {
     for (uint8_t groupIndex = 0; groupIndex < MAX_GROUPS; groupIndex++) {
         for (Intersection* intersection : inter[groupIndex]) {
@@ -600,6 +611,7 @@ bool TopologyObject::ensureIntersectionHasFreePortSlot(Intersection* intersectio
     }
     intersection->ports = std::move(resizedPorts);
     intersection->numPorts = nextPortCount;
+    intersection->invalidateRoutes();
     return true;
 }
 
@@ -732,7 +744,7 @@ void TopologyObject::recalculateConnections(bool preserveVirtualConnections) {
 
 bool TopologyObject::exportSnapshot(TopologySnapshot& snapshot) const {
     snapshot = TopologySnapshot{};
-    snapshot.schemaVersion = 3;
+    snapshot.schemaVersion = TOPOLOGY_SCHEMA_VERSION;
     snapshot.pixelCount = pixelCount;
     snapshot.gaps = gaps;
 
@@ -764,12 +776,12 @@ bool TopologyObject::exportSnapshot(TopologySnapshot& snapshot) const {
             if (port == nullptr) {
                 continue;
             }
-            if (port->id > std::numeric_limits<uint8_t>::max()) {
+            if (port->id == Port::INVALID_ID) {
                 snapshot = TopologySnapshot{};
                 return false;
             }
             TopologyPortSnapshot portSnapshot{
-                static_cast<uint8_t>(port->id),
+                port->id,
                 intersection->id,
                 slot,
                 port->isExternal() ? TopologyPortType::External : TopologyPortType::Internal,
@@ -830,7 +842,7 @@ bool TopologyObject::exportSnapshot(TopologySnapshot& snapshot) const {
                 continue;
             }
             TopologyPortWeightSnapshot weightSnapshot{
-                static_cast<uint8_t>(weightEntry.first),
+                weightEntry.first,
                 weightEntry.second->defaultWeight(),
                 {},
             };
@@ -839,7 +851,7 @@ bool TopologyObject::exportSnapshot(TopologySnapshot& snapshot) const {
                     continue;
                 }
                 weightSnapshot.conditionals.push_back({
-                    static_cast<uint8_t>(conditional.first),
+                    conditional.first,
                     conditional.second,
                 });
             }
@@ -867,12 +879,13 @@ bool TopologyObject::exportSnapshot(TopologySnapshot& snapshot) const {
 }
 
 bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool replaceModels) {
-    if (snapshot.schemaVersion != 3 || snapshot.pixelCount == 0) {
+    if (snapshot.schemaVersion < TOPOLOGY_SCHEMA_VERSION_MIN ||
+        snapshot.schemaVersion > TOPOLOGY_SCHEMA_VERSION || snapshot.pixelCount == 0) {
         return false;
     }
 
-    std::unordered_set<uint8_t> intersectionIds;
-    std::unordered_map<uint8_t, uint8_t> intersectionPortCapacity;
+    std::unordered_set<uint16_t> intersectionIds;
+    std::unordered_map<uint16_t, uint8_t> intersectionPortCapacity;
     for (const TopologyIntersectionSnapshot& intersection : snapshot.intersections) {
         if (intersection.numPorts == 0 || !intersectionIds.insert(intersection.id).second) {
             return false;
@@ -880,12 +893,12 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
         intersectionPortCapacity[intersection.id] = intersection.numPorts;
     }
 
-    std::unordered_set<uint8_t> snapshotPortIds;
+    std::unordered_set<uint16_t> snapshotPortIds;
     std::unordered_set<IntersectionSlotKey, IntersectionSlotKeyHash> occupiedSlots;
     for (const TopologyPortSnapshot& port : snapshot.ports) {
         auto capacityIt = intersectionPortCapacity.find(port.intersectionId);
         if (capacityIt == intersectionPortCapacity.end() || port.slotIndex >= capacityIt->second ||
-            !snapshotPortIds.insert(port.id).second) {
+            port.id == Port::INVALID_ID || !snapshotPortIds.insert(port.id).second) {
             return false;
         }
         if (port.type != TopologyPortType::Internal && port.type != TopologyPortType::External) {
@@ -896,7 +909,7 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
         }
         if (port.targetIntersectionId != TOPOLOGY_TARGET_INTERSECTION_UNSET &&
             (port.targetIntersectionId < 0 ||
-             port.targetIntersectionId > static_cast<int16_t>(std::numeric_limits<uint8_t>::max()))) {
+             port.targetIntersectionId > static_cast<int32_t>(std::numeric_limits<uint16_t>::max()))) {
             return false;
         }
         const IntersectionSlotKey slotKey{port.intersectionId, port.slotIndex};
@@ -944,7 +957,7 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
         candidate.addGap(gap.fromPixel, gap.toPixel);
     }
 
-    std::unordered_map<uint8_t, Intersection*> intersectionsById;
+    std::unordered_map<uint16_t, Intersection*> intersectionsById;
     uint16_t maxIntersectionId = 0;
     for (const TopologyIntersectionSnapshot& intersectionSnapshot : snapshot.intersections) {
         Intersection* created = candidate.addIntersection(new Intersection(
@@ -964,10 +977,9 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
         }
     }
 
-    uint8_t importedNextIntersectionId = Intersection::nextId;
+    uint16_t importedNextIntersectionId = nextIntersectionId_;
     if (!snapshot.intersections.empty()) {
-        importedNextIntersectionId =
-            static_cast<uint8_t>((maxIntersectionId + 1) % (std::numeric_limits<uint8_t>::max() + 1));
+        importedNextIntersectionId = static_cast<uint16_t>(maxIntersectionId + 1);
     }
 
     for (const TopologyConnectionSnapshot& connectionSnapshot : snapshot.connections) {
@@ -979,8 +991,8 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
         }
     }
 
-    std::unordered_map<uint8_t, Port*> remappedPorts;
-    std::unordered_map<uint8_t, std::vector<const TopologyPortSnapshot*>> portsByIntersection;
+    std::unordered_map<uint16_t, Port*> remappedPorts;
+    std::unordered_map<uint16_t, std::vector<const TopologyPortSnapshot*>> portsByIntersection;
     for (const TopologyPortSnapshot& portSnapshot : snapshot.ports) {
         portsByIntersection[portSnapshot.intersectionId].push_back(&portSnapshot);
     }
@@ -1048,6 +1060,7 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
         }
 
         intersection->ports.assign(intersection->numPorts, nullptr);
+        intersection->invalidateRoutes();
 
         for (const TopologyPortSnapshot* snapshotPort : internalSnapshots) {
             auto bestIt = runtimeInternalPorts.end();
@@ -1175,8 +1188,9 @@ bool TopologyObject::importSnapshot(const TopologySnapshot& snapshot, bool repla
     std::swap(nextPortId_, candidate.nextPortId_);
     std::swap(runtimeContext_, candidate.runtimeContext_);
     rebindImportedState(*this);
+    invalidateEmitters();
     runtimeContext_ = candidate.runtimeContext_;
-    Intersection::nextId = importedNextIntersectionId;
+    nextIntersectionId_ = importedNextIntersectionId;
     return true;
 }
 
@@ -1202,6 +1216,21 @@ void TopologyObject::removePortFromModels(const Port* port) {
     }
 }
 
+void TopologyObject::compileRoutes() const {
+    for (uint8_t i = 0; i < MAX_GROUPS; i++) {
+        for (const Intersection* intersection : inter[i]) {
+            if (intersection == nullptr) {
+                continue;
+            }
+            for (const Model* model : models) {
+                if (model != nullptr) {
+                    intersection->compileRoutes(model);
+                }
+            }
+        }
+    }
+}
+
 void TopologyObject::trimTrailingEmptyPortSlots(Intersection* intersection, uint8_t minPorts) {
     if (intersection == nullptr) {
         return;
@@ -1221,6 +1250,7 @@ void TopologyObject::trimTrailingEmptyPortSlots(Intersection* intersection, uint
     if (trimmedNumPorts != intersection->numPorts) {
         intersection->numPorts = trimmedNumPorts;
         intersection->ports.resize(trimmedNumPorts);
+        intersection->invalidateRoutes();
     }
 }
 
@@ -1267,7 +1297,7 @@ Connection* TopologyObject::addBridge(uint16_t fromPixel, uint16_t toPixel, uint
     return addConnection(new Connection(from, to, group));
 }
 
-Intersection* TopologyObject::getIntersection(uint8_t i, uint8_t groups) {
+Intersection* TopologyObject::getIntersection(uint16_t i, uint8_t groups) {
     for (uint8_t j = 0; j < MAX_GROUPS; j++) {
         if (groups == 0 || (groups & groupMaskForIndex(j))) {
             if (i < inter[j].size()) {
@@ -1279,34 +1309,34 @@ Intersection* TopologyObject::getIntersection(uint8_t i, uint8_t groups) {
     return nullptr;
 }
 
-Intersection* TopologyObject::getEmittableIntersection(uint8_t i, uint8_t groups) {
+void TopologyObject::invalidateEmitters() {
+    for (EmitterIndex& index : emitterIndex_) {
+        index.valid = false;
+    }
+}
+
+const TopologyObject::EmitterIndex& TopologyObject::emitterIndex(uint8_t groups) const {
+    // Mask 0 selects every group; bits past MAX_GROUPS select nothing.
+    const uint8_t mask = groups == 0 ? kAllGroupsMask : static_cast<uint8_t>(groups & kAllGroupsMask);
+    EmitterIndex& index = emitterIndex_[mask];
+    if (index.valid) {
+        return index;
+    }
+    index.intersections.clear();
+    index.connections.clear();
     for (uint8_t groupIndex = 0; groupIndex < MAX_GROUPS; groupIndex++) {
-        if (groups != 0 && (groups & groupMaskForIndex(groupIndex)) == 0) {
+        if ((mask & groupMaskForIndex(groupIndex)) == 0) {
             continue;
         }
         for (Intersection* intersection : inter[groupIndex]) {
-            if (intersection == nullptr || !intersection->allowEmit) {
-                continue;
-            }
-            if (i == 0) {
-                return intersection;
-            }
-            i--;
-        }
-    }
-    return nullptr;
-}
-
-Connection* TopologyObject::getConnection(uint8_t i, uint8_t groups) {
-    for (uint8_t j = 0; j < MAX_GROUPS; j++) {
-        if (groups == 0 || (groups & groupMaskForIndex(j))) {
-            if (i < conn[j].size()) {
-                return conn[j][i];
+            if (intersection != nullptr && intersection->allowEmit) {
+                index.intersections.push_back(intersection);
             }
-            i -= conn[j].size();
         }
+        index.connections.insert(index.connections.end(), conn[groupIndex].begin(), conn[groupIndex].end());
     }
-    return nullptr;
+    index.valid = true;
+    return index;
 }
 
 // Gap initialization removed - vectors handle dynamic sizing
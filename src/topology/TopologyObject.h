@@ -22,28 +22,33 @@ enum class TopologyPortType : uint8_t {
     External = 1,
 };
 
-constexpr int16_t TOPOLOGY_TARGET_INTERSECTION_UNSET = -1;
+constexpr int32_t TOPOLOGY_TARGET_INTERSECTION_UNSET = -1;
+
+// Schema 4 carries 16-bit intersection and port ids. Schema 3 snapshots,
+// whose ids all fit in 8 bits, still import unchanged.
+constexpr uint8_t TOPOLOGY_SCHEMA_VERSION = 4;
+constexpr uint8_t TOPOLOGY_SCHEMA_VERSION_MIN = 3;
 
 struct TopologyPortSnapshot {
-    uint8_t id;
-    uint8_t intersectionId;
+    uint16_t id;
+    uint16_t intersectionId;
     uint8_t slotIndex;
     TopologyPortType type;
     bool direction;
     uint8_t group;
     std::array<uint8_t, 6> deviceMac;
-    uint8_t targetPortId;
-    int16_t targetIntersectionId = TOPOLOGY_TARGET_INTERSECTION_UNSET;
+    uint16_t targetPortId;
+    int32_t targetIntersectionId = TOPOLOGY_TARGET_INTERSECTION_UNSET;
     bool hasTargetPortId = false;
 };
 
 struct TopologyWeightConditionalSnapshot {
-    uint8_t incomingPortId;
+    uint16_t incomingPortId;
     uint8_t weight;
 };
 
 struct TopologyPortWeightSnapshot {
-    uint8_t outgoingPortId;
+    uint16_t outgoingPortId;
     uint8_t defaultWeight;
     std::vector<TopologyWeightConditionalSnapshot> conditionals;
 };
@@ -58,7 +63,7 @@ struct TopologyModelSnapshot {
 };
 
 struct TopologyIntersectionSnapshot {
-    uint8_t id;
+    uint16_t id;
     uint8_t numPorts;
     uint16_t topPixel;
     int16_t bottomPixel;
@@ -68,14 +73,14 @@ struct TopologyIntersectionSnapshot {
 };
 
 struct TopologyConnectionSnapshot {
-    uint8_t fromIntersectionId;
-    uint8_t toIntersectionId;
+    uint16_t fromIntersectionId;
+    uint16_t toIntersectionId;
     uint8_t group;
     uint16_t numLeds;
 };
 
 struct TopologySnapshot {
-    uint8_t schemaVersion = 3;
+    uint8_t schemaVersion = TOPOLOGY_SCHEMA_VERSION;
     uint16_t pixelCount;
     std::vector<TopologyIntersectionSnapshot> intersections;
     std::vector<TopologyConnectionSnapshot> connections;
@@ -102,6 +107,8 @@ class TopologyObject {
     std::vector<Connection*> conn[MAX_GROUPS];
     std::vector<Model*> models;
     std::vector<PixelGap> gaps;
+    // Weights per model the object expects to configure; set by each shape.
+    uint8_t maxWeights = 1;
 
     TopologyObject(uint16_t pixelCount);
     virtual ~TopologyObject();
@@ -116,21 +123,24 @@ class TopologyObject {
     virtual Intersection* addIntersection(Intersection *intersection);
     virtual Connection* addConnection(Connection *connection);
     virtual ExternalPort* addExternalPort(Intersection* intersection, uint8_t slotIndex, bool direction,
-                                          uint8_t group, const uint8_t device[6], uint8_t targetPortId,
-                                          int16_t targetIntersectionId = TOPOLOGY_TARGET_INTERSECTION_UNSET,
+                                          uint8_t group, const uint8_t device[6], uint16_t targetPortId,
+                                          int32_t targetIntersectionId = TOPOLOGY_TARGET_INTERSECTION_UNSET,
                                           bool hasTargetPortId = true,
                                           bool allowDuplicateEndpoint = false);
     bool removeExternalPort(Port* port);
+    bool hasExternalPorts() const {
+        return !ownedExternalPorts_.empty();
+    }
     bool removeIntersection(uint8_t groupIndex, size_t index);
     bool removeIntersection(Intersection* intersection);
     bool removeConnection(uint8_t groupIndex, size_t index);
     bool removeConnection(Connection* connection);
     bool updateIntersection(Intersection* intersection, const TopologyIntersectionUpdate& update);
-    Intersection* findIntersectionById(uint8_t intersectionId) const;
-    Intersection* findIntersectionByIdAndGroup(uint8_t intersectionId, uint8_t requestedGroup) const;
+    Intersection* findIntersectionById(uint16_t intersectionId) const;
+    Intersection* findIntersectionByIdAndGroup(uint16_t intersectionId, uint8_t requestedGroup) const;
     Intersection* findIntersectionContainingInternalPortId(uint16_t internalPortId) const;
     ExternalPort* findExternalPortByExactParams(const uint8_t deviceMac[6], bool hasTargetPortId,
-                                                uint8_t targetPortId, int16_t targetIntersectionId,
+                                                uint16_t targetPortId, int32_t targetIntersectionId,
                                                 bool direction, uint8_t group) const;
     Port* findPortById(uint16_t portId) const;
     bool hasAvailablePort(const Intersection* intersection) const;
@@ -141,6 +151,9 @@ class TopologyObject {
     void recalculateConnections(bool preserveVirtualConnections = true);
     bool exportSnapshot(TopologySnapshot& snapshot) const;
     bool importSnapshot(const TopologySnapshot& snapshot, bool replaceModels = true);
+    // Compiles every intersection's routing table for every model, so that
+    // routing during a concurrent update pass only reads them.
+    void compileRoutes() const;
     virtual Connection* addBridge(uint16_t fromPixel, uint16_t toPixel, uint8_t group, uint8_t numPorts = 2);
     LightgraphRuntimeContext& runtimeContext() { return runtimeContext_; }
     const LightgraphRuntimeContext& runtimeContext() const { return runtimeContext_; }
@@ -154,10 +167,9 @@ class TopologyObject {
     Model* getModel(int i) {
       return i >= 0 && static_cast<size_t>(i) < models.size() ? models[i] : nullptr;
     }
-    Intersection* getIntersection(uint8_t i, uint8_t groups);
-    Intersection* getEmittableIntersection(uint8_t i, uint8_t groups);
-    uint8_t countIntersections(uint8_t groups) {
-        uint8_t count = 0;
+    Intersection* getIntersection(uint16_t i, uint8_t groups);
+    uint16_t countIntersections(uint8_t groups) {
+        uint16_t count = 0;
         for (uint8_t i=0; i<MAX_GROUPS; i++) {
             if (groups == 0 || (groups & groupMaskForIndex(i))) {
                 count += inter[i].size();
@@ -165,30 +177,24 @@ class TopologyObject {
         }
         return count;
     }
-    uint8_t countEmittableIntersections(uint8_t groups) const {
-        uint8_t count = 0;
-        for (uint8_t i = 0; i < MAX_GROUPS; i++) {
-            if (groups != 0 && (groups & groupMaskForIndex(i)) == 0) {
-                continue;
-            }
-            for (const Intersection* intersection : inter[i]) {
-                if (intersection != nullptr && intersection->allowEmit) {
-                    count++;
-                }
-            }
-        }
-        return count;
+    // Emitters are served from a per-group-mask index built on first use and
+    // dropped by every topology mutation made through this class. Code that
+    // flips Intersection::allowEmit directly must call invalidateEmitters().
+    Intersection* getEmittableIntersection(uint16_t i, uint8_t groups) const {
+        const EmitterIndex& index = emitterIndex(groups);
+        return i < index.intersections.size() ? index.intersections[i] : nullptr;
     }
-    Connection* getConnection(uint8_t i, uint8_t groups);
-    uint8_t countConnections(uint8_t groups) {
-        uint8_t count = 0;
-        for (uint8_t i=0; i<MAX_GROUPS; i++) {
-            if (groups == 0 || (groups & groupMaskForIndex(i))) {
-                count += conn[i].size();
-            }
-        }
-        return count;
+    uint16_t countEmittableIntersections(uint8_t groups) const {
+        return static_cast<uint16_t>(emitterIndex(groups).intersections.size());
+    }
+    Connection* getConnection(uint16_t i, uint8_t groups) const {
+        const EmitterIndex& index = emitterIndex(groups);
+        return i < index.connections.size() ? index.connections[i] : nullptr;
     }
+    uint16_t countConnections(uint8_t groups) const {
+        return static_cast<uint16_t>(emitterIndex(groups).connections.size());
+    }
+    void invalidateEmitters();
     
     virtual bool isMirrorSupported() { return false; }
     virtual uint16_t* getMirroredPixels(uint16_t pixel, Owner* mirrorFlipEmitter, bool mirrorRotate) = 0;
@@ -236,6 +242,16 @@ class TopologyObject {
     void resetPortRegistry();
 
   private:
+    // Emittable intersections and connections of one group mask, in group
+    // index then insertion order.
+    struct EmitterIndex {
+        bool valid = false;
+        std::vector<Intersection*> intersections;
+        std::vector<Connection*> connections;
+    };
+    static constexpr uint8_t kAllGroupsMask = static_cast<uint8_t>((1u << MAX_GROUPS) - 1);
+
+    const EmitterIndex& emitterIndex(uint8_t groups) const;
     void removePortFromModels(const Port* port);
     void trimTrailingEmptyPortSlots(Intersection* intersection, uint8_t minPorts = 2);
     uint16_t allocatePortId() const;
@@ -245,6 +261,8 @@ class TopologyObject {
     std::vector<std::unique_ptr<Port>> ownedExternalPorts_;
     std::unordered_map<uint16_t, Port*> portRegistry_;
     mutable uint16_t nextPortId_ = 0;
+    uint16_t nextIntersectionId_ = 0;
+    mutable std::array<EmitterIndex, kAllGroupsMask + 1> emitterIndex_;
     LightgraphRuntimeContext runtimeContext_;
 
     friend class Port;
@@ -9,17 +9,17 @@
 struct TopologySummaryPort {
     bool present = false;
     bool isExternal = false;
-    uint8_t id = 0;
+    uint16_t id = 0;
     bool direction = false;
     uint8_t group = 0;
     std::array<uint8_t, 6> device = {0, 0, 0, 0, 0, 0};
-    uint8_t targetId = 0;
-    int16_t targetIntersectionId = TOPOLOGY_TARGET_INTERSECTION_UNSET;
+    uint16_t targetId = 0;
+    int32_t targetIntersectionId = TOPOLOGY_TARGET_INTERSECTION_UNSET;
     bool hasTargetId = false;
 };
 
 struct TopologySummaryIntersection {
-    uint8_t id = 0;
+    uint16_t id = 0;
     uint8_t group = 0;
     uint8_t numPorts = 0;
     uint16_t topPixel = 0;
@@ -36,13 +36,13 @@ struct TopologySummaryConnection {
     uint16_t numLeds = 0;
     bool pixelDir = false;
     bool hasFromIntersectionId = false;
-    uint8_t fromIntersectionId = 0;
+    uint16_t fromIntersectionId = 0;
     bool hasToIntersectionId = false;
-    uint8_t toIntersectionId = 0;
+    uint16_t toIntersectionId = 0;
     bool hasFromPortId = false;
-    uint8_t fromPortId = 0;
+    uint16_t fromPortId = 0;
     bool hasToPortId = false;
-    uint8_t toPortId = 0;
+    uint16_t toPortId = 0;
 };
 
 struct TopologySummaryModel {
@@ -54,7 +54,7 @@ struct TopologySummaryModel {
 };
 
 struct TopologySummary {
-    uint8_t schemaVersion = 3;
+    uint8_t schemaVersion = TOPOLOGY_SCHEMA_VERSION;
     uint16_t pixelCount = 0;
     uint16_t realPixelCount = 0;
     uint16_t modelCount = 0;
@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "lightgraph/internal/Globals.h"
+#include "lightgraph/internal/objects.hpp"
+#include "lightgraph/internal/rendering.hpp"
+#include "lightgraph/internal/runtime.hpp"
+
+// Counts every heap allocation in the process so emit paths can be checked
+// for zero allocations. This replaces the global allocator, so it lives in
+// its own test binary (built without -Werror=mismatched-new-delete).
+std::atomic<uint64_t> gHeapAllocations{0};
+
+void* operator new(std::size_t size) {
+    gHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    gHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+int fail(const std::string& message) {
+    std::cerr << "FAIL: " << message << std::endl;
+    return 1;
+}
+
+}  // namespace
+
+int main() {
+    // Preset palettes are shared, not copied: once warm, emitting with one
+    // allocates nothing.
+    {
+        gMillis = 0;
+        Line line(LINE_PIXEL_COUNT);
+        State state(line);
+        state.lightLists[0]->visible = false;
+
+        // Params are built up front; the check covers the palette lookup and
+        // the emit itself.
+        std::vector<EmitParams> notes;
+        for (uint16_t note = 1; note <= 3; note++) {
+            notes.emplace_back(0, 1.0f);
+            notes.back().setLength(12);
+            notes.back().noteId = note;
+        }
+        const auto emitPreset = [&](uint16_t noteId, uint8_t preset) {
+            EmitParams& params = notes[noteId - 1];
+            params.palette = getPalette(preset);
+            return state.emit(params) >= 0;
+        };
+        for (int round = 0; round < 4; round++) {
+            for (uint16_t note = 1; note <= 3; note++) {
+                if (!emitPreset(note, static_cast<uint8_t>(note))) {
+                    return fail("Preset palette warm-up emit failed");
+                }
+            }
+            gMillis += 16;
+            state.update();
+        }
+        for (int round = 0; round < 8; round++) {
+            const uint64_t before = gHeapAllocations.load(std::memory_order_relaxed);
+            for (uint16_t note = 1; note <= 3; note++) {
+                if (!emitPreset(note, static_cast<uint8_t>(note))) {
+                    return fail("Preset palette emit failed");
+                }
+            }
+            const uint64_t allocations = gHeapAllocations.load(std::memory_order_relaxed) - before;
+            if (allocations != 0) {
+                return fail("Emitting with a preset palette should not allocate (" +
+                            std::to_string(allocations) + " allocations for 3 emits)");
+            }
+            gMillis += 16;
+            state.update();
+        }
+    }
+
+    return 0;
+}
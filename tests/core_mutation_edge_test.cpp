@@ -24,14 +24,14 @@ int fail(const std::string& message) {
 
 struct ExternalSendRecord {
     std::array<uint8_t, 6> mac = {0};
-    uint8_t targetPortId = 0;
+    uint16_t targetPortId = 0;
     bool sendList = false;
 };
 
 std::vector<ExternalSendRecord> gExternalSendRecords;
 bool gExternalSendShouldSucceed = true;
 
-bool sendLightViaESPNowTestHook(const uint8_t* mac, uint8_t targetPortId,
+bool sendLightViaESPNowTestHook(const uint8_t* mac, uint16_t targetPortId,
                                 RuntimeLight* const /*light*/, bool sendList) {
     ExternalSendRecord record;
     if (mac != nullptr) {
@@ -122,6 +122,18 @@ bool hasAvailablePort(const TopologyObject& object, const Intersection* intersec
     return usedPorts < intersection->numPorts;
 }
 
+bool pixelTableMatches(const Connection& connection) {
+    const uint16_t* forward = connection.pixelTable(false);
+    const uint16_t* reverse = connection.pixelTable(true);
+    for (uint16_t i = 0; i < connection.numLeds; i++) {
+        if (forward[i] != connection.getPixel(i) ||
+            reverse[i] != connection.getPixel(connection.numLeds - 1 - i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void recalculateConnectionsLikeFirmware(TopologyObject& object) {
     std::vector<std::pair<uint8_t, size_t>> toRemove;
 
@@ -359,6 +371,75 @@ int main() {
         }
     }
 
+    // Emitter lookups should count past 255 and follow every emitter mutation.
+    {
+        MinimalObject emitterObject;
+        std::vector<Intersection*> created;
+        for (uint16_t i = 0; i < 300; i++) {
+            created.push_back(emitterObject.addIntersection(
+                new Intersection(2, static_cast<uint16_t>(1000 + 2 * i), -1, i < 200 ? GROUP1 : GROUP2)));
+        }
+        if (emitterObject.countEmittableIntersections(0) != 300 ||
+            emitterObject.countEmittableIntersections(GROUP2) != 100 ||
+            emitterObject.countEmittableIntersections(0x80) != 0) {
+            return fail("Emitter counts should cover every selected group past 255 intersections");
+        }
+        if (emitterObject.getEmittableIntersection(299, 0) != created[299] ||
+            emitterObject.getEmittableIntersection(0, GROUP2) != created[200] ||
+            emitterObject.getEmittableIntersection(300, 0) != nullptr) {
+            return fail("Emitter lookups should index intersections in group order");
+        }
+
+        TopologyIntersectionUpdate update;
+        update.numPorts = 2;
+        update.topPixel = created[200]->topPixel;
+        update.group = GROUP2;
+        update.allowEmit = false;
+        if (!emitterObject.updateIntersection(created[200], update) ||
+            emitterObject.countEmittableIntersections(GROUP2) != 99 ||
+            emitterObject.getEmittableIntersection(0, GROUP2) != created[201]) {
+            return fail("updateIntersection should drop intersections that no longer emit");
+        }
+        if (!emitterObject.removeIntersection(created[0]) ||
+            emitterObject.countEmittableIntersections(0) != 298 ||
+            emitterObject.getEmittableIntersection(0, GROUP1) != created[1]) {
+            return fail("removeIntersection should drop removed emitters");
+        }
+        if (emitterObject.addConnection(new Connection(created[1], created[2], GROUP1, 1)) == nullptr ||
+            emitterObject.countConnections(GROUP1) != 1 || emitterObject.countConnections(GROUP2) != 0) {
+            return fail("addConnection should publish new connection emitters");
+        }
+    }
+
+    // Connection pixel tables should be rebuilt whenever a layout change re-lays the connection.
+    {
+        MinimalObject tableObject;
+        Intersection* left = tableObject.addIntersection(new Intersection(2, 400, -1, GROUP1));
+        Intersection* right = tableObject.addIntersection(new Intersection(2, 420, -1, GROUP1));
+        Connection* before = tableObject.addConnection(new Connection(left, right, GROUP1, 19));
+        if (before == nullptr || !pixelTableMatches(*before) || before->pixelTable(false)[0] != 401 ||
+            before->pixelTable(true)[0] != 419) {
+            return fail("Connection pixel tables should map logical LEDs in both directions");
+        }
+
+        TopologyIntersectionUpdate update;
+        update.numPorts = 2;
+        update.topPixel = 440;
+        update.bottomPixel = -1;
+        update.group = GROUP1;
+        if (!tableObject.updateIntersection(right, update)) {
+            return fail("updateIntersection should succeed for pixel table fixture");
+        }
+        if (tableObject.countConnections(GROUP1) != 1) {
+            return fail("updateIntersection should re-lay the moved connection");
+        }
+        Connection* after = tableObject.getConnection(0, GROUP1);
+        if (after == nullptr || after->numLeds != 39 || !pixelTableMatches(*after) ||
+            after->pixelTable(true)[0] != 439) {
+            return fail("Connection pixel tables should follow recalculated layouts");
+        }
+    }
+
     if (object.removeConnection(nullptr)) {
         return fail("removeConnection(nullptr) should return false");
     }
@@ -635,20 +716,57 @@ int main() {
         }
     }
 
-    // Unsupported v3 exports should fail explicitly instead of returning an invalid snapshot.
+    // Schema 4 snapshots should carry 16-bit intersection and port ids through export and import.
     {
-        MinimalObject overflowObject;
-        Intersection* overflowA = overflowObject.addIntersection(new Intersection(2, 1, -1, GROUP1));
-        Intersection* overflowB = overflowObject.addIntersection(new Intersection(2, 7, -1, GROUP1));
-        Connection* overflowConnection = overflowObject.addConnection(new Connection(overflowA, overflowB, GROUP1, 5));
-        if (overflowConnection == nullptr || overflowConnection->fromPort == nullptr) {
-            return fail("Failed to create overflow export fixture");
+        MinimalObject wideObject;
+        Intersection* wideA = wideObject.addIntersection(new Intersection(2, 1, -1, GROUP1));
+        Intersection* wideB = wideObject.addIntersection(new Intersection(2, 7, -1, GROUP1));
+        Connection* wideConnection = wideObject.addConnection(new Connection(wideA, wideB, GROUP1, 5));
+        if (wideConnection == nullptr || wideConnection->fromPort == nullptr) {
+            return fail("Failed to create wide-id export fixture");
+        }
+        wideA->id = 300;
+        wideB->id = 40000;
+        wideConnection->fromPort->id = 256;
+
+        TopologySnapshot wideSnapshot;
+        if (!wideObject.exportSnapshot(wideSnapshot) || wideSnapshot.schemaVersion != TOPOLOGY_SCHEMA_VERSION ||
+            wideSnapshot.connections.size() != 1 || wideSnapshot.connections[0].fromIntersectionId != 300 ||
+            wideSnapshot.connections[0].toIntersectionId != 40000) {
+            return fail("exportSnapshot should keep intersection ids past 255");
+        }
+        const bool exportedWidePort = std::any_of(
+            wideSnapshot.ports.begin(), wideSnapshot.ports.end(),
+            [](const TopologyPortSnapshot& port) { return port.id == 256 && port.intersectionId == 300; });
+        if (!exportedWidePort) {
+            return fail("exportSnapshot should keep port ids past 255");
+        }
+
+        MinimalObject importedWideObject;
+        if (!importedWideObject.importSnapshot(wideSnapshot)) {
+            return fail("importSnapshot should accept 16-bit ids");
+        }
+        Intersection* importedWideB = importedWideObject.findIntersectionById(40000);
+        Port* importedWidePort = importedWideObject.findPortById(256);
+        if (importedWideB == nullptr || importedWidePort == nullptr ||
+            importedWidePort->intersection != importedWideObject.findIntersectionById(300)) {
+            return fail("importSnapshot should restore 16-bit intersection and port ids");
+        }
+
+        Intersection* addedAfterImport =
+            importedWideObject.addIntersection(new Intersection(2, 12, -1, GROUP1));
+        if (addedAfterImport == nullptr || addedAfterImport->id != 40001) {
+            return fail("Intersections added after import should continue after the imported ids");
+        }
+
+        wideSnapshot.schemaVersion = TOPOLOGY_SCHEMA_VERSION + 1;
+        if (importedWideObject.importSnapshot(wideSnapshot)) {
+            return fail("importSnapshot should reject unknown schema versions");
         }
-        overflowConnection->fromPort->id = 256;
 
-        TopologySnapshot overflowSnapshot;
-        if (overflowObject.exportSnapshot(overflowSnapshot)) {
-            return fail("exportSnapshot should fail when topology exceeds v3 port-id limits");
+        wideConnection->fromPort->id = Port::INVALID_ID;
+        if (wideObject.exportSnapshot(wideSnapshot)) {
+            return fail("exportSnapshot should fail for unregistered port ids");
         }
     }
 
@@ -718,15 +836,15 @@ int main() {
             return fail("Pre-forward fixture did not create expected lights");
         }
 
-        firstLight->owner = preForwardIntersection;
-        firstLight->position = 0.25f;
-        firstLight->setOutPort(&preForwardPort, static_cast<int8_t>(preForwardIntersection->id));
+        firstLight->setOwner(preForwardIntersection);
+        firstLight->setPosition(0.25f);
+        firstLight->setOutPort(&preForwardPort);
 
         preForwardIntersection->update(firstLight);
-        if (firstLight->pixel1 != static_cast<int16_t>(preForwardIntersection->topPixel)) {
+        if (firstLight->pixel1() != static_cast<int16_t>(preForwardIntersection->topPixel)) {
             return fail("Lead light should still render on outgoing intersection pixel");
         }
-        if (firstLight->isExpired || secondLight->isExpired) {
+        if (firstLight->isExpired() || secondLight->isExpired()) {
             return fail("Pre-forward batch trigger should not expire local sequential lights");
         }
         if (gExternalSendRecords.size() != 1 || !gExternalSendRecords[0].sendList) {
@@ -743,13 +861,13 @@ int main() {
                 "Early sequential batch trigger should dedupe repeated intersection renders");
         }
 
-        firstLight->owner = preForwardIntersection;
-        firstLight->position = 1.0f;
+        firstLight->setOwner(preForwardIntersection);
+        firstLight->setPosition(1.0f);
         preForwardIntersection->update(firstLight);
         if (gExternalSendRecords.size() != 1) {
             return fail("Port send-out after pre-forward should not emit duplicate batch sends");
         }
-        if (!firstLight->isExpired || secondLight->isExpired) {
+        if (!firstLight->isExpired() || secondLight->isExpired()) {
             return fail("Lights should still expire one-by-one when they reach the external port");
         }
     }
@@ -780,7 +898,7 @@ int main() {
         }
 
         forwardingPort.sendOut(firstLight, true);
-        if (!firstLight->isExpired || secondLight->isExpired) {
+        if (!firstLight->isExpired() || secondLight->isExpired()) {
             return fail("External forwarding should only expire the light that reached the port");
         }
         if (gExternalSendRecords.size() != 1 || !gExternalSendRecords[0].sendList) {
@@ -789,12 +907,12 @@ int main() {
 
         sequentialList.update();
         RuntimeLight* relinkedSecondLight = sequentialList[1];
-        if (relinkedSecondLight == nullptr || relinkedSecondLight->idx != 0) {
+        if (relinkedSecondLight == nullptr || relinkedSecondLight->idx() != 0) {
             return fail("Expected surviving light to reindex to idx=0 after first light expiry");
         }
 
         forwardingPort.sendOut(relinkedSecondLight, true);
-        if (!relinkedSecondLight->isExpired) {
+        if (!relinkedSecondLight->isExpired()) {
             return fail("Second light should expire when it reaches external forwarding port");
         }
         if (gExternalSendRecords.size() != 1) {
@@ -830,7 +948,7 @@ int main() {
 
         nonSequentialPort.sendOut(firstLight, true);
         nonSequentialPort.sendOut(secondLight, true);
-        if (!firstLight->isExpired || !secondLight->isExpired) {
+        if (!firstLight->isExpired() || !secondLight->isExpired()) {
             return fail(
                 "Non-sequential forwarding should expire each light as it reaches external port");
         }
@@ -863,21 +981,21 @@ int main() {
         if (light == nullptr) {
             return fail("Failed forwarding fixture did not create expected light");
         }
-        light->setOutPort(&failurePort, static_cast<int8_t>(failureIntersection->id));
-        light->owner = nullptr;
+        light->setOutPort(&failurePort);
+        light->setOwner(nullptr);
 
         failurePort.sendOut(light, false);
         if (gExternalSendRecords.size() != 1) {
             return fail("Failed forwarding path should still attempt one transport send");
         }
-        if (light->isExpired) {
+        if (light->isExpired()) {
             return fail("Failed external forwarding should not expire local light");
         }
-        if (light->owner != failureIntersection) {
+        if (light->owner() != failureIntersection) {
             return fail(
                 "Failed external forwarding should reattach light to local intersection owner");
         }
-        if (light->outPort != nullptr) {
+        if (light->outPort() != nullptr) {
             return fail("Failed external forwarding should clear out-port for rerouting");
         }
     }
@@ -950,7 +1068,7 @@ int main() {
             delete materialized;
             return fail("remote ingress helper should not enable template-only ingress compensation");
         }
-        if ((*materialized)[0] == nullptr || std::abs((*materialized)[0]->position) > 0.0001f) {
+        if ((*materialized)[0] == nullptr || std::abs((*materialized)[0]->position()) > 0.0001f) {
             delete materialized;
             return fail("remote ingress helper should not seed normalized emit-intent lists forward by one pixel");
         }
@@ -982,8 +1100,8 @@ int main() {
             delete materialized;
             return fail("remote template replay regression fixture should create the first light");
         }
-        templateLight->owner = ingressEmitter;
-        templateLight->lifeMillis = 17;
+        templateLight->setOwner(ingressEmitter);
+        templateLight->setLifeMillis(17);
 
         if (!lightgraph::integration::remote_ingress::activateTemplateReplayList(
                 ingressState, *ingressEmitter, templateReplay, 0)) {
@@ -1001,12 +1119,12 @@ int main() {
             delete materialized;
             return fail("remote template replay helper should enable hidden-ingress continuity compensation");
         }
-        if (templateLight->owner != nullptr || templateLight->lifeMillis != templateReplay->lifeMillis) {
+        if (templateLight->owner() != nullptr || templateLight->lifeMillis() != templateReplay->lifeMillis) {
             delete templateReplay;
             delete materialized;
             return fail("remote template replay helper should normalize light ownership and life timing");
         }
-        if (std::abs(templateLight->position - 1.0f) > 0.0001f) {
+        if (std::abs(templateLight->position() - 1.0f) > 0.0001f) {
             delete templateReplay;
             delete materialized;
             return fail("remote template replay helper should seed the first light one pixel forward");
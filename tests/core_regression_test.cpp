@@ -1,14 +1,17 @@
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <lightgraph/engine.hpp>
 #include <lightgraph/integration/factory.hpp>
 
 #include "lightgraph/internal/Globals.h"
+#include "lightgraph/internal/core/ColorSpace.h"
 #include "lightgraph/internal/core/Limits.h"
 #include "lightgraph/internal/core/Types.h"
 #include "lightgraph/internal/objects.hpp"
@@ -26,7 +29,7 @@ class TestOwner : public Owner {
     uint8_t getType() override { return TYPE_CONNECTION; }
     void emit(RuntimeLight* const light) const override {
         if (light != nullptr) {
-            light->owner = this;
+            light->setOwner(this);
         }
     }
     void update(RuntimeLight* const /*light*/) const override {}
@@ -147,7 +150,7 @@ std::vector<float> captureLightPositions(const LightList& list) {
     positions.reserve(list.numLights);
     for (uint16_t i = 0; i < list.numLights; i++) {
         RuntimeLight* const light = list[i];
-        positions.push_back(light != nullptr ? light->position : 0.0f);
+        positions.push_back(light != nullptr ? light->position() : 0.0f);
     }
     return positions;
 }
@@ -287,6 +290,50 @@ int main() {
         }
     }
 
+    // ColorRGB packs into three bytes.
+    {
+        if (sizeof(ColorRGB) != 3 || alignof(ColorRGB) != 1 || !std::is_trivially_copyable<ColorRGB>::value) {
+            return fail("ColorRGB should be a trivially copyable 3-byte color");
+        }
+        // Light keeps its speed and color in the list's LightStore, not in the view.
+        if (sizeof(Light) != sizeof(RuntimeLight)) {
+            return fail("Light should be a view the size of RuntimeLight");
+        }
+        LightList list;
+        list.lightStore().reserve(2);
+        Light light(&list, 1, 2.0f, 100, 0, 200);
+        light.setPosition(3.5f);
+        light.setColor(ColorRGB(1, 2, 3));
+        const LightStore& store = list.lightStore();
+        if (store.position[1] != 3.5f || store.speed[1] != 2.0f || store.lifeMillis[1] != 100 ||
+            store.maxBri[1] != 200 || store.color[1].B != 3 || light.getSpeed() != 2.0f) {
+            return fail("Light should read and write its fields through its list's LightStore slot");
+        }
+        std::vector<ColorRGB> colors(4);
+        if (reinterpret_cast<const uint8_t*>(&colors[3]) - reinterpret_cast<const uint8_t*>(&colors[0]) != 9) {
+            return fail("ColorRGB arrays should be tightly packed");
+        }
+    }
+
+    // ofxColorTheory runs on ColorTheoryRGB; conversions keep the channels and HSB math.
+    {
+        ColorTheoryRGB adapted(ColorRGB(0x102030));
+        if (adapted.r != 0x10 || adapted.g != 0x20 || adapted.b != 0x30 || adapted.toRGB().get() != 0x102030) {
+            return fail("ColorTheoryRGB should carry ColorRGB's channels");
+        }
+        adapted.setHsb(170.0f, 200.0f, 180.0f);
+        if (adapted.toRGB().get() != ColorRGB::fromHsb(170.0f, 200.0f, 180.0f).get()) {
+            return fail("ColorTheoryRGB::setHsb should match ColorRGB::setHsb");
+        }
+
+        Palette rgbRamp({0xFF0000, 0x0000FF});
+        rgbRamp.setInterpolationMode(0);
+        const std::vector<ColorRGB> ramp = rgbRamp.interpolate(5);
+        if (ramp.size() != 5 || ramp.front().get() != 0xFF0000 || ramp.back().get() != 0x0000FF) {
+            return fail("RGB palette interpolation through ofxColorTheory should keep its end stops");
+        }
+    }
+
     // Compatibility aliases should keep the old and new dim/interpolation APIs equivalent.
     {
         const ColorRGB original(0x804020);
@@ -418,11 +465,12 @@ int main() {
     {
         LightList list;
         list.speed = 1.0f;
+        list.lightStore().reserve(2);
 
-        Light lightA(&list, list.speed, INFINITE_DURATION, 0, 255);
-        Light lightB(&list, list.speed, INFINITE_DURATION, 0, 255);
-        lightA.position = 0.0f;
-        lightB.position = 0.0f;
+        Light lightA(&list, 0, list.speed, INFINITE_DURATION, 0, 255);
+        Light lightB(&list, 1, list.speed, INFINITE_DURATION, 0, 255);
+        lightA.setPosition(0.0f);
+        lightB.setPosition(0.0f);
 
         gMillis = 0;
         lightgraphResetFrameTiming();
@@ -443,14 +491,14 @@ int main() {
         }
 
 #if LIGHTGRAPH_FPS_INDEPENDENT_SPEED
-        if (std::fabs(lightA.position - lightB.position) > 0.001f) {
+        if (std::fabs(lightA.position() - lightB.position()) > 0.001f) {
             return fail("Light motion should be FPS independent for equal elapsed time");
         }
-        if (std::fabs(lightA.position - 10.0f) > 0.001f) {
+        if (std::fabs(lightA.position() - 10.0f) > 0.001f) {
             return fail("Light motion should preserve legacy speed at the reference frame rate");
         }
 #else
-        if (!(lightA.position > lightB.position + 0.001f)) {
+        if (!(lightA.position() > lightB.position() + 0.001f)) {
             return fail("Legacy frame-driven motion should depend on update count");
         }
 #endif
@@ -481,19 +529,21 @@ int main() {
     {
         LightList fadeListA;
         fadeListA.setFade(5, 0, EASE_NONE);
-        Light fadeLightA(&fadeListA, 0.0f, INFINITE_DURATION, 0, 255);
-        fadeLightA.bri = 0;
+        fadeListA.lightStore().reserve(1);
+        Light fadeLightA(&fadeListA, 0, 0.0f, INFINITE_DURATION, 0, 255);
+        fadeLightA.setBri(0);
 
         LightList fadeListB;
         fadeListB.setFade(5, 0, EASE_NONE);
-        Light fadeLightB(&fadeListB, 0.0f, INFINITE_DURATION, 0, 255);
-        fadeLightB.bri = 0;
+        fadeListB.lightStore().reserve(1);
+        Light fadeLightB(&fadeListB, 0, 0.0f, INFINITE_DURATION, 0, 255);
+        fadeLightB.setBri(0);
 
         advanceLightCadence(fadeLightA, {16, 16, 16, 16, 16, 16, 16, 16, 16, 16});
         advanceLightCadence(fadeLightB, {32, 32, 32, 32, 32});
 
 #if LIGHTGRAPH_FPS_INDEPENDENT_SPEED
-        if (fadeLightA.bri != fadeLightB.bri || fadeLightA.brightness != fadeLightB.brightness) {
+        if (fadeLightA.bri() != fadeLightB.bri() || fadeLightA.brightness() != fadeLightB.brightness()) {
             return fail("Fade progression should preserve brightness across equivalent elapsed time");
         }
 #endif
@@ -729,6 +779,46 @@ int main() {
         }
     }
 
+    // BgLight color table: lookups match wrapColors + dim for every wrap mode and
+    // segmentation, and a brightness changed behind setup's back still renders.
+    {
+        BgLight bg;
+        bg.setup(100, 180);
+        bg.position = 7.5f;
+        for (const int8_t wrapMode : {WRAP_NOWRAP, WRAP_CLAMP_TO_EDGE, WRAP_REPEAT, WRAP_REPEAT_MIRROR}) {
+            for (const float segmentation : {0.0f, 2.5f}) {
+                Palette palette({0xFF0000, 0x00FF00, 0x0000FF}, {0.0f, 0.5f, 1.0f});
+                palette.setWrapMode(wrapMode);
+                palette.setSegmentation(segmentation);
+                bg.setPalette(palette);
+                for (int16_t p = 0; p < 100; p++) {
+                    const uint32_t index = uint32_t(bg.position + p) % bg.length;
+                    const ColorRGB expected =
+                        Palette::wrapColors(index, bg.length, bg.colors, wrapMode, segmentation).dim(180);
+                    const ColorRGB actual = bg.getColor(p);
+                    if (actual.R != expected.R || actual.G != expected.G || actual.B != expected.B) {
+                        return fail("BgLight color table should match wrapColors for every pixel");
+                    }
+                }
+            }
+        }
+        bg.maxBri = 255;
+        const ColorRGB undimmed = bg.getColor(0);
+        const ColorRGB expected = bg.getLightColor(uint32_t(bg.position) % bg.length);
+        if (undimmed.R != expected.R || undimmed.G != expected.G || undimmed.B != expected.B) {
+            return fail("BgLight should not serve a color table baked for another brightness");
+        }
+        bg.update();
+        if (bg.colorTableBri != 255 || bg.colorTable.size() != bg.length) {
+            return fail("BgLight::update should rebake the color table after a brightness change");
+        }
+        const ColorRGB rebaked = bg.getColor(0);
+        const ColorRGB rebakedExpected = bg.getLightColor(uint32_t(bg.position) % bg.length);
+        if (rebaked.R != rebakedExpected.R || rebaked.G != rebakedExpected.G || rebaked.B != rebakedExpected.B) {
+            return fail("BgLight rebaked color table should match the new brightness");
+        }
+    }
+
     // Blend-mode regressions: deterministic 1-pixel compositing across all modes.
     {
         struct BlendExpectation {
@@ -766,6 +856,31 @@ int main() {
             }
         }
 
+        // The fixed-point pipeline must stay within one 8-bit step of the float path
+        // for every composite mode, base average and incoming channel value.
+        for (int modeValue = BLEND_MULTIPLY; modeValue <= BLEND_PIN_LIGHT; modeValue++) {
+            const BlendMode mode = static_cast<BlendMode>(modeValue);
+            if (!blend::isCompositeMode(mode)) {
+                continue;
+            }
+            for (uint8_t div = 1; div <= 3; div++) {
+                for (uint16_t accumulated = 0; accumulated <= 255u * div; accumulated++) {
+                    const float base = (accumulated / static_cast<float>(div)) / 255.0f;
+                    const int32_t fixedBase = blend::toFixedAverage(accumulated, div);
+                    for (int top = 0; top <= 255; top++) {
+                        const uint16_t floatValue = static_cast<uint16_t>(
+                            blend::blendFloat(mode, base, top / 255.0f) * 255.0f * div);
+                        const uint16_t fixedValue = blend::toAccumulator(
+                            blend::blendFixed(mode, fixedBase, blend::toFixed(static_cast<uint8_t>(top))), div);
+                        if (std::abs(floatValue / div - fixedValue / div) > 1) {
+                            return fail("Fixed-point blend mode " + std::to_string(modeValue) +
+                                        " drifted from the float path");
+                        }
+                    }
+                }
+            }
+        }
+
         const ColorRGB replaceOnly = sampleReplaceOnlyResult();
         if (!isApproxColor(replaceOnly, 200, 50, 0, 2)) {
             return fail("BLEND_REPLACE should set color on first write without prior contributors");
@@ -779,15 +894,16 @@ int main() {
         list.minBri = 0;
         list.maxBri = 200;
         list.fadeEase = ofxeasing::linear::easeNone;
+        list.lightStore().reserve(2);
 
-        RuntimeLight runtimeLight(&list, 0, 200);
-        runtimeLight.bri = 255;
+        RuntimeLight runtimeLight(&list, 0, 0, 200);
+        runtimeLight.setBri(255);
         if (runtimeLight.getBrightness() != 0) {
             return fail("RuntimeLight::getBrightness should be zero when fadeThresh is 255");
         }
 
-        Light light(&list, 1.0f, 0, 0, 200);
-        light.bri = 255;
+        Light light(&list, 1, 1.0f, 0, 0, 200);
+        light.setBri(255);
         if (light.getBrightness() != 0) {
             return fail("Light::getBrightness should be zero when fadeThresh is 255");
         }
@@ -854,6 +970,342 @@ int main() {
         }
     }
 
+    // Light arena: O(1) slot reuse, bounded capacity, slot order preserved for whole-list release.
+    {
+        LightArena arena(4);
+        void* slots[4] = {nullptr, nullptr, nullptr, nullptr};
+        for (int i = 0; i < 4; i++) {
+            slots[i] = arena.acquire();
+            if (slots[i] == nullptr || !arena.owns(slots[i])) {
+                return fail("LightArena should hand out every slot up to its capacity");
+            }
+        }
+        if (arena.acquire() != nullptr || arena.available() != 0) {
+            return fail("LightArena should refuse to grow past its capacity");
+        }
+        for (int i = 3; i >= 0; i--) {
+            arena.release(slots[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            if (arena.acquire() != slots[i]) {
+                return fail("LightArena should return released slots in their original order");
+            }
+        }
+        if (arena.heapAllocations() != 2) {
+            return fail("LightArena should reserve its storage once");
+        }
+    }
+
+    // Light arena store runs: first fit over whole runs, released runs are reused.
+    {
+        LightArena arena(3 * LightArena::kStoreRunLights);
+        if (!arena.reserveStorage()) {
+            return fail("LightArena should reserve its storage up front");
+        }
+        void* const first = arena.acquireStore(LightArena::kStoreRunLights);
+        void* const rest = arena.acquireStore(2 * LightArena::kStoreRunLights);
+        if (first == nullptr || rest == nullptr || !arena.ownsStore(first) || !arena.ownsStore(rest)) {
+            return fail("LightArena should hand out store runs up to its capacity");
+        }
+        if (arena.acquireStore(1) != nullptr) {
+            return fail("LightArena should refuse store runs past its capacity");
+        }
+        arena.releaseStore(first, LightArena::kStoreRunLights);
+        if (arena.acquireStore(2 * LightArena::kStoreRunLights) != nullptr) {
+            return fail("LightArena store runs should be contiguous");
+        }
+        if (arena.acquireStore(LightArena::kStoreRunLights - 1) != first) {
+            return fail("LightArena should reuse a released store run");
+        }
+        LightStore store;
+        store.assign(rest, 2 * LightArena::kStoreRunLights);
+        store.initSlot(2 * LightArena::kStoreRunLights - 1, 0, 200);
+        if (store.ownsBlock() || store.maxBri[2 * LightArena::kStoreRunLights - 1] != 200) {
+            return fail("LightStore should lay out an arena run without owning it");
+        }
+        if (arena.heapAllocations() != 2) {
+            return fail("LightArena store runs should come from its single reservation");
+        }
+    }
+
+    // Steady-state emission: repeated notes and expiring lists must recycle without heap traffic.
+    {
+        gMillis = 0;
+        Line line(LINE_PIXEL_COUNT);
+        State state(line);
+        state.lightLists[0]->visible = false;
+
+        const auto emitNote = [&](uint16_t noteId, uint16_t length) {
+            EmitParams params(0, 1.0f, 0x3366FF);
+            params.setLength(length);
+            params.noteId = noteId;
+            return state.emit(params) >= 0;
+        };
+        const auto runCycle = [&]() {
+            for (uint16_t note = 1; note <= 3; note++) {
+                if (!emitNote(note, static_cast<uint16_t>(8 + note))) {
+                    return false;
+                }
+            }
+            for (int i = 0; i < 4; i++) {
+                gMillis += 16;
+                state.update();
+            }
+            // Same notes again: every list is replaced in place.
+            for (uint16_t note = 1; note <= 3; note++) {
+                if (!emitNote(note, static_cast<uint16_t>(8 + note))) {
+                    return false;
+                }
+            }
+            state.stopAll();
+            for (int i = 0; i < (LINE_PIXEL_COUNT + 64); i++) {
+                gMillis += 16;
+                state.update();
+            }
+            return state.totalLights == 0;
+        };
+
+        if (!runCycle()) {
+            return fail("Arena warm-up cycle failed to emit or drain");
+        }
+        const uint32_t warmAllocations = state.lightArena.heapAllocations();
+        if (warmAllocations == 0) {
+            return fail("Arena allocation counter should record the warm-up allocations");
+        }
+        for (int cycle = 0; cycle < 5; cycle++) {
+            if (!runCycle()) {
+                return fail("Arena steady-state cycle failed to emit or drain");
+            }
+        }
+        if (state.lightArena.heapAllocations() != warmAllocations) {
+            return fail("Steady-state emission should not allocate light storage (" +
+                        std::to_string(warmAllocations) + " -> " +
+                        std::to_string(state.lightArena.heapAllocations()) + ")");
+        }
+        if (state.lightArena.available() != state.lightArena.capacity()) {
+            return fail("Drained lists should return every light to the arena");
+        }
+        if (state.lightListPool.idle() == 0) {
+            return fail("Drained lists should be retained by the list pool");
+        }
+    }
+
+    // A scene held at MAX_TOTAL_LIGHTS: re-emitting a note builds its replacement
+    // before the old list is released, and that must still come from the arena.
+    {
+        gMillis = 0;
+        Line line(LINE_PIXEL_COUNT);
+        State state(line);
+        state.lightLists[0]->visible = false;
+
+        constexpr uint16_t kNotes = 5;
+        const uint16_t length = static_cast<uint16_t>(MAX_TOTAL_LIGHTS / kNotes);
+        const auto emitNote = [&](uint16_t noteId) {
+            EmitParams params(0, 0.0f, 0x3366FF);
+            params.setLength(length);
+            params.duration = INFINITE_DURATION;
+            params.noteId = noteId;
+            return state.emit(params) >= 0;
+        };
+        const auto runRound = [&]() {
+            for (uint16_t note = 1; note <= kNotes; note++) {
+                if (!emitNote(note)) {
+                    return false;
+                }
+                gMillis += 16;
+                state.update();
+            }
+            return true;
+        };
+
+        if (!runRound()) {
+            return fail("At-cap scene failed to emit");
+        }
+        if (state.totalLights != MAX_TOTAL_LIGHTS) {
+            return fail("At-cap scene should hold MAX_TOTAL_LIGHTS lights (" +
+                        std::to_string(state.totalLights) + ")");
+        }
+        if (!runRound()) {
+            return fail("At-cap warm-up re-emit failed");
+        }
+        const uint32_t warmAllocations = state.lightArena.heapAllocations();
+        for (int round = 0; round < 4; round++) {
+            if (!runRound()) {
+                return fail("At-cap re-emit failed");
+            }
+        }
+        if (state.totalLights != MAX_TOTAL_LIGHTS) {
+            return fail("At-cap re-emits should keep the scene at MAX_TOTAL_LIGHTS");
+        }
+        for (uint8_t i = 1; i < MAX_LIGHT_LISTS; i++) {
+            if (state.lightLists[i] != nullptr &&
+                !state.lightArena.ownsStore(state.lightLists[i]->lightStore().block())) {
+                return fail("Pooled lists should keep their store in the arena");
+            }
+        }
+        if (state.lightArena.heapAllocations() != warmAllocations) {
+            return fail("Re-emitting at MAX_TOTAL_LIGHTS should not allocate light storage (" +
+                        std::to_string(warmAllocations) + " -> " +
+                        std::to_string(state.lightArena.heapAllocations()) + ")");
+        }
+    }
+
+    // PaletteCache: repeated lookups hit, matches Palette::interpolate, evicts the
+    // least recently used table and lets random palettes through.
+    {
+        PaletteCache cache(2);
+        const Palette sunset = getPalette(0);
+        const Palette ocean = getPalette(2);
+        std::vector<ColorRGB> colors;
+
+        cache.interpolate(sunset, 12, colors);
+        cache.interpolate(sunset, 12, colors);
+        if (cache.hits() != 1 || cache.misses() != 1) {
+            return fail("PaletteCache should miss once and then hit for the same palette and count");
+        }
+        const std::vector<ColorRGB> expected = sunset.interpolate(12);
+        if (colors.size() != expected.size()) {
+            return fail("PaletteCache table size should match Palette::interpolate");
+        }
+        for (size_t i = 0; i < colors.size(); i++) {
+            if (colors[i].get() != expected[i].get()) {
+                return fail("PaletteCache table should match Palette::interpolate");
+            }
+        }
+
+        // An equal palette built separately shares the entry; another count does not.
+        Palette rebuilt(sunset.getColors(), sunset.getPositions());
+        cache.interpolate(rebuilt, 12, colors);
+        cache.interpolate(sunset, 30, colors);
+        if (cache.hits() != 2 || cache.misses() != 2 || cache.size() != 2) {
+            return fail("PaletteCache should key entries by palette contents and count");
+        }
+
+        // sunset/12 is now the least recently used entry.
+        cache.interpolate(ocean, 12, colors);
+        cache.interpolate(sunset, 30, colors);
+        cache.interpolate(sunset, 12, colors);
+        if (cache.hits() != 3 || cache.misses() != 4) {
+            return fail("PaletteCache should evict the least recently used table");
+        }
+
+        Palette modeChanged = sunset;
+        modeChanged.setInterpolationMode(0);
+        cache.interpolate(modeChanged, 12, colors);
+        if (cache.misses() != 5) {
+            return fail("PaletteCache should key entries by interpolation mode");
+        }
+
+        Palette random({RANDOM_COLOR, 0xFF0000});
+        cache.resetStats();
+        cache.interpolate(random, 12, colors);
+        if (cache.hits() != 0 || cache.misses() != 0 || colors.size() != 12) {
+            return fail("PaletteCache should pass palettes with random stops straight through");
+        }
+
+        gMillis = 0;
+        Line line(LINE_PIXEL_COUNT);
+        State state(line);
+        EmitParams params(0, 1.0f);
+        params.palette = sunset;
+        params.setLength(12);
+        for (uint16_t note = 1; note <= 4; note++) {
+            params.noteId = note;
+            if (state.emit(params) < 0) {
+                return fail("PaletteCache State emit failed");
+            }
+        }
+        if (state.paletteCache.misses() != 1 || state.paletteCache.hits() != 3) {
+            return fail("State emits with the same palette and length should share one cached table");
+        }
+    }
+
+    // Color-space kernels agree with the scalar ColorRGB HSB routines and
+    // round-trip every sampled color; palettes blend HSB/LCh through them.
+    {
+        std::vector<ColorRGB> grid;
+        for (int r = 0; r <= 255; r += 15) {
+            for (int g = 0; g <= 255; g += 15) {
+                for (int b = 0; b <= 255; b += 15) {
+                    grid.emplace_back(static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b));
+                }
+            }
+        }
+        const auto sameColor = [](const ColorRGB& a, const ColorRGB& b, int tolerance) {
+            return std::abs(a.R - b.R) <= tolerance && std::abs(a.G - b.G) <= tolerance &&
+                std::abs(a.B - b.B) <= tolerance;
+        };
+
+        std::vector<colorspace::HSV> hsv(grid.size());
+        colorspace::rgbToHsv(grid.data(), hsv.data(), grid.size());
+        std::vector<ColorRGB> back(grid.size());
+        colorspace::hsvToRgb(hsv.data(), back.data(), hsv.size());
+        for (size_t i = 0; i < grid.size(); i++) {
+            const ColorRGB& color = grid[i];
+            if (color.getSaturation() > 0.0f && std::fabs(colorspace::hueDelta(hsv[i].h, color.getHueAngle())) > 0.01f) {
+                return fail("rgbToHsv hue should match ColorRGB::getHueAngle");
+            }
+            if (std::fabs(hsv[i].s * 255.0f - color.getSaturation()) > 0.01f ||
+                std::fabs(hsv[i].v * 255.0f - color.getBrightness()) > 0.01f) {
+                return fail("rgbToHsv saturation/value should match ColorRGB");
+            }
+            if (!sameColor(back[i], color, 0)) {
+                return fail("rgbToHsv/hsvToRgb should round-trip 8-bit colors");
+            }
+        }
+
+        // setHsb truncates where the kernels round, so allow one step. Hue 255
+        // (360 degrees) is left out: setHsb does not wrap it back to red.
+        for (int h = 0; h < 255; h += 5) {
+            for (int sat = 0; sat < 256; sat += 17) {
+                for (int val = 0; val < 256; val += 17) {
+                    const colorspace::HSV sample{h / 255.0f * 360.0f, sat / 255.0f, val / 255.0f};
+                    ColorRGB batch;
+                    colorspace::hsvToRgb(&sample, &batch, 1);
+                    const ColorRGB scalar = ColorRGB::fromHsb(static_cast<float>(h), static_cast<float>(sat),
+                                                              static_cast<float>(val));
+                    ColorRGB random;
+                    random.fromHSV(static_cast<uint8_t>(h), static_cast<uint8_t>(sat), static_cast<uint8_t>(val));
+                    if (!sameColor(batch, scalar, 1) || !sameColor(random, batch, 0)) {
+                        return fail("hsvToRgb and ColorRGB::fromHSV should match ColorRGB::setHsb within one step");
+                    }
+                }
+            }
+        }
+
+        std::vector<colorspace::LCh> lch(grid.size());
+        colorspace::rgbToLch(grid.data(), lch.data(), grid.size());
+        colorspace::lchToRgb(lch.data(), back.data(), lch.size());
+        for (size_t i = 0; i < grid.size(); i++) {
+            if (!sameColor(back[i], grid[i], 0)) {
+                return fail("rgbToLch/lchToRgb should round-trip 8-bit colors");
+            }
+        }
+        const ColorRGB references[] = {ColorRGB(255, 255, 255), ColorRGB(255, 0, 0), ColorRGB(0, 0, 255)};
+        colorspace::LCh expectedLch[] = {{100.0f, 0.0f, 0.0f}, {53.24f, 104.55f, 40.0f}, {32.30f, 133.81f, 306.28f}};
+        for (size_t i = 0; i < 3; i++) {
+            colorspace::LCh actual;
+            colorspace::rgbToLch(&references[i], &actual, 1);
+            if (std::fabs(actual.l - expectedLch[i].l) > 0.05f || std::fabs(actual.c - expectedLch[i].c) > 0.05f ||
+                (expectedLch[i].c > 0.0f && std::fabs(colorspace::hueDelta(actual.h, expectedLch[i].h)) > 0.05f)) {
+                return fail("rgbToLch should match CIE LCh reference values");
+            }
+        }
+
+        // Red to blue in HSB takes the short way round, through magenta.
+        Palette redBlue({0xFF0000, 0x0000FF});
+        const std::vector<ColorRGB> hsbRamp = redBlue.interpolate(3);
+        if (hsbRamp.size() != 3 || hsbRamp[0].get() != 0xFF0000 || hsbRamp[1].get() != 0xFF00FF ||
+            hsbRamp[2].get() != 0x0000FF) {
+            return fail("HSB palette interpolation should blend hue along the shorter arc");
+        }
+        redBlue.setInterpolationMode(2);
+        const std::vector<ColorRGB> lchRamp = redBlue.interpolate(9);
+        if (lchRamp.size() != 9 || lchRamp.front().get() != 0xFF0000 || lchRamp.back().get() != 0x0000FF) {
+            return fail("CIELCh palette interpolation should start and end on the palette stops");
+        }
+    }
+
     // Built-in factory regression: stable Engine and integration factory must resolve the same objects.
     {
         struct FactoryCase {
@@ -967,6 +1419,171 @@ int main() {
         }
     }
 
+    {
+        Heptagon3024 object;
+        State state(object);
+        uint32_t seed = 0x2468ACE1u;
+        auto next = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return seed >> 8;
+        };
+        for (uint16_t i = 0; i < object.pixelCount; i++) {
+            // div == 0 with non-zero values mirrors BLEND_ADD-only pixels.
+            const uint8_t div = static_cast<uint8_t>(i % 7 == 0 ? 0 : next() % 8);
+            const uint32_t range = 256u * (div == 0 ? 1u : div);
+            state.pixelDiv[i] = div;
+            state.pixelValuesR[i] = static_cast<uint16_t>(next() % 4 == 0 ? next() : next() % range);
+            state.pixelValuesG[i] = static_cast<uint16_t>(next() % 4 == 0 ? next() : next() % range);
+            state.pixelValuesB[i] = static_cast<uint16_t>(next() % 4 == 0 ? next() : next() % range);
+        }
+
+        const std::vector<pixel_resolve::Kernel> kernels = {
+            pixel_resolve::Kernel::Scalar,
+            pixel_resolve::Kernel::Sse2,
+            pixel_resolve::Kernel::Avx2,
+            pixel_resolve::Kernel::Neon,
+        };
+        pixel_resolve::Planes planes;
+        planes.r = state.pixelValuesR.data();
+        planes.g = state.pixelValuesG.data();
+        planes.b = state.pixelValuesB.data();
+        planes.div = state.pixelDiv.data();
+        // Odd count exercises the scalar tail after the vector body.
+        const uint16_t count = static_cast<uint16_t>(object.pixelCount - 5);
+        std::vector<uint8_t> frame(static_cast<size_t>(object.pixelCount) * 3u, 0);
+        const uint8_t brightnessLevels[] = {0, 1, 127, 128, 254, 255};
+        for (const uint8_t maxBrightness : brightnessLevels) {
+            if (state.resolvePixels(frame.data(), object.pixelCount, maxBrightness) != object.pixelCount) {
+                return fail("State::resolvePixels should resolve every pixel");
+            }
+            for (uint16_t i = 0; i < object.pixelCount; i++) {
+                const ColorRGB expected = state.getPixel(i, maxBrightness);
+                const uint8_t* const actual = frame.data() + static_cast<size_t>(i) * 3u;
+                if (actual[0] != expected.R || actual[1] != expected.G || actual[2] != expected.B) {
+                    return fail("State::resolvePixels should be bit-exact with State::getPixel");
+                }
+            }
+            for (const pixel_resolve::Kernel kernel : kernels) {
+                if (!pixel_resolve::isKernelAvailable(kernel)) {
+                    continue;
+                }
+                std::fill(frame.begin(), frame.end(), 0xAB);
+                pixel_resolve::resolveWith(kernel, planes, count, maxBrightness, frame.data());
+                for (uint16_t i = 0; i < count; i++) {
+                    const ColorRGB expected = state.getPixel(i, maxBrightness);
+                    const uint8_t* const actual = frame.data() + static_cast<size_t>(i) * 3u;
+                    if (actual[0] != expected.R || actual[1] != expected.G || actual[2] != expected.B) {
+                        return fail(std::string("Resolve kernel ") + pixel_resolve::kernelName(kernel) +
+                                    " should be bit-exact with State::getPixel");
+                    }
+                }
+                if (frame[static_cast<size_t>(count) * 3u] != 0xAB) {
+                    return fail("Resolve kernels should not write past the requested pixel count");
+                }
+            }
+        }
+
+        // Every (accumulator, div) pair, so the float quotient shortcut in the
+        // vector kernels is proven exact rather than sampled.
+        const uint16_t span = 65535;
+        std::vector<uint16_t> values(span);
+        std::vector<uint8_t> divs(span);
+        std::vector<uint8_t> exhaustive(static_cast<size_t>(span) * 3u);
+        for (uint16_t i = 0; i < span; i++) {
+            values[i] = i;
+        }
+        planes.r = values.data();
+        planes.g = values.data() + 1;
+        planes.b = values.data();
+        planes.div = divs.data();
+        for (const pixel_resolve::Kernel kernel : kernels) {
+            if (kernel == pixel_resolve::Kernel::Scalar || !pixel_resolve::isKernelAvailable(kernel)) {
+                continue;
+            }
+            for (uint16_t div = 1; div <= 255; div++) {
+                std::fill(divs.begin(), divs.end(), static_cast<uint8_t>(div));
+                pixel_resolve::resolveWith(kernel, planes, static_cast<uint16_t>(span - 1), 255,
+                                           exhaustive.data());
+                for (uint16_t i = 0; i < span - 1; i++) {
+                    const uint8_t* const actual = exhaustive.data() + static_cast<size_t>(i) * 3u;
+                    if (actual[0] != pixel_resolve::resolveChannel(values[i], static_cast<uint8_t>(div), 255) ||
+                        actual[1] != pixel_resolve::resolveChannel(values[i + 1], static_cast<uint8_t>(div), 255)) {
+                        return fail(std::string("Resolve kernel ") + pixel_resolve::kernelName(kernel) +
+                                    " should match integer division for every accumulator");
+                    }
+                }
+            }
+        }
+    }
+
+    // Render steps clear only the pixels touched by the previous frame.
+    {
+        Heptagon3024 object;
+        State state(object);
+        state.lightLists[0]->visible = false;
+        gMillis = 0;
+        lightgraphResetFrameTiming();
+
+        const uint32_t colors[] = {0xFF2000, 0x00FF40, 0x2040FF};
+        for (uint16_t note = 1; note <= 3; note++) {
+            EmitParams params(0, 2.0f, colors[note - 1]);
+            params.setLength(static_cast<uint16_t>(6 * note));
+            params.noteId = note;
+            if (state.emit(params) < 0) {
+                return fail("Dirty-region test failed to emit a light list");
+            }
+        }
+
+        std::vector<uint16_t> changed;
+        std::vector<uint8_t> previousFrame(static_cast<size_t>(object.pixelCount) * 3u, 0);
+        std::vector<uint8_t> currentFrame(previousFrame.size(), 0);
+        bool sawLitFrame = false;
+        for (int frame = 0; frame < 90; frame++) {
+            if (frame == 45) {
+                state.stopNote(2);
+            }
+            gMillis += 16;
+            state.update();
+            if (state.touchedPixels.size() >= object.pixelCount / 4u) {
+                return fail("Dirty-region test should stay in the sparse clear path");
+            }
+
+            std::vector<bool> touched(object.pixelCount, false);
+            for (const uint16_t pixel : state.touchedPixels) {
+                touched[pixel] = true;
+            }
+            for (uint16_t p = 0; p < object.pixelCount; p++) {
+                if (!touched[p] && (state.pixelDiv[p] != 0 || state.pixelValuesR[p] != 0 ||
+                                    state.pixelValuesG[p] != 0 || state.pixelValuesB[p] != 0)) {
+                    return fail("State::update left stale accumulators on an untouched pixel");
+                }
+            }
+
+            state.resolvePixels(currentFrame.data(), object.pixelCount);
+            state.collectChangedPixels(changed);
+            std::vector<bool> reported(object.pixelCount, false);
+            for (const uint16_t pixel : changed) {
+                reported[pixel] = true;
+            }
+            for (uint16_t p = 0; p < object.pixelCount; p++) {
+                const size_t offset = static_cast<size_t>(p) * 3u;
+                const bool lit = currentFrame[offset] != 0 || currentFrame[offset + 1] != 0 ||
+                                 currentFrame[offset + 2] != 0;
+                const bool differs = currentFrame[offset] != previousFrame[offset] ||
+                                     currentFrame[offset + 1] != previousFrame[offset + 1] ||
+                                     currentFrame[offset + 2] != previousFrame[offset + 2];
+                sawLitFrame = sawLitFrame || lit;
+                if ((lit || differs) && !reported[p]) {
+                    return fail("State::collectChangedPixels missed a changed pixel");
+                }
+            }
+            previousFrame.swap(currentFrame);
+        }
+        if (!sawLitFrame) {
+            return fail("Dirty-region test never rendered a lit pixel");
+        }
+    }
+
     if (Port::poolCount() != 0) {
         return fail("Port pool should be empty after scoped object teardown");
     }
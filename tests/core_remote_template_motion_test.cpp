@@ -56,9 +56,9 @@ std::string describeContributorsAtPixel(LightList* list, uint16_t pixel) {
         }
 
         const bool contributesPrimary =
-            light->pixel1 == static_cast<int16_t>(pixel) && light->pixel1Weight > 0;
+            light->pixel1() == static_cast<int16_t>(pixel) && light->pixel1Weight() > 0;
         const bool contributesSecondary =
-            light->pixel2 == static_cast<int16_t>(pixel) && light->pixel2Weight > 0;
+            light->pixel2() == static_cast<int16_t>(pixel) && light->pixel2Weight() > 0;
         if (!contributesPrimary && !contributesSecondary) {
             continue;
         }
@@ -68,16 +68,16 @@ std::string describeContributorsAtPixel(LightList* list, uint16_t pixel) {
         }
         found = true;
         out << "idx=" << i
-            << " pos=" << light->position
+            << " pos=" << light->position()
             << " owner=";
-        if (light->owner == nullptr) {
+        if (light->owner() == nullptr) {
             out << "null";
         } else {
-            Owner* owner = const_cast<Owner*>(light->owner);
+            Owner* owner = const_cast<Owner*>(light->owner());
             out << (owner->getType() == Owner::TYPE_INTERSECTION ? "I" : "C");
         }
-        out << " p1=" << light->pixel1 << "/" << static_cast<int>(light->pixel1Weight)
-            << " p2=" << light->pixel2 << "/" << static_cast<int>(light->pixel2Weight);
+        out << " p1=" << light->pixel1() << "/" << static_cast<int>(light->pixel1Weight())
+            << " p2=" << light->pixel2() << "/" << static_cast<int>(light->pixel2Weight());
     }
 
     return found ? out.str() : "none";
@@ -169,10 +169,10 @@ bool findDominantContributionAtPixel(LightList* list, uint16_t pixel, ColorRGB&
             continue;
         }
 
-        if (light->pixel1 == static_cast<int16_t>(pixel)) {
-            ColorRGB contribution = light->getPixelColorAt(light->pixel1);
+        if (light->pixel1() == static_cast<int16_t>(pixel)) {
+            ColorRGB contribution = light->getPixelColorAt(light->pixel1());
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
-            contribution = scaleColor(contribution, light->pixel1Weight);
+            contribution = scaleColor(contribution, light->pixel1Weight());
 #endif
             const uint16_t energy = colorEnergy(contribution);
             if (!found || energy > bestEnergy) {
@@ -182,9 +182,9 @@ bool findDominantContributionAtPixel(LightList* list, uint16_t pixel, ColorRGB&
             }
         }
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
-        if (light->pixel2 == static_cast<int16_t>(pixel) && light->pixel2Weight > 0) {
-            ColorRGB contribution = light->getPixelColorAt(light->pixel2);
-            contribution = scaleColor(contribution, light->pixel2Weight);
+        if (light->pixel2() == static_cast<int16_t>(pixel) && light->pixel2Weight() > 0) {
+            ColorRGB contribution = light->getPixelColorAt(light->pixel2());
+            contribution = scaleColor(contribution, light->pixel2Weight());
             const uint16_t energy = colorEnergy(contribution);
             if (!found || energy > bestEnergy) {
                 found = true;
@@ -211,18 +211,18 @@ bool findAccumulatedContributionAtPixel(LightList* list, uint16_t pixel, ColorRG
             continue;
         }
 
-        if (light->pixel1 == static_cast<int16_t>(pixel)) {
-            ColorRGB contribution = light->getPixelColorAt(light->pixel1);
+        if (light->pixel1() == static_cast<int16_t>(pixel)) {
+            ColorRGB contribution = light->getPixelColorAt(light->pixel1());
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
-            contribution = scaleColor(contribution, light->pixel1Weight);
+            contribution = scaleColor(contribution, light->pixel1Weight());
 #endif
             total = accumulateColor(total, contribution);
             found = true;
         }
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
-        if (light->pixel2 == static_cast<int16_t>(pixel) && light->pixel2Weight > 0) {
-            ColorRGB contribution = light->getPixelColorAt(light->pixel2);
-            contribution = scaleColor(contribution, light->pixel2Weight);
+        if (light->pixel2() == static_cast<int16_t>(pixel) && light->pixel2Weight() > 0) {
+            ColorRGB contribution = light->getPixelColorAt(light->pixel2());
+            contribution = scaleColor(contribution, light->pixel2Weight());
             total = accumulateColor(total, contribution);
             found = true;
         }
@@ -251,29 +251,29 @@ bool findRemoteIngressExpectedContributionAtPixel(LightList* list,
             continue;
         }
 
-        if (light->pixel1 == static_cast<int16_t>(pixel)) {
-            ColorRGB contribution = light->getPixelColorAt(light->pixel1);
+        if (light->pixel1() == static_cast<int16_t>(pixel)) {
+            ColorRGB contribution = light->getPixelColorAt(light->pixel1());
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
             const RuntimeLight* previous = light->getPrev();
             const bool compensateHiddenIngress =
                 list->compensateHiddenIngressContinuity &&
-                light->inPort == nullptr &&
+                light->inPort() == nullptr &&
                 previous != nullptr &&
-                previous->pixel1 == static_cast<int16_t>(adjacentPixel) &&
-                previous->pixel1Weight > 0 &&
-                previous->owner != nullptr &&
-                const_cast<Owner*>(previous->owner)->getType() == Owner::TYPE_CONNECTION;
+                previous->pixel1() == static_cast<int16_t>(adjacentPixel) &&
+                previous->pixel1Weight() > 0 &&
+                previous->owner() != nullptr &&
+                const_cast<Owner*>(previous->owner())->getType() == Owner::TYPE_CONNECTION;
             if (!compensateHiddenIngress) {
-                contribution = scaleColor(contribution, light->pixel1Weight);
+                contribution = scaleColor(contribution, light->pixel1Weight());
             }
 #endif
             total = accumulateColor(total, contribution);
             found = true;
         }
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
-        if (light->pixel2 == static_cast<int16_t>(pixel) && light->pixel2Weight > 0) {
-            ColorRGB contribution = light->getPixelColorAt(light->pixel2);
-            contribution = scaleColor(contribution, light->pixel2Weight);
+        if (light->pixel2() == static_cast<int16_t>(pixel) && light->pixel2Weight() > 0) {
+            ColorRGB contribution = light->getPixelColorAt(light->pixel2());
+            contribution = scaleColor(contribution, light->pixel2Weight());
             total = accumulateColor(total, contribution);
             found = true;
         }
@@ -396,7 +396,7 @@ std::unique_ptr<DeviceFixture> makeDevice150Fixture() {
 }
 
 bool sendLightViaESPNowTemplateHook(const uint8_t*,
-                                    uint8_t targetPortId,
+                                    uint16_t targetPortId,
                                     RuntimeLight* const light,
                                     bool sendList) {
     TemplateTransportContext* context = gTemplateTransportContext;
@@ -466,16 +466,12 @@ bool sendLightViaESPNowTemplateHook(const uint8_t*,
         context->lastError = "remote template replay activation failed";
         return false;
     }
-    const int8_t intersectionId =
-        (context->remoteTargetPort != nullptr && context->remoteTargetPort->intersection != nullptr)
-            ? static_cast<int8_t>(context->remoteTargetPort->intersection->id)
-            : -1;
     for (uint16_t i = 0; i < remoteList->numLights; ++i) {
         RuntimeLight* remoteLight = (*remoteList)[i];
         if (remoteLight == nullptr || context->remoteTargetPort == nullptr) {
             continue;
         }
-        remoteLight->setOutPort(context->remoteTargetPort, intersectionId);
+        remoteLight->setOutPort(context->remoteTargetPort);
     }
     if (!context->remoteState->replaceListSlot(context->remoteSlot, remoteList)) {
         context->lastError = "remote slot replacement failed";
@@ -491,13 +487,8 @@ bool sendLightViaESPNowTemplateHook(const uint8_t*,
 int main() {
     std::srand(41);
     gMillis = 0;
-    LightList::nextId = 0;
-    Intersection::nextId = 0;
-    Port::setNextId(0);
-
     std::unique_ptr<DeviceFixture> remote = makeDevice154Fixture();
 
-    Intersection::nextId = 0;
     std::unique_ptr<DeviceFixture> sender = makeDevice150Fixture();
 
     TemplateTransportContext transport = {};
@@ -728,13 +719,8 @@ int main() {
 
     {
         gMillis = 0;
-        LightList::nextId = 0;
-        Intersection::nextId = 0;
-        Port::setNextId(0);
-
         std::unique_ptr<DeviceFixture> slowRemote = makeDevice154Fixture();
 
-        Intersection::nextId = 0;
         std::unique_ptr<DeviceFixture> slowSender = makeDevice150Fixture();
 
         TemplateTransportContext slowTransport = {};
@@ -921,10 +907,6 @@ int main() {
 
     {
         gMillis = 0;
-        LightList::nextId = 0;
-        Intersection::nextId = 0;
-        Port::setNextId(0);
-
         std::unique_ptr<DeviceFixture> internal = makeDevice150Fixture();
         internal->primaryModel->put(internal->externalPort, internal->conn12->toPort, 0);
         internal->primaryModel->put(internal->conn02->toPort, internal->conn12->toPort, 100);
@@ -1037,10 +1019,6 @@ int main() {
 
     {
         gMillis = 0;
-        LightList::nextId = 0;
-        Intersection::nextId = 0;
-        Port::setNextId(0);
-
         std::unique_ptr<DeviceFixture> remoteSparse = makeDevice154Fixture();
         InternalPort* ingressPort = static_cast<InternalPort*>(remoteSparse->conn02->toPort);
         if (ingressPort == nullptr || ingressPort->connection == nullptr) {
@@ -1068,8 +1046,6 @@ int main() {
             return fail("Sparse replay regression fixture failed to build the snapshot list");
         }
 
-        const int8_t intersectionId =
-            (ingressPort->intersection != nullptr) ? static_cast<int8_t>(ingressPort->intersection->id) : -1;
         sparseSnapshot->bindRuntimeContext(remoteSparse->object.runtimeContext());
         sparseSnapshot->emitOffset = 0;
         sparseSnapshot->numSplits = 0;
@@ -1079,20 +1055,20 @@ int main() {
         if (latentLight == nullptr) {
             return fail("Sparse replay regression fixture did not allocate the latent edge light");
         }
-        if (latentLight->position >= 0.0f) {
+        if (latentLight->position() >= 0.0f) {
             return fail("Sparse replay regression fixture expected a negative-position latent light");
         }
 
-        latentLight->owner = nullptr;
-        latentLight->isExpired = false;
+        latentLight->setOwner(nullptr);
+        latentLight->setExpired(false);
         latentLight->setInPort(nullptr);
-        latentLight->setOutPort(ingressPort, intersectionId);
+        latentLight->setOutPort(ingressPort);
         ingressPort->connection->add(latentLight);
 
-        if (latentLight->owner != ingressPort->connection) {
+        if (latentLight->owner() != ingressPort->connection) {
             return fail("Sparse replay latent light should stay owned by the ingress connection");
         }
-        if (latentLight->pixel1 >= 0) {
+        if (latentLight->pixel1() >= 0) {
             return fail("Sparse replay latent light should not render before reaching the strip");
         }
     }
@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "lightgraph/internal/Globals.h"
 #include "lightgraph/internal/objects.hpp"
@@ -130,6 +132,87 @@ void advanceFrame(State& state, unsigned long deltaMillis = 16) {
     state.update();
 }
 
+// Renders `frames` frames of one emitted list and returns every pixel of every frame.
+std::vector<ColorRGB> renderEmitFrames(uint16_t behaviourFlags, bool specialized, int frames) {
+    Line line(30);
+    State state(line);
+    state.lightLists[0]->visible = false;
+    state.specializedLightUpdate = specialized;
+    gMillis = 0;
+    lightgraphResetFrameTiming();
+    std::srand(7);
+
+    EmitParams params(L_BOUNCE, 0.7f, 0x30A0FF);
+    params.setLength(6);
+    params.fadeSpeed = 24;
+    params.duration = INFINITE_DURATION;
+    params.behaviourFlags = behaviourFlags;
+    params.from = findIntersectionIndexByTopPixel(line, 0);
+
+    std::vector<ColorRGB> pixels;
+    if (state.emit(params) < 0) {
+        return pixels;
+    }
+    for (int frame = 0; frame < frames; ++frame) {
+        advanceFrame(state);
+        for (uint16_t i = 0; i < line.pixelCount; ++i) {
+            pixels.push_back(state.getPixel(i));
+        }
+    }
+    return pixels;
+}
+
+#if LIGHTGRAPH_PARALLEL_UPDATE
+// Several overlapping lists with mixed blend modes and behaviours over a visible background.
+std::vector<ColorRGB> renderLayeredFrames(uint8_t threads, int frames) {
+    Line line(120);
+    State state(line);
+    std::vector<ColorRGB> pixels;
+    if (!state.setUpdateThreads(threads)) {
+        return pixels;
+    }
+    gMillis = 0;
+    lightgraphResetFrameTiming();
+
+    struct Layer {
+        float speed;
+        uint32_t color;
+        uint16_t length;
+        uint16_t flags;
+        BlendMode blend;
+    };
+    const std::array<Layer, 6> layers = {{
+        {1.0f, 0xFF2010, 12, 0, BLEND_NORMAL},
+        {0.6f, 0x20FF40, 30, B_FILL_EASE, BLEND_NORMAL},
+        {1.4f, 0x4060FF, 8, B_RENDER_SEGMENT, BLEND_SCREEN},
+        {0.8f, 0xC0C0C0, 20, 0, BLEND_MULTIPLY},
+        {1.2f, 0xFFFF00, 10, B_MIRROR_ROTATE, BLEND_ADD},
+        {0.5f, 0x8000FF, 16, B_BRI_CONST_NOISE, BLEND_OVERLAY},
+    }};
+    const int from = findIntersectionIndexByTopPixel(line, 0);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        EmitParams params(L_BOUNCE, layers[i].speed, layers[i].color);
+        params.setLength(layers[i].length);
+        params.duration = INFINITE_DURATION;
+        params.behaviourFlags = layers[i].flags;
+        params.noteId = static_cast<uint16_t>(i + 1);
+        params.from = from;
+        const int8_t slot = state.emit(params);
+        if (slot < 0) {
+            return std::vector<ColorRGB>();
+        }
+        state.lightLists[slot]->blendMode = layers[i].blend;
+    }
+    for (int frame = 0; frame < frames; ++frame) {
+        advanceFrame(state);
+        for (uint16_t i = 0; i < line.pixelCount; ++i) {
+            pixels.push_back(state.getPixel(i));
+        }
+    }
+    return pixels;
+}
+#endif
+
 class NoMirrorObject : public TopologyObject {
   public:
     explicit NoMirrorObject(uint16_t pixelCount) : TopologyObject(pixelCount) {
@@ -157,7 +240,7 @@ class StaticOwner : public Owner {
 
     void emit(RuntimeLight* const light) const override {
         if (light != nullptr) {
-            light->owner = this;
+            light->setOwner(this);
         }
     }
 
@@ -176,6 +259,26 @@ class SolidRuntimeList : public LightList {
     ColorRGB color_;
 };
 
+// Editable, light-less list that stays alive, i.e. what State treats as a background layer.
+class SolidBackgroundList : public LightList {
+  public:
+    explicit SolidBackgroundList(ColorRGB color) : color_(color) {
+        editable = true;
+        lifeMillis = INFINITE_DURATION;
+    }
+
+    ColorRGB getColor(int16_t /*pixel*/ = -1) const override {
+        return color_;
+    }
+
+    bool update() override {
+        return false;
+    }
+
+  private:
+    ColorRGB color_;
+};
+
 class GradientRuntimeList : public LightList {
   public:
     ColorRGB getColor(int16_t pixel = -1) const override {
@@ -186,6 +289,99 @@ class GradientRuntimeList : public LightList {
     }
 };
 
+// A star whose hub has enough port slots to route through alias tables. Only the
+// source intersection emits; its lights all reach the hub through the feed.
+class HubObject : public TopologyObject {
+  public:
+    static constexpr uint8_t kSpokes = 7;
+
+    Intersection* hub = nullptr;
+    Connection* feed = nullptr;
+    std::array<Connection*, kSpokes> spokes{};
+
+    HubObject() : TopologyObject(100) {
+        addModel(new Model(0, 0, GROUP1));
+        hub = addIntersection(new Intersection(kSpokes + 1, 0, -1, GROUP1, true, false));
+        Intersection* source = addIntersection(new Intersection(2, 90, -1, GROUP1));
+        feed = addConnection(new Connection(source, hub, GROUP1));
+        for (uint8_t i = 0; i < kSpokes; ++i) {
+            Intersection* leaf =
+                addIntersection(new Intersection(2, static_cast<uint16_t>(20 + 10 * i), -1, GROUP1, true, false));
+            spokes[i] = addConnection(new Connection(hub, leaf, GROUP1));
+        }
+    }
+
+    uint16_t* getMirroredPixels(uint16_t, Owner*, bool) override {
+        mirroredPixels_[0] = 0;
+        return mirroredPixels_;
+    }
+
+    EmitParams getModelParams(int model) const override {
+        return EmitParams(model % 1, 1.0f);
+    }
+
+  private:
+    uint16_t mirroredPixels_[2] = {0};
+};
+
+// Four intersections joined pairwise by one-pixel connections, so a linked
+// train spans many intersections and every hop is a random three-way choice.
+class MeshObject : public TopologyObject {
+  public:
+    static constexpr uint8_t kNodes = 4;
+
+    std::array<Intersection*, kNodes> nodes{};
+
+    MeshObject() : TopologyObject(40) {
+        addModel(new Model(0, 0, GROUP1));
+        for (uint8_t i = 0; i < kNodes; ++i) {
+            nodes[i] = addIntersection(
+                new Intersection(kNodes - 1, static_cast<uint16_t>(i * 10), -1, GROUP1, false, i == 0));
+        }
+        for (uint8_t a = 0; a < kNodes; ++a) {
+            for (uint8_t b = static_cast<uint8_t>(a + 1); b < kNodes; ++b) {
+                addConnection(new Connection(nodes[a], nodes[b], GROUP1, 1));
+            }
+        }
+    }
+
+    uint16_t* getMirroredPixels(uint16_t, Owner*, bool) override {
+        mirroredPixels_[0] = 0;
+        return mirroredPixels_;
+    }
+
+    EmitParams getModelParams(int model) const override {
+        return EmitParams(model % 1, 1.0f);
+    }
+
+  private:
+    uint16_t mirroredPixels_[2] = {0};
+};
+
+uint32_t uniformDraw(uint32_t range) {
+    return static_cast<uint32_t>(std::rand() / (static_cast<double>(RAND_MAX) + 1.0) * range);
+}
+
+// Pearson's statistic for observed counts against integer weights.
+double chiSquare(const uint32_t* observed, const uint16_t* weights, uint8_t count) {
+    uint32_t samples = 0;
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        samples += observed[i];
+        total += weights[i];
+    }
+    double statistic = 0.0;
+    for (uint8_t i = 0; i < count; ++i) {
+        if (weights[i] == 0) {
+            continue;
+        }
+        const double expected = static_cast<double>(samples) * weights[i] / total;
+        const double delta = observed[i] - expected;
+        statistic += delta * delta / expected;
+    }
+    return statistic;
+}
+
 } // namespace
 
 int main() {
@@ -225,6 +421,23 @@ int main() {
             return fail("Line topology has unexpected connection lengths");
         }
 
+        // A segment over a connection without LEDs is just its two end pixels.
+        for (uint8_t i = 0; i < connectionCount; ++i) {
+            Connection* connection = line.getConnection(i, GROUP1);
+            if (connection->numLeds != 0) {
+                continue;
+            }
+            LightList list;
+            list.lightStore().reserve(1);
+            RuntimeLight light(&list, 0);
+            light.setOutPort(connection->fromPort);
+            std::array<uint16_t, 8> segment{};
+            if (light.setSegmentPixels(segment.data(), segment.size()) != 2 ||
+                segment[1] != connection->getFromPixel() || segment[2] != connection->getToPixel()) {
+                return fail("Segment pixels over a zero-LED connection should be its two end pixels");
+            }
+        }
+
         const uint8_t intersectionCount = line.countIntersections(GROUP1);
         for (uint8_t i = 0; i < intersectionCount; ++i) {
             Intersection* intersection = line.getIntersection(i, GROUP1);
@@ -380,6 +593,212 @@ int main() {
         if (sawVerticalBranch) {
             return fail("Cross routing leaked into the vertical branch in horizontal scenario");
         }
+
+        // Re-weighting after the routing tables were compiled must take effect on the next route.
+        Port* verticalPortAtCenter = nullptr;
+        for (Port* port : center->ports) {
+            if (port != nullptr && port->connection != leftToCenter && port->connection != centerToRight) {
+                verticalPortAtCenter = port;
+                break;
+            }
+        }
+        if (verticalPortAtCenter == nullptr) {
+            return fail("Cross center intersection has no vertical port");
+        }
+        horizontalModel->put(verticalPortAtCenter, 90);
+
+        params.noteId = 2;
+        if (state.emit(params) < 0) {
+            return fail("Cross re-weighted routing emit failed unexpectedly");
+        }
+        const int8_t reweightedIndex = state.findList(params.noteId);
+        bool tookReweightedPort = false;
+        for (int frame = 0; frame < 80 && reweightedIndex >= 0; ++frame) {
+            advanceFrame(state);
+            const LightList* list = state.lightLists[reweightedIndex];
+            if (list != nullptr && list->numLights > 0 && (*list)[0]->owner() == verticalPortAtCenter->connection) {
+                tookReweightedPort = true;
+            }
+        }
+        if (!tookReweightedPort) {
+            return fail("Cross routing ignored a weight change made after routing tables were built");
+        }
+    }
+
+    // Alias tables and the cumulative scan map their whole draw range onto exactly the row's weights.
+    {
+        uint32_t seed = 0x5EED1234u;
+        for (int trial = 0; trial < 64; ++trial) {
+            const uint8_t count = static_cast<uint8_t>(2 + trial % 8);
+            std::array<uint16_t, 9> weights{};
+            std::array<uint16_t, 9> row{};
+            uint16_t total = 0;
+            for (uint8_t i = 0; i < count; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                // About one port in four is the incoming port or unweighted.
+                weights[i] = ((seed >> 28) < 4) ? 0 : static_cast<uint16_t>((seed >> 8) % 256);
+                total = static_cast<uint16_t>(total + weights[i]);
+                row[i] = total;
+            }
+            if (total == 0) {
+                continue;
+            }
+
+            std::array<route_select::AliasEntry, 9> table{};
+            route_select::buildAlias(row.data(), count, table.data());
+            std::array<uint32_t, 9> aliasHits{};
+            std::array<uint32_t, 9> scanHits{};
+            for (uint32_t draw = 0; draw < static_cast<uint32_t>(count) * total; ++draw) {
+                aliasHits[route_select::pickAlias(table.data(), total, draw)]++;
+            }
+            for (uint16_t draw = 0; draw < total; ++draw) {
+                scanHits[route_select::pickCumulative(row.data(), count, draw)]++;
+            }
+            for (uint8_t i = 0; i < count; ++i) {
+                if (aliasHits[i] != static_cast<uint32_t>(count) * weights[i] || scanHits[i] != weights[i]) {
+                    return fail("Weighted port selection does not match the row weights for port " +
+                                std::to_string(i) + " of " + std::to_string(count));
+                }
+            }
+        }
+    }
+
+    // Under uniform random draws both pickers fit the weights (chi-square, p = 0.001).
+    {
+        const std::array<uint16_t, 8> weights = {{10, 0, 1, 40, 7, 0, 25, 3}};
+        std::array<uint16_t, 8> row{};
+        uint16_t total = 0;
+        for (size_t i = 0; i < weights.size(); ++i) {
+            total = static_cast<uint16_t>(total + weights[i]);
+            row[i] = total;
+        }
+        std::array<route_select::AliasEntry, 8> table{};
+        route_select::buildAlias(row.data(), 8, table.data());
+
+        std::srand(17);
+        std::array<uint32_t, 8> aliasHits{};
+        std::array<uint32_t, 8> scanHits{};
+        for (int sample = 0; sample < 200000; ++sample) {
+            aliasHits[route_select::pickAlias(table.data(), total, uniformDraw(8u * total))]++;
+            const uint8_t scanned =
+                route_select::pickCumulative(row.data(), 8, static_cast<uint16_t>(uniformDraw(total)));
+            if (scanned < 8) {
+                scanHits[scanned]++;
+            }
+        }
+        // Six weighted ports: 5 degrees of freedom.
+        constexpr double kCritical = 20.515;
+        if (aliasHits[1] != 0 || aliasHits[5] != 0 || scanHits[1] != 0 || scanHits[5] != 0) {
+            return fail("Weighted port selection picked a zero-weight port");
+        }
+        if (chiSquare(aliasHits.data(), weights.data(), 8) > kCritical) {
+            return fail("Alias port selection does not fit the weights");
+        }
+        if (chiSquare(scanHits.data(), weights.data(), 8) > kCritical) {
+            return fail("Cumulative port selection does not fit the weights");
+        }
+    }
+
+    // End to end: lights crossing a high-degree hub leave along each spoke in proportion to its weight.
+    {
+        HubObject hubObject;
+        State state(hubObject);
+        state.lightLists[0]->visible = false;
+        static_assert(HubObject::kSpokes + 1 >= LIGHTGRAPH_ALIAS_ROUTING_MIN_PORTS,
+                      "hub must be routed through alias tables");
+
+        const std::array<uint16_t, HubObject::kSpokes> weights = {{1, 0, 2, 4, 8, 16, 32}};
+        Model* model = hubObject.getModel(0);
+        for (uint8_t i = 0; i < HubObject::kSpokes; ++i) {
+            model->put(hubObject.spokes[i]->fromPort, static_cast<uint8_t>(weights[i]));
+        }
+
+        std::srand(23);
+        EmitParams params(0, 4.0f, 0xFFFFFF);
+        params.setLength(1000);
+        params.linked = false;
+        params.duration = INFINITE_DURATION;
+        params.from = 0;
+        const int8_t slot = state.emit(params);
+        if (slot < 0) {
+            return fail("Hub routing emit failed unexpectedly");
+        }
+
+        const LightList* list = state.lightLists[slot];
+        std::vector<bool> counted(list->numLights, false);
+        std::array<uint32_t, HubObject::kSpokes> hits{};
+        uint32_t routed = 0;
+        for (int frame = 0; frame < 2000 && routed < list->numLights; ++frame) {
+            advanceFrame(state);
+            for (uint16_t i = 0; i < list->numLights; ++i) {
+                const RuntimeLight* light = (*list)[i];
+                const Port* port = (light != nullptr && !counted[i]) ? light->outPort() : nullptr;
+                if (port == nullptr || port->intersection != hubObject.hub) {
+                    continue;
+                }
+                counted[i] = true;
+                routed++;
+                for (uint8_t spoke = 0; spoke < HubObject::kSpokes; ++spoke) {
+                    if (port == hubObject.spokes[spoke]->fromPort) {
+                        hits[spoke]++;
+                    }
+                }
+            }
+        }
+        if (routed != list->numLights) {
+            return fail("Not every hub light was routed (" + std::to_string(routed) + ")");
+        }
+        if (hits[1] != 0) {
+            return fail("Hub routing used a zero-weight spoke");
+        }
+        if (chiSquare(hits.data(), weights.data(), HubObject::kSpokes) > 20.515) {
+            return fail("Hub routing does not fit the spoke weights");
+        }
+    }
+
+    // Linked trains replay the head's route from the list's trace, however
+    // many intersections separate a follower from the head.
+    {
+        MeshObject mesh;
+        State state(mesh);
+        state.lightLists[0]->visible = false;
+
+        EmitParams params(0, 1.0f, 0xFFFFFF);
+        params.setLength(48);
+        params.duration = INFINITE_DURATION;
+        params.from = 0;
+        const int8_t slot = state.emit(params);
+        if (slot < 0) {
+            return fail("Mesh emit failed unexpectedly");
+        }
+
+        const LightList* list = state.lightLists[slot];
+        std::vector<std::vector<const Port*>> routes(list->numLights);
+        uint16_t widestSpread = 0;
+        for (int frame = 0; frame < 600; ++frame) {
+            advanceFrame(state);
+            uint16_t leadHop = 0;
+            uint16_t lastHop = UINT16_MAX;
+            for (uint16_t i = 0; i < list->numLights; ++i) {
+                const RuntimeLight* light = (*list)[i];
+                if (light->routeHop() > routes[i].size()) {
+                    routes[i].push_back(light->outPort());
+                }
+                leadHop = std::max(leadHop, light->routeHop());
+                lastHop = std::min(lastHop, light->routeHop());
+            }
+            widestSpread = std::max<uint16_t>(widestSpread, static_cast<uint16_t>(leadHop - lastHop));
+        }
+        if (widestSpread <= 3) {
+            return fail("Mesh train should span more than three intersections");
+        }
+        const std::vector<const Port*>& headRoute = routes[0];
+        for (uint16_t i = 1; i < list->numLights; ++i) {
+            if (routes[i].size() < 8 || routes[i].size() > headRoute.size() ||
+                !std::equal(routes[i].begin(), routes[i].end(), headRoute.begin())) {
+                return fail("Mesh follower " + std::to_string(i) + " left the head's route");
+            }
+        }
     }
 
     // Emit scenario: intersection emission should first render at emitter intersection pixel.
@@ -509,9 +928,9 @@ int main() {
             return fail("Fractional connection test fixture is incomplete");
         }
 
-        light->owner = connection;
-        light->position = 5.25f;
-        light->setOutPort(connection->fromPort, static_cast<int8_t>(connection->from->id));
+        light->setOwner(connection);
+        light->setPosition(5.25f);
+        light->setOutPort(connection->fromPort);
         state.update();
 
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
@@ -525,9 +944,9 @@ int main() {
         }
 #endif
 
-        light->owner = connection;
-        light->position = 5.0f;
-        light->setOutPort(connection->fromPort, static_cast<int8_t>(connection->from->id));
+        light->setOwner(connection);
+        light->setPosition(5.0f);
+        light->setOutPort(connection->fromPort);
         state.update();
 
         if (!isApproxColor(state.getPixel(6), 0, 204, 0, 1) || isNonBlack(state.getPixel(7))) {
@@ -536,9 +955,9 @@ int main() {
 
         const uint16_t finalConnectionPixel = connection->getPixel(connection->numLeds - 1);
         const uint16_t destinationIntersectionPixel = connection->to->topPixel;
-        light->owner = connection;
-        light->position = static_cast<float>(connection->numLeds) - 0.75f;
-        light->setOutPort(connection->fromPort, static_cast<int8_t>(connection->from->id));
+        light->setOwner(connection);
+        light->setPosition(static_cast<float>(connection->numLeds) - 0.75f);
+        light->setOutPort(connection->fromPort);
         state.update();
 
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
@@ -588,9 +1007,9 @@ int main() {
             return fail("Unable to resolve outgoing physical port for fractional handoff test");
         }
 
-        light->owner = source;
-        light->position = 0.25f;
-        light->setOutPort(physicalPort, static_cast<int8_t>(source->id));
+        light->setOwner(source);
+        light->setPosition(0.25f);
+        light->setOutPort(physicalPort);
         state.update();
 
 #if LIGHTGRAPH_FRACTIONAL_RENDERING
@@ -609,9 +1028,9 @@ int main() {
             return fail("Unable to resolve zero-length port for fractional handoff fallback test");
         }
 
-        light->owner = source;
-        light->position = 0.5f;
-        light->setOutPort(zeroLengthPort, static_cast<int8_t>(source->id));
+        light->setOwner(source);
+        light->setPosition(0.5f);
+        light->setOutPort(zeroLengthPort);
         state.update();
 
         if (!isApproxColor(state.getPixel(0), 204, 34, 0, 1) || isNonBlack(state.getPixel(1))) {
@@ -653,9 +1072,9 @@ int main() {
             return fail("External-port handoff light fixture is missing");
         }
 
-        light->owner = intersection;
-        light->position = 0.5f;
-        light->setOutPort(externalPort, static_cast<int8_t>(intersection->id));
+        light->setOwner(intersection);
+        light->setPosition(0.5f);
+        light->setOutPort(externalPort);
         state.update();
 
         if (!isApproxColor(state.getPixel(3), 0x33, 0xAA, 0x55, 1) || countLitPixels(state, 0, 12) != 1) {
@@ -679,7 +1098,7 @@ int main() {
         if (light == nullptr) {
             return fail("Gradient runtime-light fixture did not allocate a light");
         }
-        light->brightness = 255;
+        light->setBrightness(255);
         light->setRenderedPixels(0, 1, 128);
 
         state.updateLight(light);
@@ -712,7 +1131,7 @@ int main() {
             if (light == nullptr) {
                 return fail("Same-list fractional accumulation fixture is incomplete");
             }
-            light->owner = &owner;
+            light->setOwner(&owner);
         }
 
         list->lights[0]->setRenderedPixels(0, 1, 64);
@@ -728,6 +1147,47 @@ int main() {
             return fail("Same-list fractional contributions should accumulate before BLEND_NORMAL compositing");
         }
     }
+
+    // A list is one layer: overlapping lights sum first and the sum is multiplied onto the
+    // background once. Blending per light would multiply the background twice (200 -> ~50).
+    {
+        NoMirrorObject object(3);
+        State state(object);
+        delete state.lightLists[0];
+        state.lightLists[0] = new SolidBackgroundList(ColorRGB(200, 200, 200));
+
+        StaticOwner owner;
+        SolidRuntimeList* list = new SolidRuntimeList(ColorRGB(128, 128, 128));
+        list->model = object.getModel(0);
+        list->setup(2, 255);
+        list->speed = 0.0f;
+        list->lifeMillis = INFINITE_DURATION;
+        list->blendMode = BLEND_MULTIPLY;
+        state.lightLists[1] = list;
+        state.activateList(&owner, list);
+
+        list->numEmitted = list->numLights;
+        for (uint16_t i = 0; i < list->numLights; ++i) {
+            RuntimeLight* light = list->lights[i];
+            if (light == nullptr) {
+                return fail("Layer compositing fixture is incomplete");
+            }
+            light->setOwner(&owner);
+            light->setRenderedPixels(0, 0, 0);
+        }
+
+        gMillis = 0;
+        lightgraphResetFrameTiming();
+        state.update();
+
+        if (!isApproxColor(state.getPixel(0), 200, 200, 200, 1)) {
+            return fail("Overlapping lights should be multiplied onto the background as one layer");
+        }
+        if (!isApproxColor(state.getPixel(1), 200, 200, 200, 0) ||
+            !isApproxColor(state.getPixel(2), 200, 200, 200, 0)) {
+            return fail("Background layer should be composited directly on untouched pixels");
+        }
+    }
 #endif
 
     // Emit scenario: render-segment mode should paint the full connection span (including endpoints).
@@ -820,6 +1280,57 @@ int main() {
         }
     }
 
+    // The per-list specialized update kernels must render exactly what the generic per-light
+    // path renders, for every behaviour bit they are specialized on.
+    {
+        const std::array<uint16_t, 8> flagSets = {{
+            0,
+            B_RENDER_SEGMENT,
+            B_FILL_EASE,
+            B_BRI_CONST_NOISE,
+            B_POS_CHANGE_FADE,
+            B_MIRROR_ROTATE,
+            static_cast<uint16_t>(B_FILL_EASE | B_MIRROR_FLIP | B_POS_CHANGE_FADE),
+            static_cast<uint16_t>(B_RENDER_SEGMENT | B_BRI_CONST_NOISE | B_MIRROR_ROTATE),
+        }};
+        for (const uint16_t flags : flagSets) {
+            const std::vector<ColorRGB> generic = renderEmitFrames(flags, false, 90);
+            const std::vector<ColorRGB> specialized = renderEmitFrames(flags, true, 90);
+            if (generic.empty() || generic.size() != specialized.size()) {
+                return fail("Light kernel parity scenario failed to emit (flags " + std::to_string(flags) + ")");
+            }
+            for (size_t i = 0; i < generic.size(); ++i) {
+                if (!isApproxColor(generic[i], specialized[i].R, specialized[i].G, specialized[i].B, 0)) {
+                    return fail("Specialized light update diverged from the generic path (flags " +
+                                std::to_string(flags) + ")");
+                }
+            }
+        }
+    }
+
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    // Parallel list updates blend each list's layer in slot order, so the frames must match a
+    // serial update bit for bit, whatever the thread count.
+    {
+        const std::vector<ColorRGB> serial = renderLayeredFrames(1, 150);
+        if (serial.empty()) {
+            return fail("Parallel update parity scene failed to emit");
+        }
+        for (const uint8_t threads : {2, 4, 7}) {
+            const std::vector<ColorRGB> parallel = renderLayeredFrames(threads, 150);
+            if (parallel.size() != serial.size()) {
+                return fail("Parallel update parity scene failed with " + std::to_string(threads) + " threads");
+            }
+            for (size_t i = 0; i < serial.size(); ++i) {
+                if (!isApproxColor(parallel[i], serial[i].R, serial[i].G, serial[i].B, 0)) {
+                    return fail("Parallel update diverged from serial update with " +
+                                std::to_string(threads) + " threads");
+                }
+            }
+        }
+    }
+#endif
+
     // Emit scenario: max brightness should scale rendered LED intensity.
     {
         Line line(30);
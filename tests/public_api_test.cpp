@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <lightgraph/lightgraph.hpp>
 
@@ -15,6 +19,25 @@ bool isNonBlack(const lightgraph::Color& color) {
     return color.r > 0 || color.g > 0 || color.b > 0;
 }
 
+// Emits random-colored lists from random emitters and returns every frame.
+std::vector<uint8_t> runRandomShow(lightgraph::Engine& engine) {
+    std::vector<uint8_t> frames;
+    std::vector<uint8_t> frame(static_cast<size_t>(engine.pixelCount()) * 3u);
+    for (int step = 0; step < 120; ++step) {
+        if (step % 20 == 0) {
+            lightgraph::EmitCommand command;
+            command.model = static_cast<int8_t>(step / 20 % 2);
+            command.speed = 0.5f + 0.25f * static_cast<float>(step / 20);
+            command.length = 8;
+            engine.emit(command);
+        }
+        engine.tick(16);
+        engine.readFrame(frame.data(), frame.size());
+        frames.insert(frames.end(), frame.begin(), frame.end());
+    }
+    return frames;
+}
+
 } // namespace
 
 int main() {
@@ -105,6 +128,116 @@ int main() {
         return fail("Engine produced no visible pixels");
     }
 
+    std::vector<lightgraph::Color> frame(engine.pixelCount());
+    const auto frame_result = engine.readFrame(frame.data(), frame.size());
+    if (!frame_result || frame_result.value() != engine.pixelCount()) {
+        return fail("readFrame() should resolve every pixel into a correctly sized buffer");
+    }
+    std::vector<uint8_t> packed_frame(static_cast<size_t>(engine.pixelCount()) * 3u);
+    const auto packed_result = engine.readFrame(packed_frame.data(), packed_frame.size(), 128);
+    if (!packed_result || packed_result.value() != engine.pixelCount()) {
+        return fail("readFrame() should resolve every pixel into a packed RGB buffer");
+    }
+    for (uint16_t i = 0; i < engine.pixelCount(); ++i) {
+        const lightgraph::Color expected = engine.pixel(i).value();
+        if (frame[i].r != expected.r || frame[i].g != expected.g || frame[i].b != expected.b) {
+            return fail("readFrame() disagreed with pixel() at index " + std::to_string(i));
+        }
+        const lightgraph::Color dimmed = engine.pixel(i, 128).value();
+        if (packed_frame[i * 3u] != dimmed.r || packed_frame[i * 3u + 1u] != dimmed.g ||
+            packed_frame[i * 3u + 2u] != dimmed.b) {
+            return fail("Packed readFrame() disagreed with pixel() at index " + std::to_string(i));
+        }
+    }
+
+    const auto short_frame = engine.readFrame(frame.data(), frame.size() - 1);
+    if (short_frame.ok() || short_frame.status().code() != lightgraph::ErrorCode::InvalidArgument) {
+        return fail("readFrame() into a short buffer did not return ErrorCode::InvalidArgument");
+    }
+    const auto null_frame = engine.readFrame(static_cast<uint8_t*>(nullptr), packed_frame.size());
+    if (null_frame.ok() || null_frame.status().code() != lightgraph::ErrorCode::InvalidArgument) {
+        return fail("readFrame() into a null buffer did not return ErrorCode::InvalidArgument");
+    }
+
+    std::vector<uint16_t> changed(engine.pixelCount());
+    for (int frame_idx = 0; frame_idx < 8; ++frame_idx) {
+        const std::vector<lightgraph::Color> before = frame;
+        engine.tick(16);
+        if (!engine.readFrame(frame.data(), frame.size())) {
+            return fail("readFrame() failed unexpectedly while tracking changed pixels");
+        }
+        const auto changed_result = engine.changedPixels(changed.data(), changed.size());
+        if (!changed_result || changed_result.value() == 0) {
+            return fail("changedPixels() should report the pixels lit by an active list");
+        }
+        std::vector<bool> reported(engine.pixelCount(), false);
+        for (uint16_t i = 0; i < changed_result.value(); ++i) {
+            if (i > 0 && changed[i] <= changed[i - 1]) {
+                return fail("changedPixels() should return strictly ascending indices");
+            }
+            reported[changed[i]] = true;
+        }
+        for (uint16_t i = 0; i < engine.pixelCount(); ++i) {
+            const bool differs = frame[i].r != before[i].r || frame[i].g != before[i].g ||
+                                 frame[i].b != before[i].b;
+            if (!reported[i] && (differs || isNonBlack(frame[i]))) {
+                return fail("changedPixels() missed a changed pixel at index " + std::to_string(i));
+            }
+        }
+    }
+    lightgraph::FrameDelta delta;
+    const auto full_delta = engine.readFrameDelta(delta);
+    if (!full_delta || full_delta.value() != engine.pixelCount() || delta.runs.size() != 1 ||
+        delta.colors.size() != engine.pixelCount()) {
+        return fail("First readFrameDelta() should report the full frame as one run");
+    }
+    std::vector<lightgraph::Color> mirror = delta.colors;
+    for (int frame_idx = 0; frame_idx < 12; ++frame_idx) {
+        engine.tick(16);
+        const auto delta_result = engine.readFrameDelta(delta);
+        if (!delta_result || delta.colors.size() != delta_result.value()) {
+            return fail("readFrameDelta() should return one color per changed pixel");
+        }
+        size_t color_idx = 0;
+        uint32_t previous_end = 0;
+        for (const lightgraph::PixelRun& run : delta.runs) {
+            if (run.length == 0 || (color_idx > 0 && run.start <= previous_end)) {
+                return fail("readFrameDelta() runs should be non-empty, ascending and disjoint");
+            }
+            for (uint16_t offset = 0; offset < run.length; ++offset) {
+                mirror[run.start + offset] = delta.colors[color_idx++];
+            }
+            previous_end = static_cast<uint32_t>(run.start) + run.length;
+        }
+        if (!engine.readFrame(frame.data(), frame.size())) {
+            return fail("readFrame() failed unexpectedly while checking readFrameDelta()");
+        }
+        for (uint16_t i = 0; i < engine.pixelCount(); ++i) {
+            if (mirror[i].r != frame[i].r || mirror[i].g != frame[i].g || mirror[i].b != frame[i].b) {
+                return fail("Applying readFrameDelta() runs should reproduce readFrame() at index " +
+                            std::to_string(i));
+            }
+        }
+    }
+    const auto idle_delta = engine.readFrameDelta(delta);
+    if (!idle_delta || idle_delta.value() != 0 || !delta.runs.empty()) {
+        return fail("readFrameDelta() without a tick should report no changes");
+    }
+    engine.tick(16);
+    const auto saturated_delta = engine.readFrameDelta(delta, 255);
+    if (!saturated_delta || saturated_delta.value() != 0) {
+        return fail("readFrameDelta() with a 255 threshold should suppress every change");
+    }
+    engine.resetFrameDelta();
+    const auto reset_delta = engine.readFrameDelta(delta);
+    if (!reset_delta || reset_delta.value() != engine.pixelCount()) {
+        return fail("resetFrameDelta() should make the next delta a full frame");
+    }
+    const auto short_changed = engine.changedPixels(changed.data(), 0);
+    if (short_changed.ok() || short_changed.status().code() != lightgraph::ErrorCode::InvalidArgument) {
+        return fail("changedPixels() into a short buffer did not return ErrorCode::InvalidArgument");
+    }
+
     engine.setOn(false);
     if (engine.isOn()) {
         return fail("Engine should report output disabled after setOn(false)");
@@ -118,6 +251,14 @@ int main() {
             return fail("Disabled engine should not report visible pixels");
         }
     }
+    if (!engine.readFrame(frame.data(), frame.size())) {
+        return fail("readFrame() failed unexpectedly while output was disabled");
+    }
+    for (const lightgraph::Color& color : frame) {
+        if (isNonBlack(color)) {
+            return fail("Disabled engine should not report visible pixels through readFrame()");
+        }
+    }
     engine.setOn(true);
     if (!engine.isOn()) {
         return fail("Engine should report output enabled after setOn(true)");
@@ -153,6 +294,181 @@ int main() {
         return fail("setOn(true) should preserve auto-emit state");
     }
 
+    if (engine.updateThreads() != 1) {
+        return fail("Engine should update serially by default");
+    }
+    const lightgraph::Status zero_threads = engine.setUpdateThreads(0);
+    if (zero_threads.ok() || zero_threads.code() != lightgraph::ErrorCode::InvalidArgument) {
+        return fail("setUpdateThreads(0) should return ErrorCode::InvalidArgument");
+    }
+#if LIGHTGRAPH_PARALLEL_UPDATE
+    if (!engine.setUpdateThreads(3).ok() || engine.updateThreads() != 3) {
+        return fail("setUpdateThreads(3) should enable parallel update");
+    }
+    engine.tick(16);
+    if (!engine.setUpdateThreads(1).ok() || engine.updateThreads() != 1) {
+        return fail("setUpdateThreads(1) should return to serial update");
+    }
+#else
+    if (engine.setUpdateThreads(3).ok()) {
+        return fail("setUpdateThreads(3) should fail without parallel update support");
+    }
+#endif
+
+    {
+        lightgraph::EngineConfig seeded_config;
+        seeded_config.object_type = lightgraph::ObjectType::Cross;
+        seeded_config.random_seed = 42;
+        seeded_config.record_replay = true;
+        lightgraph::Engine first(seeded_config);
+        seeded_config.record_replay = false;
+        lightgraph::Engine second(seeded_config);
+        std::srand(1);
+        const std::vector<uint8_t> first_frames = runRandomShow(first);
+        std::srand(2);
+        if (runRandomShow(second) != first_frames) {
+            return fail("Engines with the same seed and calls should render identical frames");
+        }
+
+        seeded_config.random_seed = 43;
+        lightgraph::Engine reseeded(seeded_config);
+        if (runRandomShow(reseeded) == first_frames) {
+            return fail("A different seed should change the rendered show");
+        }
+
+        const lightgraph::ReplayLog log = first.replayLog();
+        if (log.seed != 42 || log.events.size() != 126) {
+            return fail("replayLog() should hold the seed and every emit and tick");
+        }
+        if (second.replayLog().events.size() != 0) {
+            return fail("Engines without record_replay should not record calls");
+        }
+        if (first.replay(log).ok()) {
+            return fail("replay() should refuse an engine that already ran");
+        }
+
+        seeded_config.random_seed = 7;
+        seeded_config.update_threads = LIGHTGRAPH_PARALLEL_UPDATE ? 2 : 1;
+        lightgraph::Engine replayed(seeded_config);
+        replayed.seedRandom(99);
+        if (!replayed.replay(log).ok()) {
+            return fail("replay() should run on a fresh engine");
+        }
+        std::vector<uint8_t> replayed_frame(static_cast<size_t>(replayed.pixelCount()) * 3u);
+        replayed.readFrame(replayed_frame.data(), replayed_frame.size());
+        if (!std::equal(replayed_frame.begin(), replayed_frame.end(),
+                        first_frames.end() - static_cast<std::ptrdiff_t>(replayed_frame.size()))) {
+            return fail("replay() should reproduce the recorded show");
+        }
+    }
+
+    {
+        // emitBatch() must give the same results and frames as one emit() per command.
+        lightgraph::EngineConfig batch_config;
+        batch_config.object_type = lightgraph::ObjectType::Cross;
+        batch_config.random_seed = 5;
+        lightgraph::Engine single(batch_config);
+        lightgraph::Engine batched(batch_config);
+
+        std::vector<lightgraph::EmitCommand> burst;
+        for (uint16_t i = 0; i < 32; ++i) {
+            lightgraph::EmitCommand command;
+            command.model = static_cast<int8_t>(i % 2);
+            command.length = static_cast<uint16_t>(4 + i % 5);
+            // Every third command reuses note 7, so it replaces a list instead of taking a slot.
+            command.note_id = static_cast<uint16_t>(i % 3 == 0 ? 7 : i + 10);
+            if (i % 4 == 1) {
+                command.color = 0x102030u * i;
+            }
+            burst.push_back(command);
+        }
+        burst[4].model = 99;
+        burst[5].min_brightness = 200;
+        burst[5].max_brightness = 100;
+
+        bool saw_slot_exhaustion = false;
+        std::vector<lightgraph::Result<int8_t>> batch_results;
+        std::vector<uint8_t> single_frame(static_cast<size_t>(single.pixelCount()) * 3u);
+        std::vector<uint8_t> batched_frame(single_frame.size());
+        for (int round = 0; round < 3; ++round) {
+            const auto emitted = batched.emitBatch(burst.data(), burst.size(), batch_results);
+            if (!emitted.ok() || batch_results.size() != burst.size()) {
+                return fail("emitBatch() should return one result per command");
+            }
+            size_t single_emitted = 0;
+            for (size_t i = 0; i < burst.size(); ++i) {
+                const lightgraph::Result<int8_t> expected = single.emit(burst[i]);
+                if (expected.ok() != batch_results[i].ok() ||
+                    expected.status().code() != batch_results[i].status().code() ||
+                    (expected.ok() && expected.value() != batch_results[i].value())) {
+                    return fail("emitBatch() results should match emit() called per command");
+                }
+                if (expected.ok()) {
+                    ++single_emitted;
+                }
+                if (expected.status().code() == lightgraph::ErrorCode::NoFreeLightList) {
+                    saw_slot_exhaustion = true;
+                }
+            }
+            if (emitted.value() != single_emitted) {
+                return fail("emitBatch() should count the commands that emitted");
+            }
+            for (int step = 0; step < 10; ++step) {
+                single.tick(16);
+                batched.tick(16);
+            }
+            single.readFrame(single_frame.data(), single_frame.size());
+            batched.readFrame(batched_frame.data(), batched_frame.size());
+            if (single_frame != batched_frame) {
+                return fail("emitBatch() should render the same frames as per-command emit()");
+            }
+        }
+        if (!saw_slot_exhaustion) {
+            return fail("emitBatch() parity check should run the list table out of slots");
+        }
+
+        const auto null_batch = batched.emitBatch(nullptr, 2, batch_results);
+        if (null_batch.ok() || null_batch.status().code() != lightgraph::ErrorCode::InvalidArgument ||
+            !batch_results.empty()) {
+            return fail("emitBatch() should reject a null command buffer");
+        }
+        const auto empty_batch = batched.emitBatch(nullptr, 0, batch_results);
+        if (!empty_batch.ok() || empty_batch.value() != 0) {
+            return fail("emitBatch() with no commands should succeed");
+        }
+    }
+
+    {
+        // Engines share no mutable statics, so concurrent builds and runs must
+        // match a serial run of the same seeded show.
+        lightgraph::EngineConfig stress_config;
+        stress_config.object_type = lightgraph::ObjectType::Cross;
+        stress_config.random_seed = 42;
+        std::vector<uint8_t> reference;
+        {
+            lightgraph::Engine serial(stress_config);
+            reference = runRandomShow(serial);
+        }
+
+        constexpr size_t kStressEngines = 6;
+        std::vector<std::vector<uint8_t>> results(kStressEngines);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < kStressEngines; ++i) {
+            workers.emplace_back([&stress_config, &results, i]() {
+                lightgraph::Engine concurrent(stress_config);
+                results[i] = runRandomShow(concurrent);
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        for (const std::vector<uint8_t>& result : results) {
+            if (result != reference) {
+                return fail("Engines run on separate threads should match a serial run");
+            }
+        }
+    }
+
     const auto out_of_range = engine.pixel(engine.pixelCount());
     if (out_of_range.ok() || out_of_range.status().code() != lightgraph::ErrorCode::OutOfRange) {
         return fail("Out-of-range pixel access did not return ErrorCode::OutOfRange");